@@ -0,0 +1,207 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/binary_constraints.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/cnf_encoder.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+namespace {
+
+// Returns the number of distinct squares of the cells.
+int count_squares(const BinaryCell* const cells, int number_of_cells) {
+  int count = 0;
+  for (int i = 0; i < number_of_cells; i++) {
+    bool seen = false;
+    for (int j = 0; j < i; j++) {
+      if (cells[j].square == cells[i].square) {
+        seen = true;
+        break;
+      }
+    }
+    if (!seen) {
+      count++;
+    }
+  }
+  return count;
+}
+
+}  // namespace
+
+BinaryCellConstraint::BinaryCellConstraint(const BinaryCell* const cells,
+                                           int number_of_cells) :
+    Constraint(count_squares(cells, number_of_cells)),
+    cells(cells, cells + number_of_cells),
+    cells_at_scope_position(get_scope_size()) {
+  std::vector<int> squares;
+  for (int i = 0; i < number_of_cells; i++) {
+    size_t position = 0;
+    while (position < squares.size() && squares[position] != cells[i].square) {
+      position++;
+    }
+    if (position == squares.size()) {
+      set_scope(position, cells[i].square);
+      squares.push_back(cells[i].square);
+    }
+    cells_at_scope_position[position].push_back(i);
+  }
+}
+
+BinaryCellConstraint::~BinaryCellConstraint() {
+}
+
+Domain BinaryCellConstraint::get_domain(const Board* const board,
+                                        int cell) const {
+  return board->get_domain(cells[cell].square);
+}
+
+bool BinaryCellConstraint::force_filled(Board* const board, int cell) const {
+  return board->restrict_domain(cells[cell].square, cells[cell].filled);
+}
+
+bool BinaryCellConstraint::force_unfilled(Board* const board,
+                                          int cell) const {
+  return board->restrict_domain(cells[cell].square, ~cells[cell].filled);
+}
+
+int BinaryCellConstraint::get_cell_literal(int cell,
+                                           CnfEncoder* const encoder) const {
+  return encoder->get_states_literal(cells[cell].square, cells[cell].filled);
+}
+
+void BinaryCellConstraint::update_cell_masks(int scope_position,
+                                             Domain old_domain,
+                                             Domain new_domain,
+                                             int* const masks) const {
+  const std::vector<int>& cells = get_cells_at(scope_position);
+  for (size_t i = 0; i < cells.size(); i++) {
+    unsigned int bit = 1u << cells[i];
+    if (is_filled(cells[i], old_domain)) {
+      masks[0] &= ~bit;
+    }
+    if (is_unfilled(cells[i], old_domain)) {
+      masks[1] &= ~bit;
+    }
+    if (is_filled(cells[i], new_domain)) {
+      masks[0] |= bit;
+    }
+    if (is_unfilled(cells[i], new_domain)) {
+      masks[1] |= bit;
+    }
+  }
+}
+
+ThermometerConstraint::ThermometerConstraint(const BinaryCell* const cells,
+                                             int number_of_cells) :
+    BinaryCellConstraint(cells, number_of_cells) {
+  assert(number_of_cells <= 32);
+}
+
+ThermometerConstraint::~ThermometerConstraint() {
+}
+
+bool ThermometerConstraint::propagate(Board* const board,
+                                      const int* const counters) const {
+  unsigned int filled = counters[0];
+  unsigned int unfilled = counters[1];
+
+  // Everything below the highest filled cell is filled.
+  if (filled != 0) {
+    int highest_filled = 31 - __builtin_clz(filled);
+    for (int i = 0; i < highest_filled; i++) {
+      if (!(filled & (1u << i)) && !force_filled(board, i)) {
+        return false;
+      }
+    }
+  }
+
+  // Everything above the lowest unfilled cell is unfilled.
+  if (unfilled != 0) {
+    int lowest_unfilled = __builtin_ctz(unfilled);
+    for (int i = lowest_unfilled + 1; i < get_number_of_cells(); i++) {
+      if (!(unfilled & (1u << i)) && !force_unfilled(board, i)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void ThermometerConstraint::update_counters(int scope_position,
+                                            Domain old_domain,
+                                            Domain new_domain,
+                                            int* const counters) const {
+  update_cell_masks(scope_position, old_domain, new_domain, counters);
+}
+
+int ThermometerConstraint::count_violations(
+    const int* const state_indices) const {
+  int violations = 0;
+  bool seen_unfilled = false;
+  for (int i = 0; i < get_number_of_cells(); i++) {
+    if (!is_filled_in(i, state_indices)) {
+      seen_unfilled = true;
+    } else if (seen_unfilled) {
+      violations++;
+    }
+  }
+  return violations;
+}
+
+bool ThermometerConstraint::add_clauses(CnfEncoder* const encoder) const {
+  for (int i = 0; i + 1 < get_number_of_cells(); i++) {
+    encoder->get_formula()->add_binary(-get_cell_literal(i + 1, encoder),
+                                       get_cell_literal(i, encoder));
+  }
+  return true;
+}
+
+FrontierState ThermometerConstraint::get_initial_frontier_state() const {
+  return get_number_of_cells();
+}
+
+FrontierState ThermometerConstraint::get_next_frontier_state(
+    FrontierState frontier_state, int scope_position, int state_index) const {
+  int above_highest_filled = frontier_state / 64;
+  int lowest_unfilled = frontier_state % 64;
+  const std::vector<int>& cells = get_cells_at(scope_position);
+  for (size_t i = 0; i < cells.size(); i++) {
+    if (is_filled_by(cells[i], state_index)) {
+      above_highest_filled = std::max(above_highest_filled, cells[i] + 1);
+    } else {
+      lowest_unfilled = std::min(lowest_unfilled, cells[i]);
+    }
+  }
+  if (above_highest_filled > lowest_unfilled) {
+    return REJECTED_FRONTIER_STATE;
+  }
+  return above_highest_filled * 64 + lowest_unfilled;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
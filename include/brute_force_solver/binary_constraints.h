@@ -0,0 +1,162 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Constraints over two-valued cells, such as the filled and unfilled squares
+// of Thermometers.
+//
+// A cell is read off one square of the Board: it is filled when the square
+// holds one of a given set of states. On a plain board each square is one
+// cell. On a glyph board a square holds several cells, one per pixel, and a
+// pixel is filled for the glyphs that have it set.
+//
+// These constraints keep incremental counters on the Board, so propagation
+// does not rescan the cells to find out how many are filled.
+// -----------------------------------------------------------------------------
+
+#ifndef _BINARY_CONSTRAINTS_H_
+#define _BINARY_CONSTRAINTS_H_
+
+#include <vector>
+
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+class CnfEncoder;
+
+struct BinaryCell {
+  int square;
+
+  // The states of |square| for which the cell is filled.
+  Domain filled;
+};
+
+// A constraint over an ordered list of cells. The scope is the set of
+// distinct squares of the cells.
+class BinaryCellConstraint : public Constraint {
+ public:
+  virtual ~BinaryCellConstraint();
+
+ protected:
+  // The |cells| array is copied.
+  BinaryCellConstraint(const BinaryCell* const cells, int number_of_cells);
+
+  int get_number_of_cells() const {
+    return cells.size();
+  }
+
+  // The indices of the cells on the square at |scope_position|.
+  const std::vector<int>& get_cells_at(int scope_position) const {
+    return cells_at_scope_position[scope_position];
+  }
+
+  bool is_filled(int cell, Domain domain) const {
+    return (domain != 0) && !(domain & ~cells[cell].filled);
+  }
+
+  bool is_unfilled(int cell, Domain domain) const {
+    return (domain != 0) && !(domain & cells[cell].filled);
+  }
+
+  bool is_filled_by(int cell, int state_index) const {
+    return domain_contains(cells[cell].filled, state_index);
+  }
+
+  bool can_be_filled(int cell, Domain domain) const {
+    return (domain & cells[cell].filled) != 0;
+  }
+
+  Domain get_domain(const Board* const board, int cell) const;
+
+  // Returns true if the cell is filled when the squares have the states with
+  // the indices |state_indices|.
+  bool is_filled_in(int cell, const int* const state_indices) const {
+    return is_filled_by(cell, state_indices[cells[cell].square]);
+  }
+
+  // Returns a literal that is true when the cell is filled.
+  int get_cell_literal(int cell, CnfEncoder* const encoder) const;
+
+  // Restricts the square of the cell so the cell is filled (or unfilled).
+  // Returns false if it cannot be.
+  bool force_filled(Board* const board, int cell) const;
+  bool force_unfilled(Board* const board, int cell) const;
+
+  // Keeps |masks|[0] and |masks|[1] as the bitmasks of the cells known to be
+  // filled and unfilled, for constraints with at most 32 cells.
+  void update_cell_masks(int scope_position,
+                         Domain old_domain,
+                         Domain new_domain,
+                         int* const masks) const;
+
+ private:
+  std::vector<BinaryCell> cells;
+  std::vector<std::vector<int> > cells_at_scope_position;
+};
+
+// A thermometer: the cells are listed from the bulb to the tip, and are
+// filled from the bulb up. A filled cell forces every cell toward the bulb to
+// be filled, and an unfilled cell forces every cell toward the tip to be
+// unfilled.
+//
+// Thermometers have at most 32 cells.
+class ThermometerConstraint : public BinaryCellConstraint {
+ public:
+  ThermometerConstraint(const BinaryCell* const cells, int number_of_cells);
+  virtual ~ThermometerConstraint();
+
+  virtual bool propagate(Board* const board, const int* const counters) const;
+
+  // The bitmasks of the cells that are known to be filled, and unfilled.
+  virtual int get_number_of_counters() const {
+    return 2;
+  }
+
+  virtual void update_counters(int scope_position,
+                               Domain old_domain,
+                               Domain new_domain,
+                               int* const counters) const;
+
+  // The number of filled cells above the lowest unfilled cell.
+  virtual int count_violations(const int* const state_indices) const;
+
+  // Each filled cell implies the cell below it is filled.
+  virtual bool add_clauses(CnfEncoder* const encoder) const;
+
+  // The frontier state is 64 times one past the highest filled cell seen,
+  // plus the lowest unfilled cell seen (or the number of cells).
+  virtual bool has_frontier_states() const {
+    return true;
+  }
+
+  virtual FrontierState get_initial_frontier_state() const;
+  virtual FrontierState get_next_frontier_state(FrontierState frontier_state,
+                                                int scope_position,
+                                                int state_index) const;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _BINARY_CONSTRAINTS_H_
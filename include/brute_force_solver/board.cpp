@@ -20,16 +20,56 @@
 
 #include "include/brute_force_solver/board.h"
 
+#include <limits.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/progress_listener.h"
+#include "include/brute_force_solver/search_trace.h"
+#include "include/brute_force_solver/solution_sink.h"
+#include "include/brute_force_solver/solution_writer.h"
 #include "include/brute_force_solver/state.h"
 #include "include/brute_force_solver/state_list.h"
 
 namespace lib_kxing {
 namespace brute_force_solver {
 
+namespace {
+
+unsigned long long saturating_add(unsigned long long a, unsigned long long b) {
+  return (a + b < a) ? ~0ull : a + b;
+}
+
+unsigned long long saturating_multiply(unsigned long long a,
+                                       unsigned long long b) {
+  return (b != 0 && a > ~0ull / b) ? ~0ull : a * b;
+}
+
+double seconds_since(const timespec& start) {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start.tv_sec) + 1e-9 * (now.tv_nsec - start.tv_nsec);
+}
+
+int find_root(std::vector<int>* parents, int square) {
+  while ((*parents)[square] != square) {
+    (*parents)[square] = (*parents)[(*parents)[square]];
+    square = (*parents)[square];
+  }
+  return square;
+}
+
+}  // namespace
+
 Board::Board(const int number_of_squares,
              const StateList* state_list,
              const int* const search_order,
@@ -38,7 +78,23 @@ Board::Board(const int number_of_squares,
     state_list(state_list),
     search_order(search_order),
     squares(new Square[number_of_squares]),
-    validator(validator) {
+    state_indices(new int[number_of_squares]),
+    domains(new Domain[number_of_squares]),
+    validator(validator),
+    use_components(false),
+    lookahead_depth(0),
+    lookahead_trials(0),
+    progress_listener(NULL),
+    progress_interval(0),
+    number_of_nodes(0),
+    node_limit(~0ull),
+    stop_flag(NULL),
+    value_order(NULL),
+    next_report(0),
+    search_trace(NULL),
+    trace_ring(NULL),
+    constraints_of_square(number_of_squares) {
+  assert(state_list->get_number_of_states() <= MAX_NUMBER_OF_STATES);
 
   #ifndef NDEBUG
   // Check that the search order is valid.
@@ -57,17 +113,97 @@ Board::Board(const int number_of_squares,
   // Initialize the square to |EMPTY|.
   for (int i = 0; i < number_of_squares; i++) {
     squares[i] = EMPTY;
+    state_indices[i] = -1;
+    domains[i] = full_domain(state_list->get_number_of_states());
   }
 }
 
 Board::~Board() {
   delete[] squares;
+  delete[] state_indices;
+  delete[] domains;
+}
+
+bool Board::restrict_domain(int index, Domain allowed) {
+  assert(is_valid_index(index));
+
+  Domain domain = domains[index] & allowed;
+  if (domain == domains[index]) {
+    return (domain != 0);
+  }
+
+  TrailEntry entry = {index, state_indices[index], domains[index]};
+  trail.push_back(entry);
+  change_domain(index, domain);
+
+  if (domain == 0) {
+    return false;
+  }
+  if (state_indices[index] == -1) {
+    if (domain_size(domain) == 1) {
+      set_state_index(index, lowest_state(domain));
+    }
+  } else if (!domain_contains(domain, state_indices[index])) {
+    return false;
+  }
+
+  queue_constraints_of(index);
+  return true;
+}
+
+void Board::add_constraint(const Constraint* const constraint) {
+  int constraint_index = constraints.size();
+  constraints.push_back(constraint);
+  is_queued.push_back(false);
+
+  int offset = counters.size();
+  counter_offsets.push_back(offset);
+  counters.resize(offset + constraint->get_number_of_counters(), 0);
+
+  for (int i = 0; i < constraint->get_scope_size(); i++) {
+    int square = constraint->get_scope(i);
+    assert(is_valid_index(square));
+    Watch watch = {constraint_index, i};
+    constraints_of_square[square].push_back(watch);
+    if (constraint->get_number_of_counters() > 0) {
+      constraint->update_counters(i, 0, domains[square], &counters[offset]);
+    }
+  }
+
+  // Propagate it once before the search.
+  is_queued[constraint_index] = true;
+  propagation_queue.push_back(constraint_index);
+}
+
+bool Board::propagate() {
+  while (!propagation_queue.empty()) {
+    int constraint_index = propagation_queue.back();
+    propagation_queue.pop_back();
+    is_queued[constraint_index] = false;
+
+    const int* constraint_counters =
+        counters.data() + counter_offsets[constraint_index];
+    if (!constraints[constraint_index]->propagate(this,
+                                                  constraint_counters)) {
+      // Drop the rest of the queue; the search will undo this node.
+      for (size_t i = 0; i < propagation_queue.size(); i++) {
+        is_queued[propagation_queue[i]] = false;
+      }
+      propagation_queue.clear();
+      return false;
+    }
+  }
+  return true;
 }
 
 Board* Board::find_solution() const {
   // Make a copy, and operate on it.
   Board* board = copy();
-  bool success = board->find_solution_internal(0);
+  board->start_search();
+  std::vector<int> squares(search_order, search_order + number_of_squares);
+  bool success =
+      board->propagate() && board->find_solution_internal(squares, 0);
+  board->finish_search();
   if (success) {
     return board;
   } else {
@@ -76,63 +212,541 @@ Board* Board::find_solution() const {
   }
 }
 
-void Board::pretty_print(int items_per_line) const {
-  // The number of items printed on the current line.
-  int line_counter = 0;
+unsigned long long Board::count_solutions() const {
+  Board* board = copy();
+  board->start_search();
+  std::vector<int> squares(search_order, search_order + number_of_squares);
+  unsigned long long count = 0;
+  if (board->propagate()) {
+    count = board->count_solutions_internal(squares, 0);
+  }
+  board->finish_search();
+  delete board;
+  return count;
+}
+
+void Board::find_all_solutions(const int* const squares_to_fill,
+                               int number_of_squares_to_fill,
+                               SolutionSink* const sink) const {
+  // Keep the squares in search order.
+  std::vector<bool> is_to_fill(number_of_squares, false);
+  for (int i = 0; i < number_of_squares_to_fill; i++) {
+    is_to_fill[squares_to_fill[i]] = true;
+  }
+  std::vector<int> squares;
   for (int i = 0; i < number_of_squares; i++) {
-    if (line_counter == 0) {
-      printf("%s", squares[i]->get_pretty_print_string());
-    } else {
-      printf(" %s", squares[i]->get_pretty_print_string());
+    if (is_to_fill[search_order[i]]) {
+      squares.push_back(search_order[i]);
+    }
+  }
+
+  Board* board = copy();
+  board->start_search();
+  if (board->propagate()) {
+    board->find_all_solutions_internal(squares, 0, sink);
+  }
+  board->finish_search();
+  delete board;
+}
+
+unsigned long long Board::probe_search(const int* const search_order,
+                                       unsigned long long limit,
+                                       bool* const finished,
+                                       Board** const solution) const {
+  Board* board = copy(search_order);
+  board->progress_listener = NULL;
+  board->search_trace = NULL;
+  board->node_limit = limit;
+  board->start_search();
+  std::vector<int> squares(search_order, search_order + number_of_squares);
+  bool success =
+      board->propagate() && board->find_solution_internal(squares, 0);
+  board->finish_search();
+  // A search told to stop did not finish, however few nodes it tried.
+  *finished = (board->number_of_nodes <= limit) &&
+              (stop_flag == NULL || !stop_flag->load());
+  unsigned long long number_of_nodes = std::min(board->number_of_nodes, limit);
+  if (solution != NULL && success) {
+    *solution = board;
+  } else {
+    if (solution != NULL) {
+      *solution = NULL;
     }
-    line_counter++;
+    delete board;
+  }
+  return number_of_nodes;
+}
+
+double Board::estimate_search_tree_size(int number_of_probes,
+                                       unsigned int seed) const {
+  std::mt19937 random(seed);
+  Board* board = copy();
+  board->progress_listener = NULL;
+  // Every probe starts from the propagated root, as the search does.
+  if (!board->propagate()) {
+    delete board;
+    return 0;
+  }
+  size_t trail_size = board->trail.size();
+  double total = 0;
+  for (int probe = 0; probe < number_of_probes; probe++) {
+    double size = 1;
+    double nodes_at_depth = 1;
+    for (int i = 0; i < number_of_squares; i++) {
+      int square = search_order[i];
+      Domain domain = board->domains[square];
+      size_t node_trail_size = board->trail.size();
+      std::vector<int> children;
+      for (int j = 0; j < state_list->get_number_of_states(); j++) {
+        if (!domain_contains(domain, j)) {
+          continue;
+        }
+        board->assign(square, j);
+        if (board->is_consistent(i)) {
+          children.push_back(j);
+        }
+        board->undo(node_trail_size);
+      }
+      if (children.empty()) {
+        break;
+      }
 
-    // Start a new line if we've hit our quota.
-    if (line_counter == items_per_line) {
-      printf("\n");
-      line_counter = 0;
+      nodes_at_depth *= children.size();
+      size += nodes_at_depth;
+      int child = children[random() % children.size()];
+      board->assign(square, child);
+      board->is_consistent(i);
     }
+    board->undo(trail_size);
+    total += size;
   }
+  delete board;
+  return (number_of_probes > 0) ? total / number_of_probes : 0;
+}
 
-  // Adjustment for the case when everything is on one line.
-  if (items_per_line == 0) {
-    printf("\n");
+bool Board::apply_lookahead(int max_passes,
+                            long long max_trials,
+                            int number_of_threads) {
+  if (!propagate()) {
+    return false;
   }
+
+  std::atomic<long long> trials_left((max_trials < 0) ? LLONG_MAX : max_trials);
+  for (int pass = 0; max_passes < 0 || pass < max_passes; pass++) {
+    std::vector<int> open_squares;
+    for (int i = 0; i < number_of_squares; i++) {
+      if (state_indices[i] == -1 && domain_size(domains[i]) > 1) {
+        open_squares.push_back(i);
+      }
+    }
+    if (open_squares.empty() || trials_left <= 0) {
+      return true;
+    }
+
+    std::vector<Domain> failed(number_of_squares, 0);
+    std::atomic<size_t> next(0);
+    if (number_of_threads <= 1) {
+      run_lookahead_trials(open_squares, &next, &trials_left, &failed);
+    } else {
+      // Each thread tries its states on its own copy of the board.
+      std::vector<std::thread> threads;
+      for (int i = 0; i < number_of_threads; i++) {
+        threads.push_back(std::thread(
+            [this, &open_squares, &next, &trials_left, &failed]() {
+          Board* board = copy();
+          if (board->propagate()) {
+            board->run_lookahead_trials(open_squares,
+                                        &next,
+                                        &trials_left,
+                                        &failed);
+          }
+          delete board;
+        }));
+      }
+      for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+      }
+    }
+
+    bool has_changed = false;
+    for (size_t i = 0; i < open_squares.size(); i++) {
+      int square = open_squares[i];
+      if (failed[square] != 0) {
+        has_changed = true;
+        if (!restrict_domain(square, ~failed[square])) {
+          return false;
+        }
+      }
+    }
+    if (!has_changed) {
+      return true;
+    }
+    if (!propagate() || (validator != NULL && !validator(this))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Board::pretty_print(int items_per_line) const {
+  SolutionWriter writer(stdout, SOLUTION_FORMAT_TEXT, items_per_line);
+  writer.write(this);
 }
 
-Board* Board::copy() const {
+Board* Board::copy(const int* const search_order) const {
   Board* board = new Board(number_of_squares,
                            state_list,
                            search_order,
                            validator);
   for (int i = 0; i < number_of_squares; i++) {
-    board->set_value(i, get_value(i));
+    board->set_state_index(i, get_state_index(i));
+    board->domains[i] = domains[i];
+  }
+  board->use_components = use_components;
+  board->lookahead_depth = lookahead_depth;
+  board->lookahead_trials = lookahead_trials;
+  board->progress_listener = progress_listener;
+  board->progress_interval = progress_interval;
+  board->node_limit = node_limit;
+  board->stop_flag = stop_flag;
+  board->value_order = value_order;
+  board->search_trace = search_trace;
+  for (size_t i = 0; i < constraints.size(); i++) {
+    board->add_constraint(constraints[i]);
   }
   return board;
 }
 
-bool Board::find_solution_internal(int index) {
-  if (index == number_of_squares) {
+void Board::start_search() {
+  progress_path.clear();
+  number_of_nodes = 0;
+  clock_gettime(CLOCK_MONOTONIC, &search_start);
+  next_report = progress_interval;
+  if (search_trace != NULL) {
+    trace_ring = search_trace->open_ring();
+  }
+}
+
+void Board::finish_search() {
+  if (trace_ring != NULL) {
+    search_trace->close_ring(trace_ring);
+    trace_ring = NULL;
+  }
+}
+
+void Board::record_trace_event(int type,
+                               int square,
+                               int state_index,
+                               size_t depth) {
+  trace_ring->add(type, square, state_index, (depth < 0xffff) ? depth : 0xffff);
+}
+
+void Board::report_progress() {
+  if (progress_listener == NULL) {
+    return;
+  }
+  double elapsed = seconds_since(search_start);
+  if (elapsed < next_report) {
+    return;
+  }
+  next_report = elapsed + progress_interval;
+
+  // Every child of a node holds an equal share of the node's share of the
+  // tree, and the children before the current one are done.
+  double fraction_done = 0;
+  double share = 1;
+  for (size_t i = 0; i < progress_path.size(); i++) {
+    share /= progress_path[i].number_of_children;
+    fraction_done += share * progress_path[i].child;
+  }
+
+  SearchProgress progress;
+  progress.number_of_nodes = number_of_nodes;
+  progress.elapsed_seconds = elapsed;
+  progress.fraction_done = fraction_done;
+  progress.nodes_per_second = (elapsed > 0) ? number_of_nodes / elapsed : 0;
+  progress.seconds_left =
+      (fraction_done > 0) ? elapsed * (1 - fraction_done) / fraction_done : -1;
+  progress_listener->report(progress);
+}
+
+bool Board::is_consistent(size_t depth) {
+  if (!propagate() || (validator != NULL && !validator(this))) {
+    return false;
+  }
+  if (depth < static_cast<size_t>(lookahead_depth)) {
+    return apply_lookahead(-1, lookahead_trials, 1);
+  }
+  return true;
+}
+
+void Board::run_lookahead_trials(const std::vector<int>& squares,
+                                 std::atomic<size_t>* next,
+                                 std::atomic<long long>* trials_left,
+                                 std::vector<Domain>* failed) {
+  for (size_t i = (*next)++; i < squares.size(); i = (*next)++) {
+    int square = squares[i];
+    Domain domain = domains[square];
+    size_t trail_size = trail.size();
+    for (int j = 0; j < state_list->get_number_of_states(); j++) {
+      if (!domain_contains(domain, j)) {
+        continue;
+      }
+      if ((*trials_left)-- <= 0) {
+        return;
+      }
+      assign(square, j);
+      if (!propagate() || (validator != NULL && !validator(this))) {
+        (*failed)[square] |= single_state_domain(j);
+      }
+      undo(trail_size);
+    }
+  }
+}
+
+bool Board::find_solution_internal(const std::vector<int>& squares,
+                                   size_t index) {
+  if (index == squares.size()) {
     // We've filled all the squares of the board without any problems.
+    trace(TRACE_SOLUTION, -1, 0, index);
     return true;
   }
 
-  for (int i = 0; i < state_list->get_number_of_states(); i++) {
-    set_value(search_order[index], state_list->get_state(i));
+  std::vector<std::vector<int> > components;
+  if (use_components && split_into_components(squares, index, &components)) {
+    // Nothing one group does can undo a solution of another, so the groups
+    // can be solved one after the other.
+    size_t level = progress_path.size();
+    for (size_t i = 0; i < components.size(); i++) {
+      track_progress(level, i, components.size());
+      if (!find_solution_internal(components[i], 0)) {
+        return false;
+      }
+    }
+    return true;
+  }
 
-    if (!validator(this)) {
+  int square = squares[index];
+  Domain domain = domains[square];
+  size_t trail_size = trail.size();
+  size_t level = progress_path.size();
+  int child = 0;
+  for (int j = 0; j < state_list->get_number_of_states(); j++) {
+    int i = get_state_to_try(j);
+    if (!domain_contains(domain, i)) {
+      continue;
+    }
+    if (!count_node()) {
+      return false;
+    }
+    track_progress(level, child++, domain_size(domain));
+    assign(square, i);
+    trace(TRACE_ASSIGN, square, i, index);
+
+    if (!is_consistent(index)) {
       // Stop if the current state is impossible.
+      trace(TRACE_REJECT, square, i, index);
+      undo(trail_size);
       continue;
     }
 
-    bool success = find_solution_internal(index + 1);
+    bool success = find_solution_internal(squares, index + 1);
     if (success) {
       return true;
     }
+    trace(TRACE_BACKTRACK, square, i, index);
+    undo(trail_size);
   }
-  set_value(search_order[index], EMPTY);
   return false;
 }
 
+unsigned long long Board::count_solutions_internal(
+    const std::vector<int>& squares, size_t index) {
+  if (index == squares.size()) {
+    trace(TRACE_SOLUTION, -1, 0, index);
+    return 1;
+  }
+
+  std::vector<std::vector<int> > components;
+  if (use_components && split_into_components(squares, index, &components)) {
+    unsigned long long count = 1;
+    size_t level = progress_path.size();
+    for (size_t i = 0; i < components.size() && count != 0; i++) {
+      track_progress(level, i, components.size());
+      count = saturating_multiply(count,
+                                  count_solutions_internal(components[i], 0));
+    }
+    return count;
+  }
+
+  int square = squares[index];
+  Domain domain = domains[square];
+  size_t trail_size = trail.size();
+  size_t level = progress_path.size();
+  int child = 0;
+  unsigned long long count = 0;
+  for (int j = 0; j < state_list->get_number_of_states(); j++) {
+    int i = get_state_to_try(j);
+    if (!domain_contains(domain, i)) {
+      continue;
+    }
+    if (!count_node()) {
+      break;
+    }
+    track_progress(level, child++, domain_size(domain));
+    assign(square, i);
+    trace(TRACE_ASSIGN, square, i, index);
+    if (is_consistent(index)) {
+      count = saturating_add(count, count_solutions_internal(squares,
+                                                             index + 1));
+      trace(TRACE_BACKTRACK, square, i, index);
+    } else {
+      trace(TRACE_REJECT, square, i, index);
+    }
+    undo(trail_size);
+  }
+  return count;
+}
+
+bool Board::find_all_solutions_internal(const std::vector<int>& squares,
+                                        size_t index,
+                                        SolutionSink* const sink) {
+  if (index == squares.size()) {
+    trace(TRACE_SOLUTION, -1, 0, index);
+    return sink->add_solution(this);
+  }
+
+  int square = squares[index];
+  Domain domain = domains[square];
+  size_t trail_size = trail.size();
+  size_t level = progress_path.size();
+  int child = 0;
+  bool keep_going = true;
+  for (int j = 0; j < state_list->get_number_of_states() && keep_going; j++) {
+    int i = get_state_to_try(j);
+    if (!domain_contains(domain, i)) {
+      continue;
+    }
+    if (!count_node()) {
+      return false;
+    }
+    track_progress(level, child++, domain_size(domain));
+    assign(square, i);
+    trace(TRACE_ASSIGN, square, i, index);
+    if (is_consistent(index)) {
+      keep_going = find_all_solutions_internal(squares, index + 1, sink);
+      trace(TRACE_BACKTRACK, square, i, index);
+    } else {
+      trace(TRACE_REJECT, square, i, index);
+    }
+    undo(trail_size);
+  }
+  return keep_going;
+}
+
+bool Board::split_into_components(
+    const std::vector<int>& squares,
+    size_t index,
+    std::vector<std::vector<int> >* components) const {
+  std::vector<bool> is_open(number_of_squares, false);
+  int number_of_open_squares = 0;
+  for (size_t i = index; i < squares.size(); i++) {
+    if (is_empty(squares[i])) {
+      is_open[squares[i]] = true;
+      number_of_open_squares++;
+    }
+  }
+  if (number_of_open_squares < 2) {
+    return false;
+  }
+
+  // Join the open squares of each constraint.
+  std::vector<int> parents(number_of_squares);
+  for (int i = 0; i < number_of_squares; i++) {
+    parents[i] = i;
+  }
+  int number_of_components = number_of_open_squares;
+  for (size_t i = 0; i < constraints.size(); i++) {
+    int first_open = -1;
+    for (int j = 0; j < constraints[i]->get_scope_size(); j++) {
+      int square = constraints[i]->get_scope(j);
+      if (!is_open[square]) {
+        continue;
+      }
+      if (first_open == -1) {
+        first_open = find_root(&parents, square);
+        continue;
+      }
+      int root = find_root(&parents, square);
+      if (root != first_open) {
+        parents[root] = first_open;
+        number_of_components--;
+      }
+    }
+    if (number_of_components == 1) {
+      return false;
+    }
+  }
+
+  std::vector<int> component_of_root(number_of_squares, -1);
+  components->clear();
+  for (size_t i = index; i < squares.size(); i++) {
+    int square = squares[i];
+    if (!is_open[square]) {
+      continue;
+    }
+    int root = find_root(&parents, square);
+    if (component_of_root[root] == -1) {
+      component_of_root[root] = components->size();
+      components->push_back(std::vector<int>());
+    }
+    (*components)[component_of_root[root]].push_back(square);
+  }
+  return true;
+}
+
+void Board::assign(int index, int state_index) {
+  TrailEntry entry = {index, state_indices[index], domains[index]};
+  trail.push_back(entry);
+  set_state_index(index, state_index);
+  change_domain(index, single_state_domain(state_index));
+  queue_constraints_of(index);
+}
+
+void Board::undo(size_t trail_size) {
+  while (trail.size() > trail_size) {
+    const TrailEntry& entry = trail.back();
+    set_state_index(entry.square, entry.state_index);
+    change_domain(entry.square, entry.domain);
+    trail.pop_back();
+  }
+}
+
+void Board::change_domain(int index, Domain domain) {
+  const std::vector<Watch>& watches = constraints_of_square[index];
+  for (size_t i = 0; i < watches.size(); i++) {
+    const Constraint* constraint = constraints[watches[i].constraint_index];
+    if (constraint->get_number_of_counters() > 0) {
+      constraint->update_counters(
+          watches[i].scope_position,
+          domains[index],
+          domain,
+          &counters[counter_offsets[watches[i].constraint_index]]);
+    }
+  }
+  domains[index] = domain;
+}
+
+void Board::queue_constraints_of(int index) {
+  const std::vector<Watch>& watches = constraints_of_square[index];
+  for (size_t i = 0; i < watches.size(); i++) {
+    int constraint_index = watches[i].constraint_index;
+    if (!is_queued[constraint_index]) {
+      is_queued[constraint_index] = true;
+      propagation_queue.push_back(constraint_index);
+    }
+  }
+}
+
 }  // namespace brute_force_solver
 }  // namespace lib_kxing
@@ -22,7 +22,13 @@
 #define _BOARD_H_
 
 #include <assert.h>
+#include <stddef.h>
+#include <time.h>
 
+#include <atomic>
+#include <vector>
+
+#include "include/brute_force_solver/domain.h"
 #include "include/brute_force_solver/state.h"
 #include "include/brute_force_solver/state_list.h"
 
@@ -30,6 +36,11 @@ namespace lib_kxing {
 namespace brute_force_solver {
 
 class Board;
+class Constraint;
+class ProgressListener;
+class SearchTrace;
+class SolutionSink;
+class TraceRing;
 
 typedef const State* Square;
 typedef bool (*BoardValidator)(const Board* const);
@@ -42,6 +53,30 @@ class Board {
         BoardValidator validator);
   ~Board();
 
+  int get_number_of_squares() const {
+    return number_of_squares;
+  }
+
+  const StateList* get_state_list() const {
+    return state_list;
+  }
+
+  const int* get_search_order() const {
+    return search_order;
+  }
+
+  BoardValidator get_validator() const {
+    return validator;
+  }
+
+  int get_number_of_constraints() const {
+    return constraints.size();
+  }
+
+  const Constraint* get_constraint(int i) const {
+    return constraints[i];
+  }
+
   Square get_value(int index) const {
     assert(is_valid_index(index));
     assert(state_list->is_valid_state(squares[index]));
@@ -54,6 +89,14 @@ class Board {
     assert(state_list->is_valid_state(value));
 
     squares[index] = value;
+    state_indices[index] = state_list->index_of(value);
+  }
+
+  // Returns the index of the value of the square in the StateList, or -1 if
+  // the square is EMPTY.
+  int get_state_index(int index) const {
+    assert(is_valid_index(index));
+    return state_indices[index];
   }
 
   bool is_empty(int index) const {
@@ -61,15 +104,140 @@ class Board {
     return (squares[index] == EMPTY);
   }
 
+  // Returns the states that the square may still take.
+  Domain get_domain(int index) const {
+    assert(is_valid_index(index));
+    return domains[index];
+  }
+
+  // Removes the states outside of |allowed| from the domain of the square.
+  // A square whose domain shrinks to a single state is assigned that state,
+  // and the constraints on a square whose domain shrinks are queued for
+  // propagation.
+  // Returns false if the domain becomes empty, or no longer contains the
+  // value of the square.
+  bool restrict_domain(int index, Domain allowed);
+
+  // Adds a constraint to be propagated during the search. The Board does not
+  // take ownership; the constraint must outlive the Board and its copies.
+  void add_constraint(const Constraint* const constraint);
+
+  // Propagates the queued constraints until no domain changes.
+  // Returns false if some constraint cannot be satisfied.
+  bool propagate();
+
   // Returns a board containing the solution, if it exists.
   // Returns NULL if there is no solution.
   // The caller is responsible for freeing the pointer, if it is non-NULL.
   Board* find_solution() const;
 
+  // Returns the number of solutions, or ~0ull if there are at least that
+  // many.
+  unsigned long long count_solutions() const;
+
+  // Passes every way to fill in the |number_of_squares_to_fill| squares of
+  // |squares_to_fill| to |sink|, in search order, until the sink stops the
+  // search. The other squares are only filled in where propagation forces
+  // them.
+  void find_all_solutions(const int* const squares_to_fill,
+                          int number_of_squares_to_fill,
+                          SolutionSink* const sink) const;
+
+  // Lets the search split the empty squares into groups that share no
+  // constraint, and solve each group on its own; solution counts then
+  // multiply across the groups. This is only correct if the validator checks
+  // nothing that spans two such groups, e.g. if it only checks rules that are
+  // also constraints.
+  void enable_components() {
+    use_components = true;
+  }
+
+  // Runs a singleton-consistency lookahead: tries each state left for each
+  // empty square, propagates, and checks the validator, and removes the
+  // states that fail at once. Passes repeat until one removes nothing, for at
+  // most |max_passes| passes and |max_trials| tries in all (-1 for no limit).
+  // The squares of a pass are split between |number_of_threads| threads,
+  // each trying states on its own copy of the board.
+  // Returns false if some square has no state left, i.e. there is no
+  // solution.
+  bool apply_lookahead(int max_passes,
+                       long long max_trials,
+                       int number_of_threads);
+
+  // Lets the search run the lookahead on one thread, with at most
+  // |max_trials| tries, at each node of the first |max_depth| levels.
+  void enable_lookahead(int max_depth, long long max_trials) {
+    lookahead_depth = max_depth;
+    lookahead_trials = max_trials;
+  }
+
+  // Estimates the number of nodes of the search tree of find_solution() and
+  // count_solutions() with Knuth's estimator: each probe walks down one random
+  // path, and multiplies the numbers of children that pass propagation and the
+  // validator along it. Returns the average over |number_of_probes| probes, or
+  // 0 if propagation at the root fails.
+  double estimate_search_tree_size(int number_of_probes,
+                                   unsigned int seed) const;
+
+  // Lets the searches report their progress to |listener| about every
+  // |interval| seconds. The clock is only read every few thousand nodes, so
+  // the reports cost next to nothing. The listener must outlive the searches;
+  // NULL turns the reports off.
+  void set_progress_listener(ProgressListener* const listener,
+                             double interval) {
+    progress_listener = listener;
+    progress_interval = interval;
+  }
+
+  // Makes the searches record their events to |trace|, which must outlive
+  // them; NULL turns the recording off.
+  void set_search_trace(SearchTrace* const trace) {
+    search_trace = trace;
+  }
+
+  // Makes the searches give up after trying |limit| nodes, as if there were
+  // no more solutions: find_solution() returns NULL, and count_solutions()
+  // returns the solutions found so far. 0 turns the limit off.
+  void set_node_limit(unsigned long long limit) {
+    node_limit = (limit == 0) ? ~0ull : limit;
+  }
+
+  // Makes the searches give up, as at the node limit, once |*flag| is set,
+  // e.g. from another thread. The flag must outlive the searches; NULL turns
+  // this off.
+  void set_stop_flag(const std::atomic<bool>* const flag) {
+    stop_flag = flag;
+  }
+
+  // Runs the search of find_solution(), but with the squares in
+  // |search_order|, for at most |limit| nodes. Sets |*finished| to whether
+  // the search found a solution or showed that there is none within the
+  // limit, and |*solution|, if |solution| is not NULL, to the solution found
+  // or NULL; the caller is responsible for freeing it. Returns the number of
+  // nodes it tried. Probes do not report their progress or record traces.
+  unsigned long long probe_search(const int* const search_order,
+                                  unsigned long long limit,
+                                  bool* const finished,
+                                  Board** const solution = NULL) const;
+
+  // Makes the searches try the states of each square in |value_order|, which
+  // holds every state index once and must outlive the searches. NULL
+  // restores the order of the StateList.
+  void set_value_order(const int* const value_order) {
+    this->value_order = value_order;
+  }
+
   // Prints the board.
   void pretty_print(int items_per_line = 0) const;
 
  private:
+  // These run the searches of the board themselves.
+  friend class PortfolioSolver;
+  friend class PuzzleGenerator;
+  friend class ShardedSolver;
+  friend class SolutionGenerator;
+  friend class SolveHandle;
+
   const int number_of_squares;
   const StateList* const state_list;
 
@@ -79,17 +247,204 @@ class Board {
   // Array of State* pointers, with length |number_of_squares|.
   Square* const squares;
 
+  // Array of indices into |state_list|, with length |number_of_squares|.
+  // Kept in sync with |squares|; -1 for EMPTY squares.
+  int* const state_indices;
+
+  // Array of domains, with length |number_of_squares|.
+  Domain* const domains;
+
   // Function to check if the state of the Board is reasonable.
   BoardValidator validator;
 
+  // Whether the search solves independent groups of squares separately.
+  bool use_components;
+
+  // The levels of the search that run the lookahead, and its budget there.
+  int lookahead_depth;
+  long long lookahead_trials;
+
+  // Where the search reports its progress, or NULL.
+  ProgressListener* progress_listener;
+  double progress_interval;
+
+  // The child being searched, and the number of children, at each level of the
+  // current path of the search. Only kept while there is a listener.
+  struct ProgressLevel {
+    int child;
+    int number_of_children;
+  };
+  std::vector<ProgressLevel> progress_path;
+
+  // The nodes tried by the current search, and the most it may try.
+  unsigned long long number_of_nodes;
+  unsigned long long node_limit;
+
+  // Stops the searches once set, or NULL.
+  const std::atomic<bool>* stop_flag;
+
+  // The order in which the searches try the states, or NULL for the order
+  // of the StateList.
+  const int* value_order;
+
+  // Returns the state index that the searches try in |position| at a node.
+  int get_state_to_try(int position) const {
+    return (value_order == NULL) ? position : value_order[position];
+  }
+
+  timespec search_start;
+  double next_report;
+
+  // Where the searches record their events, or NULL, and the ring of the
+  // running search.
+  SearchTrace* search_trace;
+  TraceRing* trace_ring;
+
+  std::vector<const Constraint*> constraints;
+
+  // A constraint whose scope contains a square, and the position of the
+  // square in that scope.
+  struct Watch {
+    int constraint_index;
+    int scope_position;
+  };
+
+  // For each square, the constraints whose scope contains it.
+  std::vector<std::vector<Watch> > constraints_of_square;
+
+  // The counters of all constraints, and the offset of the first counter of
+  // each constraint.
+  std::vector<int> counters;
+  std::vector<int> counter_offsets;
+
+  // Indices of the constraints waiting to be propagated.
+  std::vector<int> propagation_queue;
+  std::vector<bool> is_queued;
+
+  // The previous contents of every square changed during the search, so that
+  // backtracking can restore them.
+  struct TrailEntry {
+    int square;
+    int state_index;
+    Domain domain;
+  };
+  std::vector<TrailEntry> trail;
+
+  // Sets the square to the state with the given index, and its domain to that
+  // single state, recording the old contents on the trail.
+  void assign(int index, int state_index);
+
+  // Restores the squares recorded on the trail after |trail_size| entries.
+  void undo(size_t trail_size);
+
+  // Sets the domain of the square, updating the counters of the constraints
+  // on it.
+  void change_domain(int index, Domain domain);
+
+  void queue_constraints_of(int index);
+
+  // Sets the square to the state with the given index in |state_list|, or
+  // to EMPTY if |state_index| is -1.
+  void set_state_index(int index, int state_index) {
+    assert(is_valid_index(index));
+    assert(-1 <= state_index &&
+           state_index < state_list->get_number_of_states());
+
+    squares[index] =
+        (state_index == -1) ? EMPTY : state_list->get_state(state_index);
+    state_indices[index] = state_index;
+  }
+
   // Returns a copy of the board. The caller is responsible for freeing the
   // memory allocated.
-  Board* copy() const;
+  Board* copy() const {
+    return copy(search_order);
+  }
 
-  // Returns a board containing the solution, if it exists.
-  // Returns NULL if there is no solution.
-  // The caller is responsible for freeing the pointer, if it is non-NULL.
-  bool find_solution_internal(int index);
+  // Returns a copy of the board that searches the squares in |search_order|,
+  // which must outlive it.
+  Board* copy(const int* const search_order) const;
+
+  // Starts timing and recording a search, if there is a listener or a trace.
+  void start_search();
+
+  // Stops recording the search.
+  void finish_search();
+
+  // Records an event of the search, if there is a trace.
+  void trace(int type, int square, int state_index, size_t depth) {
+    if (trace_ring != NULL) {
+      record_trace_event(type, square, state_index, depth);
+    }
+  }
+
+  void record_trace_event(int type,
+                          int square,
+                          int state_index,
+                          size_t depth);
+
+  // Counts a node of the search. Returns false once the search has tried
+  // more nodes than its limit, or has been told to stop.
+  bool count_node() {
+    return ++number_of_nodes <= node_limit &&
+           (stop_flag == NULL ||
+            !stop_flag->load(std::memory_order_relaxed));
+  }
+
+  // Records that the search moves to child |child| of |number_of_children| at
+  // |level| of the path, and reports the progress if it is due. Does nothing
+  // without a listener.
+  void track_progress(size_t level, int child, int number_of_children) {
+    if (progress_listener == NULL) {
+      return;
+    }
+    progress_path.resize(level);
+    ProgressLevel entry = {child, number_of_children};
+    progress_path.push_back(entry);
+    if ((number_of_nodes & (NODES_PER_CLOCK_CHECK - 1)) == 0) {
+      report_progress();
+    }
+  }
+
+  // The search reads the clock every this many nodes; a power of 2.
+  static const unsigned long long NODES_PER_CLOCK_CHECK = 4096;
+
+  void report_progress();
+
+  // Propagates, and checks the validator and, at the first levels of the
+  // search, the lookahead. Returns false if the node fails.
+  bool is_consistent(size_t depth);
+
+  // Tries the states of the squares of |squares| handed out by |next|, while
+  // |trials_left| lasts, and adds those that fail to |failed|, indexed by
+  // square. Leaves the board as it was.
+  void run_lookahead_trials(const std::vector<int>& squares,
+                            std::atomic<size_t>* next,
+                            std::atomic<long long>* trials_left,
+                            std::vector<Domain>* failed);
+
+  // Fills in the squares of |squares| from |index| onward, which are in
+  // search order. Returns true if it succeeds.
+  bool find_solution_internal(const std::vector<int>& squares, size_t index);
+
+  // Returns the number of ways to fill in the squares of |squares| from
+  // |index| onward, leaving the board as it was.
+  unsigned long long count_solutions_internal(const std::vector<int>& squares,
+                                              size_t index);
+
+  // Passes every way to fill in the squares of |squares| from |index| onward
+  // to |sink|, leaving the board as it was. Returns false if the sink stopped
+  // the search.
+  bool find_all_solutions_internal(const std::vector<int>& squares,
+                                   size_t index,
+                                   SolutionSink* const sink);
+
+  // Splits the empty squares of |squares| from |index| onward into groups
+  // that share no constraint, keeping the search order within each group.
+  // Returns false, and leaves |components| alone, if there is one group.
+  bool split_into_components(const std::vector<int>& squares,
+                             size_t index,
+                             std::vector<std::vector<int> >* components) const;
 
   #ifndef NDEBUG
   bool is_valid_index(int index) const {
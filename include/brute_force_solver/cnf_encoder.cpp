@@ -0,0 +1,173 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/cnf_encoder.h"
+
+#include <stddef.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/state_list.h"
+#include "include/sat_solver/cnf_formula.h"
+#include "include/sat_solver/sat_solver.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+using sat_solver::Clause;
+using sat_solver::CnfFormula;
+using sat_solver::SATISFIABLE;
+using sat_solver::SatSolver;
+
+CnfEncoder::CnfEncoder(const Board* const board) :
+    board(board),
+    number_of_states(board->get_state_list()->get_number_of_states()),
+    complete(true) {
+  for (int i = 0; i < board->get_number_of_squares() * number_of_states;
+       i++) {
+    formula.new_variable();
+  }
+
+  // Each square has exactly one state of its domain.
+  for (int square = 0; square < board->get_number_of_squares(); square++) {
+    Domain domain = board->get_domain(square);
+    std::vector<int> variables;
+    for (int i = 0; i < number_of_states; i++) {
+      if (domain_contains(domain, i)) {
+        variables.push_back(get_variable(square, i));
+      } else {
+        formula.add_unit(-get_variable(square, i));
+      }
+    }
+    formula.add_clause(variables);
+    formula.add_at_most(variables, 1);
+  }
+
+  for (int i = 0; i < board->get_number_of_constraints(); i++) {
+    if (!board->get_constraint(i)->add_clauses(this)) {
+      complete = false;
+      unencoded_constraints.push_back(i);
+    }
+  }
+}
+
+CnfEncoder::~CnfEncoder() {
+}
+
+int CnfEncoder::get_states_literal(int square, Domain states) {
+  states &= board->get_domain(square);
+  std::pair<int, Domain> key(square, states);
+  std::map<std::pair<int, Domain>, int>::const_iterator it =
+      states_literals.find(key);
+  if (it != states_literals.end()) {
+    return it->second;
+  }
+
+  int literal;
+  if (states == board->get_domain(square) || domain_size(states) == 0) {
+    // Always true, or always false.
+    literal = formula.new_variable();
+    formula.add_unit(states == 0 ? -literal : literal);
+  } else if (domain_size(states) == 1) {
+    literal = get_variable(square, lowest_state(states));
+  } else if (domain_size(board->get_domain(square) & ~states) == 1) {
+    literal = -get_variable(square,
+                            lowest_state(board->get_domain(square) & ~states));
+  } else {
+    std::vector<int> variables;
+    for (Domain rest = states; rest != 0; rest &= rest - 1) {
+      variables.push_back(get_variable(square, lowest_state(rest)));
+    }
+    literal = formula.add_or(variables);
+  }
+  states_literals[key] = literal;
+  return literal;
+}
+
+Board* CnfEncoder::decode(const SatSolver& solver) const {
+  const StateList* state_list = board->get_state_list();
+  Board* solution = new Board(board->get_number_of_squares(),
+                              state_list,
+                              board->get_search_order(),
+                              NULL);
+  for (int square = 0; square < board->get_number_of_squares(); square++) {
+    for (int i = 0; i < number_of_states; i++) {
+      if (solver.get_value(get_variable(square, i))) {
+        solution->set_value(square, state_list->get_state(i));
+        break;
+      }
+    }
+  }
+  return solution;
+}
+
+Board* CnfEncoder::find_solution(long long max_conflicts) const {
+  SatSolver solver(formula);
+  while (solver.solve(max_conflicts) == SATISFIABLE) {
+    Board* candidate = decode(solver);
+    if (is_solution(candidate)) {
+      return candidate;
+    }
+    delete candidate;
+
+    // Rule out this candidate, and look for another.
+    Clause blocking_clause;
+    for (int square = 0; square < board->get_number_of_squares(); square++) {
+      for (int i = 0; i < number_of_states; i++) {
+        if (solver.get_value(get_variable(square, i))) {
+          blocking_clause.push_back(-get_variable(square, i));
+          break;
+        }
+      }
+    }
+    solver.add_clause(blocking_clause);
+  }
+  return NULL;
+}
+
+bool CnfEncoder::is_solution(const Board* const candidate) const {
+  BoardValidator validator = board->get_validator();
+  if (validator != NULL && !validator(candidate)) {
+    return false;
+  }
+  if (unencoded_constraints.empty()) {
+    return true;
+  }
+  std::vector<int> state_indices(board->get_number_of_squares());
+  for (int square = 0; square < board->get_number_of_squares(); square++) {
+    state_indices[square] = candidate->get_state_index(square);
+  }
+  for (size_t i = 0; i < unencoded_constraints.size(); i++) {
+    const Constraint* constraint =
+        board->get_constraint(unencoded_constraints[i]);
+    if (constraint->count_violations(&state_indices[0]) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
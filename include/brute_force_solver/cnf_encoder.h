@@ -0,0 +1,113 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Encodes a Board as a SAT problem.
+//
+// Each state of each square is a Boolean variable, and each square has
+// exactly one of the states in its domain. Constraints add their own clauses
+// with Constraint::add_clauses(). The validator of the board, and the
+// constraints without clauses, are not encoded, so a model of the formula is
+// only a candidate solution: find_solution() checks each candidate against
+// them, and blocks it and solves again if it fails.
+// -----------------------------------------------------------------------------
+
+#ifndef _CNF_ENCODER_H_
+#define _CNF_ENCODER_H_
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "include/brute_force_solver/domain.h"
+#include "include/sat_solver/cnf_formula.h"
+#include "include/sat_solver/sat_solver.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+class CnfEncoder {
+ public:
+  // The board must outlive the encoder.
+  explicit CnfEncoder(const Board* const board);
+  ~CnfEncoder();
+
+  // Returns false if some constraint of the board has no clauses. The
+  // validator is never encoded, so the formula alone may still allow boards
+  // that are not solutions.
+  bool is_complete() const {
+    return complete;
+  }
+
+  sat_solver::CnfFormula* get_formula() {
+    return &formula;
+  }
+
+  const sat_solver::CnfFormula& get_formula() const {
+    return formula;
+  }
+
+  // Returns the variable that is true when |square| has the state with index
+  // |state_index|.
+  int get_variable(int square, int state_index) const {
+    return 1 + square * number_of_states + state_index;
+  }
+
+  // Returns a literal that is true when |square| has one of the |states|.
+  int get_states_literal(int square, Domain states);
+
+  // Returns the board given by the model of |solver|: a candidate solution,
+  // which satisfies the encoded constraints but not necessarily the others or
+  // the validator.
+  // The caller is responsible for freeing the pointer.
+  Board* decode(const sat_solver::SatSolver& solver) const;
+
+  // Solves the encoding with the SatSolver, giving up after |max_conflicts|
+  // conflicts per call to the solver if it is not negative. Candidates that
+  // fail the validator or a constraint without clauses are blocked, and the
+  // solver runs again. Returns a board containing the solution, or NULL if
+  // there is none or the solver gave up.
+  // The caller is responsible for freeing the pointer, if it is non-NULL.
+  Board* find_solution(long long max_conflicts = -1) const;
+
+ private:
+  // Returns true if |candidate| passes the validator of the board and the
+  // constraints without clauses.
+  bool is_solution(const Board* const candidate) const;
+
+  const Board* const board;
+  const int number_of_states;
+  sat_solver::CnfFormula formula;
+  bool complete;
+
+  // The indices of the constraints that have no clauses.
+  std::vector<int> unencoded_constraints;
+
+  // The literals made by get_states_literal(), so that constraints share
+  // them.
+  std::map<std::pair<int, Domain>, int> states_literals;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _CNF_ENCODER_H_
@@ -0,0 +1,58 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/constraint.h"
+
+#include <assert.h>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+Constraint::Constraint(const int* const scope, int scope_size) :
+    scope(new int[scope_size]),
+    scope_size(scope_size) {
+  for (int i = 0; i < scope_size; i++) {
+    this->scope[i] = scope[i];
+  }
+}
+
+Constraint::Constraint(int scope_size) :
+    scope(new int[scope_size]),
+    scope_size(scope_size) {
+}
+
+Constraint::~Constraint() {
+  delete[] scope;
+}
+
+int Constraint::count_violations(const int* const state_indices) const {
+  assert(has_frontier_states());
+  FrontierState state = get_initial_frontier_state();
+  for (int i = 0; i < scope_size; i++) {
+    state = get_next_frontier_state(state, i, state_indices[scope[i]]);
+    if (state == REJECTED_FRONTIER_STATE) {
+      return 1;
+    }
+  }
+  return is_accepting_frontier_state(state) ? 0 : 1;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
@@ -0,0 +1,144 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef _CONSTRAINT_H_
+#define _CONSTRAINT_H_
+
+#include "include/brute_force_solver/domain.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+class CnfEncoder;
+
+// The state of a constraint during a sweep over the board; see
+// Constraint::get_next_frontier_state().
+typedef unsigned long long FrontierState;
+const FrontierState REJECTED_FRONTIER_STATE = ~0ull;
+
+// A rule over a fixed set of squares (its scope) that can narrow the domains
+// of those squares. Constraints are added to a Board with
+// Board::add_constraint(), and are propagated whenever the domain of a square
+// in their scope changes.
+//
+// Constraints must not keep per-search state, so that one Constraint can be
+// shared by several copies of a Board. A constraint that wants incremental
+// state instead asks the Board for counters, which the Board keeps up to date
+// through update_counters() and restores when it backtracks.
+class Constraint {
+ public:
+  // The |scope| array is copied.
+  Constraint(const int* const scope, int scope_size);
+  virtual ~Constraint();
+
+  int get_scope_size() const {
+    return scope_size;
+  }
+
+  int get_scope(int i) const {
+    return scope[i];
+  }
+
+  // Removes states that cannot be part of a solution from the domains of the
+  // squares in the scope, with Board::restrict_domain(). |counters| are the
+  // counters that the Board keeps for this constraint.
+  // Returns false if the constraint can no longer be satisfied.
+  virtual bool propagate(Board* const board,
+                         const int* const counters) const = 0;
+
+  // The number of counters the Board keeps for this constraint.
+  virtual int get_number_of_counters() const {
+    return 0;
+  }
+
+  // Updates |counters| when the domain of the square at |scope_position|
+  // changes from |old_domain| to |new_domain|. Backtracking calls this with
+  // the domains swapped, so the update must be undone by its reverse.
+  //
+  // Counters start at zero, as if every domain were empty, and the Board then
+  // reports the current domain of every square in the scope.
+  virtual void update_counters(int scope_position,
+                               Domain old_domain,
+                               Domain new_domain,
+                               int* const counters) const {
+  }
+
+  // Sweeps over the board, such as the FrontierSolver, assign the squares of
+  // the scope one at a time, in any order, and run the constraint as an
+  // automaton over them. The frontier state sums up the squares assigned so
+  // far. Equal frontier states must behave the same on the rest of the scope,
+  // and the fewer distinct frontier states the better, since a sweep keeps
+  // one entry per combination of the frontier states of the constraints that
+  // it has started but not finished.
+  virtual bool has_frontier_states() const {
+    return false;
+  }
+
+  virtual FrontierState get_initial_frontier_state() const {
+    return 0;
+  }
+
+  // Returns the frontier state after the square at |scope_position| is
+  // assigned the state with index |state_index|, or REJECTED_FRONTIER_STATE
+  // if the constraint can no longer be satisfied.
+  virtual FrontierState get_next_frontier_state(FrontierState frontier_state,
+                                                int scope_position,
+                                                int state_index) const {
+    return frontier_state;
+  }
+
+  // Returns true if |frontier_state|, reached once every square of the scope
+  // is assigned, satisfies the constraint.
+  virtual bool is_accepting_frontier_state(
+      FrontierState frontier_state) const {
+    return true;
+  }
+
+  // Local search works on complete assignments, given as the state index of
+  // every square of the board in |state_indices|. Returns how far the squares
+  // of the scope are from satisfying the constraint, or 0 if they satisfy it.
+  // By default this runs the frontier states, and any violation counts as 1.
+  virtual int count_violations(const int* const state_indices) const;
+
+  // Adds clauses to the formula of |encoder| that hold exactly when the
+  // constraint is satisfied. Returns false if the constraint has no
+  // encoding.
+  virtual bool add_clauses(CnfEncoder* const encoder) const {
+    return false;
+  }
+
+ protected:
+  // For subclasses that fill in the scope with set_scope() instead.
+  explicit Constraint(int scope_size);
+
+  void set_scope(int i, int square) {
+    scope[i] = square;
+  }
+
+ private:
+  int* const scope;
+  const int scope_size;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _CONSTRAINT_H_
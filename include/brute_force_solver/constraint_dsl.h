@@ -0,0 +1,564 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// A small language for writing puzzle rules as types, so that the compiler
+// builds the validator for each puzzle instead of it being written by hand.
+//
+// A rule names its squares as template arguments, as Squares<...> or as a
+// Range<START, END, STEP> of them, and the state index it talks about. For
+// example, the rules of a 4 by 4 Thermometers puzzle might read:
+//
+//   typedef Rules<
+//       Thermometer<Range<0, 3, 1>, FILLED_INDEX>,
+//       Count<Range<0, 3, 1>, FILLED_INDEX, 3>,
+//       Count<Range<0, 12, 4>, FILLED_INDEX, 3>,
+//       ...> PuzzleRules;
+//
+//   Board board(16, &STATE_LIST, search_order, &PuzzleRules::validate);
+//
+// Every scope is a constant array, so the loops in each check have constant
+// bounds and the checks of all the rules are inlined into one function, with
+// no tables to walk at run time. The rules take a partly filled board, and
+// only fail once the assigned squares can no longer satisfy them.
+//
+// The scopes are also exposed as metadata, for the parts of the library that
+// track which rules watch which squares: Rules<...>::add_constraints() turns
+// every rule into a Constraint over its scope, so that the Board only checks
+// the rules whose squares changed, and local search can count violations.
+// Count and Thermometer become the propagating LineConstraint and
+// ThermometerConstraint; the other rules only reject.
+//
+// The rules are:
+//   Count<CELLS, STATE, TARGET>       Exactly TARGET of CELLS are STATE.
+//   Sum<CELLS, TARGET, VALUES>        The values of CELLS add up to TARGET,
+//                                     where VALUES is a StateValues<...>.
+//   Thermometer<CELLS, STATE>         The STATE squares of CELLS are a prefix
+//                                     of them, starting from the bulb.
+//   Island<GRID, SQUARE, SIZE, STATE> The group of orthogonally connected
+//                                     STATE squares of GRID holding SQUARE
+//                                     has SIZE squares.
+//   NoTwoAdjacent<GRID, STATE>        No two neighbouring squares of GRID are
+//                                     both STATE.
+//   Connected<GRID, STATE>            The STATE squares of GRID are
+//                                     orthogonally connected.
+//   NoWindow<GRID, STATE>             No 2 by 2 window of GRID is all STATE.
+//
+// A new rule is a type with a Scope typedef (a Squares<...>) and a static
+// template function
+//
+//   template <typename READER> static bool holds(const READER& read);
+//
+// where read(square) returns the state index of the square, or -1 if the
+// square is EMPTY. It may also have a static make_constraint() that returns a
+// new Constraint which propagates the rule.
+// -----------------------------------------------------------------------------
+
+#ifndef _CONSTRAINT_DSL_H_
+#define _CONSTRAINT_DSL_H_
+
+#include <utility>
+#include <vector>
+
+#include "include/brute_force_solver/binary_constraints.h"
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/line_constraint.h"
+#include "include/grid/grid_geometry.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+namespace dsl {
+
+// The state index that read() returns for an EMPTY square.
+const int EMPTY_INDEX = -1;
+
+// Count and Thermometer propagate with the constraints over two-valued cells
+// up to this many cells, and are only checked beyond it.
+const int MAX_LINE_CELLS = 32;
+
+// A list of squares, known at compile time.
+template <int... SQUARES>
+struct Squares {
+  static_assert(sizeof...(SQUARES) > 0, "A scope needs at least one square");
+
+  static constexpr int SIZE = sizeof...(SQUARES);
+  static constexpr int SQUARE[SIZE] = {SQUARES...};
+};
+
+template <int START, int STEP, typename OFFSETS>
+struct RangeOf;
+
+template <int START, int STEP, int... OFFSETS>
+struct RangeOf<START, STEP, std::integer_sequence<int, OFFSETS...> > {
+  typedef Squares<(START + OFFSETS * STEP)...> type;
+};
+
+// Checks that a Range reaches its end, and counts its squares.
+template <int START, int END, int STEP>
+struct RangeCheck {
+  static_assert(STEP != 0, "A range needs a non-zero step");
+  static_assert((END - START) % STEP == 0 && (END - START) / STEP >= 0,
+                "A range must reach its end");
+  static constexpr int SIZE = (END - START) / STEP + 1;
+};
+
+// The squares from START to END inclusive, with step size STEP, which may be
+// negative.
+template <int START, int END, int STEP>
+using Range = typename RangeOf<
+    START,
+    STEP,
+    std::make_integer_sequence<int, RangeCheck<START, END, STEP>::SIZE> >::type;
+
+// The value of each state, by state index, for Sum.
+template <int... VALUES>
+struct StateValues {
+  static constexpr int NUMBER_OF_STATES = sizeof...(VALUES);
+  static constexpr int VALUE[NUMBER_OF_STATES] = {VALUES...};
+
+  static constexpr int min_value() {
+    int result = VALUE[0];
+    for (int i = 1; i < NUMBER_OF_STATES; i++) {
+      result = VALUE[i] < result ? VALUE[i] : result;
+    }
+    return result;
+  }
+
+  static constexpr int max_value() {
+    int result = VALUE[0];
+    for (int i = 1; i < NUMBER_OF_STATES; i++) {
+      result = VALUE[i] > result ? VALUE[i] : result;
+    }
+    return result;
+  }
+
+  static constexpr int MIN = min_value();
+  static constexpr int MAX = max_value();
+};
+
+// The neighbour, edge and window tables of a grid, built at compile time.
+// The tables have a spare entry so that grids with a single row or column,
+// which have no edges or windows along one direction, still compile.
+//
+// These are the tables of GridGeometry, in the same order. GridGeometry is
+// sized at run time and keeps them in vectors, which a constant expression
+// cannot read, so the rules, whose loops need constant bounds, build their
+// own from the same directions and window corners.
+template <int ROWS, int COLUMNS>
+struct GridTables {
+  static constexpr int NUMBER_OF_SQUARES = ROWS * COLUMNS;
+  static constexpr int NUMBER_OF_EDGES =
+      ROWS * (COLUMNS - 1) + (ROWS - 1) * COLUMNS;
+  static constexpr int NUMBER_OF_WINDOWS = (ROWS - 1) * (COLUMNS - 1);
+
+  int number_of_neighbours[NUMBER_OF_SQUARES];
+  int neighbours[NUMBER_OF_SQUARES][grid::NUMBER_OF_ORTHOGONAL_DIRECTIONS];
+  int edges[NUMBER_OF_EDGES + 1][2];
+  int windows[NUMBER_OF_WINDOWS + 1][grid::NUMBER_OF_WINDOW_CORNERS];
+};
+
+template <int ROWS, int COLUMNS>
+constexpr GridTables<ROWS, COLUMNS> build_grid_tables() {
+  GridTables<ROWS, COLUMNS> tables = {};
+  int number_of_edges = 0;
+  int number_of_windows = 0;
+  for (int row = 0; row < ROWS; row++) {
+    for (int column = 0; column < COLUMNS; column++) {
+      int square = row * COLUMNS + column;
+      for (int d = 0; d < grid::NUMBER_OF_ORTHOGONAL_DIRECTIONS; d++) {
+        int next_row = row + grid::DELTA_ROW[d];
+        int next_column = column + grid::DELTA_COLUMN[d];
+        if (next_row >= 0 && next_row < ROWS &&
+            next_column >= 0 && next_column < COLUMNS) {
+          tables.neighbours[square][tables.number_of_neighbours[square]++] =
+              next_row * COLUMNS + next_column;
+        }
+      }
+      if (column + 1 < COLUMNS) {
+        tables.edges[number_of_edges][0] = square;
+        tables.edges[number_of_edges][1] = square + 1;
+        number_of_edges++;
+      }
+      if (row + 1 < ROWS) {
+        tables.edges[number_of_edges][0] = square;
+        tables.edges[number_of_edges][1] = square + COLUMNS;
+        number_of_edges++;
+      }
+      if (row + 1 < ROWS && column + 1 < COLUMNS) {
+        int* window = tables.windows[number_of_windows++];
+        window[grid::WINDOW_TOP_LEFT] = square;
+        window[grid::WINDOW_TOP_RIGHT] = square + 1;
+        window[grid::WINDOW_BOTTOM_LEFT] = square + COLUMNS;
+        window[grid::WINDOW_BOTTOM_RIGHT] = square + COLUMNS + 1;
+      }
+    }
+  }
+  return tables;
+}
+
+// A rectangular grid of squares, numbered in row-major order from 0, as used
+// by GridGeometry.
+template <int ROWS, int COLUMNS>
+struct Grid {
+  static_assert(ROWS > 0 && COLUMNS > 0, "A grid needs at least one square");
+
+  static constexpr int NUMBER_OF_SQUARES = ROWS * COLUMNS;
+  static constexpr GridTables<ROWS, COLUMNS> TABLES =
+      build_grid_tables<ROWS, COLUMNS>();
+
+  typedef Range<0, NUMBER_OF_SQUARES - 1, 1> Scope;
+};
+
+// Reads the state indices of a partly filled Board.
+class BoardReader {
+ public:
+  explicit BoardReader(const Board* const board) : board(board) {
+  }
+
+  int operator()(int square) const {
+    return board->get_state_index(square);
+  }
+
+ private:
+  const Board* const board;
+};
+
+// Reads the state indices of a complete assignment, as local search keeps it.
+class StateIndexReader {
+ public:
+  explicit StateIndexReader(const int* const state_indices) :
+      state_indices(state_indices) {
+  }
+
+  int operator()(int square) const {
+    return state_indices[square];
+  }
+
+ private:
+  const int* const state_indices;
+};
+
+// Checks RULE whenever the domain of a square in its scope changes. It only
+// rejects, and does not narrow any domains.
+template <typename RULE>
+class RuleConstraint : public Constraint {
+ public:
+  RuleConstraint() :
+      Constraint(RULE::Scope::SQUARE, RULE::Scope::SIZE) {
+  }
+
+  virtual bool propagate(Board* const board,
+                         const int* const counters) const {
+    return RULE::holds(BoardReader(board));
+  }
+
+  virtual int count_violations(const int* const state_indices) const {
+    return RULE::holds(StateIndexReader(state_indices)) ? 0 : 1;
+  }
+};
+
+// Returns the squares of CELLS as cells that are filled for the state with
+// index STATE, for the constraints over two-valued cells.
+template <typename CELLS, int STATE>
+void make_binary_cells(BinaryCell* const cells) {
+  for (int i = 0; i < CELLS::SIZE; i++) {
+    cells[i].square = CELLS::SQUARE[i];
+    cells[i].filled = single_state_domain(STATE);
+  }
+}
+
+// Exactly TARGET of CELLS are in the state with index STATE.
+template <typename CELLS, int STATE, int TARGET>
+struct Count {
+  typedef CELLS Scope;
+
+  template <typename READER>
+  static bool holds(const READER& read) {
+    int min_count = 0;
+    int max_count = 0;
+    for (int i = 0; i < CELLS::SIZE; i++) {
+      int state = read(CELLS::SQUARE[i]);
+      if (state == STATE) {
+        min_count++;
+        max_count++;
+      } else if (state == EMPTY_INDEX) {
+        max_count++;
+      }
+    }
+    return min_count <= TARGET && TARGET <= max_count;
+  }
+
+  // A LineConstraint, which forces the rest of the cells once the count is
+  // decided either way.
+  static Constraint* make_constraint() {
+    if (CELLS::SIZE > MAX_LINE_CELLS) {
+      return new RuleConstraint<Count>();
+    }
+    BinaryCell cells[CELLS::SIZE];
+    make_binary_cells<CELLS, STATE>(cells);
+    return new LineConstraint(cells, CELLS::SIZE, TARGET, NULL, 0);
+  }
+};
+
+// The values of CELLS, given by VALUES, add up to TARGET.
+template <typename CELLS, int TARGET, typename VALUES>
+struct Sum {
+  typedef CELLS Scope;
+
+  template <typename READER>
+  static bool holds(const READER& read) {
+    int min_sum = 0;
+    int max_sum = 0;
+    for (int i = 0; i < CELLS::SIZE; i++) {
+      int state = read(CELLS::SQUARE[i]);
+      if (state == EMPTY_INDEX) {
+        min_sum += VALUES::MIN;
+        max_sum += VALUES::MAX;
+      } else {
+        min_sum += VALUES::VALUE[state];
+        max_sum += VALUES::VALUE[state];
+      }
+    }
+    return min_sum <= TARGET && TARGET <= max_sum;
+  }
+};
+
+// Starting from the bulb, the first square of CELLS, the squares in the state
+// with index STATE come before all the others.
+template <typename CELLS, int STATE>
+struct Thermometer {
+  typedef CELLS Scope;
+
+  template <typename READER>
+  static bool holds(const READER& read) {
+    bool seen_other = false;
+    for (int i = 0; i < CELLS::SIZE; i++) {
+      int state = read(CELLS::SQUARE[i]);
+      if (state == STATE) {
+        if (seen_other) {
+          return false;
+        }
+      } else if (state != EMPTY_INDEX) {
+        seen_other = true;
+      }
+    }
+    return true;
+  }
+
+  // A ThermometerConstraint, which fills in the squares toward the bulb of a
+  // filled square and empties those toward the tip of an unfilled one.
+  static Constraint* make_constraint() {
+    if (CELLS::SIZE > MAX_LINE_CELLS) {
+      return new RuleConstraint<Thermometer>();
+    }
+    BinaryCell cells[CELLS::SIZE];
+    make_binary_cells<CELLS, STATE>(cells);
+    return new ThermometerConstraint(cells, CELLS::SIZE);
+  }
+};
+
+// The orthogonally connected group of squares in the state with index STATE
+// that holds SQUARE has exactly SIZE squares. While the group still touches
+// an EMPTY square it only has to be no larger than SIZE.
+template <typename GRID, int SQUARE, int SIZE, int STATE>
+struct Island {
+  typedef typename GRID::Scope Scope;
+
+  template <typename READER>
+  static bool holds(const READER& read) {
+    int state = read(SQUARE);
+    if (state == EMPTY_INDEX) {
+      return true;
+    }
+    if (state != STATE) {
+      return false;
+    }
+
+    bool seen[GRID::NUMBER_OF_SQUARES] = {};
+    int queue[GRID::NUMBER_OF_SQUARES];
+    int queue_size = 0;
+    bool open = false;
+    queue[queue_size++] = SQUARE;
+    seen[SQUARE] = true;
+    for (int head = 0; head < queue_size; head++) {
+      int square = queue[head];
+      for (int i = 0; i < GRID::TABLES.number_of_neighbours[square]; i++) {
+        int next = GRID::TABLES.neighbours[square][i];
+        if (seen[next]) {
+          continue;
+        }
+        int next_state = read(next);
+        if (next_state == EMPTY_INDEX) {
+          open = true;
+        } else if (next_state == STATE) {
+          if (queue_size == SIZE) {
+            return false;
+          }
+          seen[next] = true;
+          queue[queue_size++] = next;
+        }
+      }
+    }
+    return open || queue_size == SIZE;
+  }
+};
+
+// The squares of GRID in the state with index STATE are orthogonally
+// connected. While some squares are EMPTY they only have to be connected
+// through EMPTY squares.
+template <typename GRID, int STATE>
+struct Connected {
+  typedef typename GRID::Scope Scope;
+
+  template <typename READER>
+  static bool holds(const READER& read) {
+    int first = 0;
+    while (first < GRID::NUMBER_OF_SQUARES && read(first) != STATE) {
+      first++;
+    }
+    if (first == GRID::NUMBER_OF_SQUARES) {
+      return true;
+    }
+
+    bool seen[GRID::NUMBER_OF_SQUARES] = {};
+    int queue[GRID::NUMBER_OF_SQUARES];
+    int queue_size = 0;
+    queue[queue_size++] = first;
+    seen[first] = true;
+    for (int head = 0; head < queue_size; head++) {
+      int square = queue[head];
+      for (int i = 0; i < GRID::TABLES.number_of_neighbours[square]; i++) {
+        int next = GRID::TABLES.neighbours[square][i];
+        if (!seen[next]) {
+          int next_state = read(next);
+          if (next_state == STATE || next_state == EMPTY_INDEX) {
+            seen[next] = true;
+            queue[queue_size++] = next;
+          }
+        }
+      }
+    }
+    for (int square = first + 1; square < GRID::NUMBER_OF_SQUARES; square++) {
+      if (!seen[square] && read(square) == STATE) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// No two orthogonally neighbouring squares of GRID are both in the state with
+// index STATE.
+template <typename GRID, int STATE>
+struct NoTwoAdjacent {
+  typedef typename GRID::Scope Scope;
+
+  template <typename READER>
+  static bool holds(const READER& read) {
+    for (int i = 0; i < GRID::TABLES.NUMBER_OF_EDGES; i++) {
+      if (read(GRID::TABLES.edges[i][0]) == STATE &&
+          read(GRID::TABLES.edges[i][1]) == STATE) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// No 2 by 2 window of GRID is entirely in the state with index STATE.
+template <typename GRID, int STATE>
+struct NoWindow {
+  typedef typename GRID::Scope Scope;
+
+  template <typename READER>
+  static bool holds(const READER& read) {
+    for (int i = 0; i < GRID::TABLES.NUMBER_OF_WINDOWS; i++) {
+      const int* window = GRID::TABLES.windows[i];
+      if (read(window[grid::WINDOW_TOP_LEFT]) == STATE &&
+          read(window[grid::WINDOW_TOP_RIGHT]) == STATE &&
+          read(window[grid::WINDOW_BOTTOM_LEFT]) == STATE &&
+          read(window[grid::WINDOW_BOTTOM_RIGHT]) == STATE) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+// Returns the Constraint of RULE: the one its make_constraint() builds, if it
+// has one, and otherwise a RuleConstraint that checks it.
+template <typename RULE>
+auto make_rule_constraint(int) -> decltype(RULE::make_constraint()) {
+  return RULE::make_constraint();
+}
+
+template <typename RULE>
+Constraint* make_rule_constraint(long) {
+  return new RuleConstraint<RULE>();
+}
+
+// The rules of a puzzle, all of which must hold.
+template <typename... RULES>
+struct Rules {
+  static_assert(sizeof...(RULES) > 0, "A puzzle needs at least one rule");
+
+  static constexpr int NUMBER_OF_RULES = sizeof...(RULES);
+
+  // The scope of each rule, by its position in RULES.
+  static constexpr int SCOPE_SIZE[NUMBER_OF_RULES] = {RULES::Scope::SIZE...};
+  static constexpr const int* SCOPE[NUMBER_OF_RULES] = {
+    RULES::Scope::SQUARE...
+  };
+
+  // A BoardValidator that checks every rule.
+  static bool validate(const Board* const board) {
+    BoardReader read(board);
+    return (RULES::holds(read) && ...);
+  }
+
+  // Returns the number of rules that the complete assignment |state_indices|
+  // breaks.
+  static int count_violations(const int* const state_indices) {
+    StateIndexReader read(state_indices);
+    return ((RULES::holds(read) ? 0 : 1) + ...);
+  }
+
+  // Adds every rule to |board| as a Constraint over its scope, so that the
+  // board checks a rule only when one of its squares changes, instead of
+  // running validate() on the whole board. Rules with a make_constraint()
+  // also narrow domains. The caller is responsible for freeing the
+  // constraints.
+  static void add_constraints(Board* const board,
+                              std::vector<Constraint*>* const constraints) {
+    size_t first = constraints->size();
+    (constraints->push_back(make_rule_constraint<RULES>(0)), ...);
+    for (size_t i = first; i < constraints->size(); i++) {
+      board->add_constraint((*constraints)[i]);
+    }
+  }
+};
+
+}  // namespace dsl
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _CONSTRAINT_DSL_H_
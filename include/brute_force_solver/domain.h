@@ -0,0 +1,65 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef _DOMAIN_H_
+#define _DOMAIN_H_
+
+#include <assert.h>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+// A set of states that a square may still take, where bit i is set if the
+// state with index i in the StateList is allowed.
+typedef unsigned long long Domain;
+
+// Domains can only describe StateLists with at most this many states.
+const int MAX_NUMBER_OF_STATES = 64;
+
+inline Domain single_state_domain(int state_index) {
+  assert(0 <= state_index && state_index < MAX_NUMBER_OF_STATES);
+  return 1ull << state_index;
+}
+
+// Returns the domain containing the first |number_of_states| states.
+inline Domain full_domain(int number_of_states) {
+  assert(0 <= number_of_states && number_of_states <= MAX_NUMBER_OF_STATES);
+  return (number_of_states == MAX_NUMBER_OF_STATES) ?
+      ~0ull : (1ull << number_of_states) - 1;
+}
+
+inline bool domain_contains(Domain domain, int state_index) {
+  return (domain >> state_index) & 1;
+}
+
+inline int domain_size(Domain domain) {
+  return __builtin_popcountll(domain);
+}
+
+// Returns the index of the lowest state in a non-empty domain.
+inline int lowest_state(Domain domain) {
+  assert(domain != 0);
+  return __builtin_ctzll(domain);
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _DOMAIN_H_
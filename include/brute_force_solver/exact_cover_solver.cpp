@@ -0,0 +1,395 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/exact_cover_solver.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/solution_sink.h"
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+namespace {
+
+// Keeps a copy of the first solution, and stops the search.
+class FirstSolutionSink : public SolutionSink {
+ public:
+  FirstSolutionSink() : solution(NULL) {
+  }
+
+  virtual bool add_solution(const Board* const board) {
+    const StateList* state_list = board->get_state_list();
+    solution = new Board(board->get_number_of_squares(),
+                         state_list,
+                         board->get_search_order(),
+                         NULL);
+    for (int i = 0; i < board->get_number_of_squares(); i++) {
+      solution->set_value(i, board->get_value(i));
+    }
+    return false;
+  }
+
+  Board* get_solution() const {
+    return solution;
+  }
+
+ private:
+  Board* solution;
+};
+
+unsigned long long saturating_add(unsigned long long a,
+                                  unsigned long long b) {
+  return (a > ~0ull - b) ? ~0ull : a + b;
+}
+
+}  // namespace
+
+// The state shared by the threads of one run.
+struct SharedRun {
+  SolutionSink* sink;
+  std::mutex sink_mutex;
+  std::atomic<bool> is_stopped;
+
+  // The index of the next top-level row to search.
+  std::atomic<size_t> next_task;
+};
+
+// The search of one thread, on its own copy of the links.
+class ExactCoverSolver::Search {
+ public:
+  Search(const ExactCoverSolver* const solver, SharedRun* const shared) :
+      solver(solver),
+      shared(shared),
+      nodes(solver->nodes),
+      column_sizes(solver->column_sizes),
+      board(NULL),
+      number_of_solutions(0) {
+    if (shared->sink != NULL) {
+      const Board* original = solver->board;
+      board = new Board(original->get_number_of_squares(),
+                        original->get_state_list(),
+                        original->get_search_order(),
+                        NULL);
+      for (int i = 0; i < original->get_number_of_squares(); i++) {
+        board->set_value(i, original->get_value(i));
+      }
+    }
+  }
+
+  ~Search() {
+    delete board;
+  }
+
+  // Returns the primary column with the fewest rows left, or ROOT if every
+  // primary column is covered.
+  int choose_column() const {
+    int best = ROOT;
+    int best_size = 0;
+    for (int c = nodes[ROOT].right; c != ROOT; c = nodes[c].right) {
+      if (best == ROOT || column_sizes[c] < best_size) {
+        best = c;
+        best_size = column_sizes[c];
+        if (best_size <= 1) {
+          break;
+        }
+      }
+    }
+    return best;
+  }
+
+  void cover(int c) {
+    nodes[nodes[c].right].left = nodes[c].left;
+    nodes[nodes[c].left].right = nodes[c].right;
+    for (int i = nodes[c].down; i != c; i = nodes[i].down) {
+      for (int j = nodes[i].right; j != i; j = nodes[j].right) {
+        nodes[nodes[j].down].up = nodes[j].up;
+        nodes[nodes[j].up].down = nodes[j].down;
+        column_sizes[nodes[j].column]--;
+      }
+    }
+  }
+
+  void uncover(int c) {
+    for (int i = nodes[c].up; i != c; i = nodes[i].up) {
+      for (int j = nodes[i].left; j != i; j = nodes[j].left) {
+        column_sizes[nodes[j].column]++;
+        nodes[nodes[j].down].up = j;
+        nodes[nodes[j].up].down = j;
+      }
+    }
+    nodes[nodes[c].right].left = c;
+    nodes[nodes[c].left].right = c;
+  }
+
+  // Picks the row of node |r|, covering its other columns; the column of |r|
+  // itself must already be covered.
+  void pick(int r) {
+    chosen_rows.push_back(nodes[r].row);
+    for (int j = nodes[r].right; j != r; j = nodes[j].right) {
+      cover(nodes[j].column);
+    }
+  }
+
+  void unpick(int r) {
+    for (int j = nodes[r].left; j != r; j = nodes[j].left) {
+      uncover(nodes[j].column);
+    }
+    chosen_rows.pop_back();
+  }
+
+  // Searches the top-level rows of column |c| that no other thread has taken.
+  void run_tasks(int c, const std::vector<int>& tasks) {
+    cover(c);
+    for (size_t task = shared->next_task++;
+         task < tasks.size() && !shared->is_stopped;
+         task = shared->next_task++) {
+      pick(tasks[task]);
+      search();
+      unpick(tasks[task]);
+    }
+    uncover(c);
+  }
+
+  // Returns false if the search has stopped.
+  bool search() {
+    if (shared->is_stopped) {
+      return false;
+    }
+
+    int c = choose_column();
+    if (c == ROOT) {
+      return report();
+    }
+    if (column_sizes[c] == 0) {
+      return true;
+    }
+
+    cover(c);
+    bool is_running = true;
+    for (int r = nodes[c].down; r != c && is_running; r = nodes[r].down) {
+      pick(r);
+      is_running = search();
+      unpick(r);
+    }
+    uncover(c);
+    return is_running;
+  }
+
+  unsigned long long get_number_of_solutions() const {
+    return number_of_solutions;
+  }
+
+ private:
+  bool report() {
+    number_of_solutions = saturating_add(number_of_solutions, 1);
+    if (shared->sink == NULL) {
+      return true;
+    }
+
+    const StateList* state_list = board->get_state_list();
+    for (size_t i = 0; i < chosen_rows.size(); i++) {
+      int row = chosen_rows[i];
+      for (int a = solver->assignment_offsets[row];
+           a < solver->assignment_offsets[row + 1];
+           a++) {
+        const ExactCoverAssignment& assignment = solver->assignments[a];
+        board->set_value(assignment.square,
+                         state_list->get_state(assignment.state_index));
+      }
+    }
+
+    bool is_running;
+    {
+      std::lock_guard<std::mutex> lock(shared->sink_mutex);
+      is_running = !shared->is_stopped && shared->sink->add_solution(board);
+      if (!is_running) {
+        shared->is_stopped = true;
+      }
+    }
+
+    const Board* original = solver->board;
+    for (size_t i = 0; i < chosen_rows.size(); i++) {
+      int row = chosen_rows[i];
+      for (int a = solver->assignment_offsets[row];
+           a < solver->assignment_offsets[row + 1];
+           a++) {
+        int square = solver->assignments[a].square;
+        board->set_value(square, original->get_value(square));
+      }
+    }
+    return is_running;
+  }
+
+  const ExactCoverSolver* const solver;
+  SharedRun* const shared;
+
+  std::vector<Node> nodes;
+  std::vector<int> column_sizes;
+  std::vector<int> chosen_rows;
+
+  // The board the solutions are written to, or NULL when only counting.
+  Board* board;
+
+  unsigned long long number_of_solutions;
+};
+
+ExactCoverSolver::ExactCoverSolver(const Board* const board,
+                                   int number_of_primary_columns,
+                                   int number_of_secondary_columns) :
+    board(board),
+    number_of_columns(number_of_primary_columns + number_of_secondary_columns),
+    nodes(number_of_columns + 1),
+    column_sizes(number_of_columns + 1, 0),
+    assignment_offsets(1, 0) {
+  // The primary columns are linked to the root; the secondary columns are
+  // linked only to themselves, so the search never branches on them.
+  for (int c = 0; c <= number_of_columns; c++) {
+    Node& header = nodes[c];
+    header.up = c;
+    header.down = c;
+    header.column = c;
+    header.row = -1;
+    if (c <= number_of_primary_columns) {
+      header.left = (c == 0) ? number_of_primary_columns : c - 1;
+      header.right = (c == number_of_primary_columns) ? 0 : c + 1;
+    } else {
+      header.left = c;
+      header.right = c;
+    }
+  }
+}
+
+ExactCoverSolver::~ExactCoverSolver() {
+}
+
+int ExactCoverSolver::add_row(const int* const columns,
+                              int number_of_columns,
+                              const ExactCoverAssignment* const assignments,
+                              int number_of_assignments) {
+  assert(number_of_columns > 0);
+
+  int row = row_first_nodes.size();
+  int first = nodes.size();
+  row_first_nodes.push_back(first);
+  for (int i = 0; i < number_of_columns; i++) {
+    assert(0 <= columns[i] && columns[i] < this->number_of_columns);
+
+    int c = columns[i] + 1;
+    Node node;
+    node.left = (i == 0) ? first + number_of_columns - 1 : first + i - 1;
+    node.right = (i == number_of_columns - 1) ? first : first + i + 1;
+    node.up = nodes[c].up;
+    node.down = c;
+    node.column = c;
+    node.row = row;
+
+    int index = nodes.size();
+    nodes[nodes[c].up].down = index;
+    nodes[c].up = index;
+    column_sizes[c]++;
+    nodes.push_back(node);
+  }
+
+  for (int i = 0; i < number_of_assignments; i++) {
+    assert(0 <= assignments[i].square &&
+           assignments[i].square < board->get_number_of_squares());
+    assert(0 <= assignments[i].state_index &&
+           assignments[i].state_index <
+               board->get_state_list()->get_number_of_states());
+    this->assignments.push_back(assignments[i]);
+  }
+  assignment_offsets.push_back(this->assignments.size());
+  return row;
+}
+
+unsigned long long ExactCoverSolver::count_solutions(
+    int number_of_threads) const {
+  return run(NULL, number_of_threads);
+}
+
+Board* ExactCoverSolver::find_solution() const {
+  FirstSolutionSink sink;
+  run(&sink, 1);
+  return sink.get_solution();
+}
+
+void ExactCoverSolver::find_all_solutions(SolutionSink* const sink,
+                                          int number_of_threads) const {
+  run(sink, number_of_threads);
+}
+
+unsigned long long ExactCoverSolver::run(SolutionSink* const sink,
+                                         int number_of_threads) const {
+  SharedRun shared;
+  shared.sink = sink;
+  shared.is_stopped = false;
+  shared.next_task = 0;
+
+  // Every thread starts from the same links, so they all branch on the same
+  // column first; its rows are the tasks.
+  Search first(this, &shared);
+  int c = first.choose_column();
+  if (c == ROOT) {
+    first.search();
+    return first.get_number_of_solutions();
+  }
+  std::vector<int> tasks;
+  for (int r = nodes[c].down; r != c; r = nodes[r].down) {
+    tasks.push_back(r);
+  }
+  if (number_of_threads <= 1 || tasks.size() <= 1) {
+    first.run_tasks(c, tasks);
+    return first.get_number_of_solutions();
+  }
+
+  std::vector<unsigned long long> counts(number_of_threads, 0);
+  std::vector<std::thread> threads;
+  for (int i = 1; i < number_of_threads; i++) {
+    threads.push_back(std::thread([this, i, c, &shared, &tasks, &counts]() {
+      Search search(this, &shared);
+      search.run_tasks(c, tasks);
+      counts[i] = search.get_number_of_solutions();
+    }));
+  }
+  first.run_tasks(c, tasks);
+  counts[0] = first.get_number_of_solutions();
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  unsigned long long number_of_solutions = 0;
+  for (int i = 0; i < number_of_threads; i++) {
+    number_of_solutions = saturating_add(number_of_solutions, counts[i]);
+  }
+  return number_of_solutions;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
@@ -0,0 +1,134 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Counts and finds solutions of exact cover problems with Knuth's Algorithm X,
+// using Dancing Links, for tiling and placement puzzles.
+//
+// The problem is a set of columns and a set of rows, each row covering some of
+// the columns. A solution picks rows so that every primary column is covered
+// exactly once, and every secondary column at most once. Each row also sets
+// some squares of a Board, e.g. the squares covered by a placed piece to the
+// state of that piece, and solutions are reported as boards, through the same
+// SolutionSink as the Board search.
+//
+// The links live in one flat array of nodes, addressed by index, rather than in
+// separately allocated nodes. The search always branches on the primary column
+// with the fewest rows left. The rows of the first such column can be searched
+// in parallel, each thread taking the next unsearched row and working on its
+// own copy of the links.
+// -----------------------------------------------------------------------------
+
+#ifndef _EXACT_COVER_SOLVER_H_
+#define _EXACT_COVER_SOLVER_H_
+
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+class SolutionSink;
+
+// A square set to the state with the given index when a row is picked.
+struct ExactCoverAssignment {
+  int square;
+  int state_index;
+};
+
+class ExactCoverSolver {
+ public:
+  // Columns [0, |number_of_primary_columns|) must be covered exactly once, and
+  // the next |number_of_secondary_columns| columns at most once. Solutions are
+  // copies of |board| with the squares of the picked rows set; the other
+  // squares keep their values from |board|. The board must outlive the
+  // solver.
+  ExactCoverSolver(const Board* const board,
+                   int number_of_primary_columns,
+                   int number_of_secondary_columns);
+  ~ExactCoverSolver();
+
+  // Adds a row covering the |number_of_columns| distinct columns of |columns|,
+  // and setting the squares of |assignments|. Returns the index of the row.
+  int add_row(const int* const columns,
+              int number_of_columns,
+              const ExactCoverAssignment* const assignments,
+              int number_of_assignments);
+
+  int get_number_of_rows() const {
+    return row_first_nodes.size();
+  }
+
+  // Returns the number of solutions, or ~0ull if there are at least that
+  // many.
+  unsigned long long count_solutions(int number_of_threads) const;
+
+  // Returns a board containing a solution, if it exists.
+  // Returns NULL if there is no solution.
+  // The caller is responsible for freeing the pointer, if it is non-NULL.
+  Board* find_solution() const;
+
+  // Passes every solution to |sink|, until the sink stops the search. The sink
+  // is called by one thread at a time, but with more than one thread the
+  // solutions come in no particular order.
+  void find_all_solutions(SolutionSink* const sink,
+                          int number_of_threads) const;
+
+ private:
+  class Search;
+
+  // A node of the links. The first nodes are the root, followed by the header
+  // of each column; the rest are the 1s of the rows, stored row by row.
+  struct Node {
+    int left;
+    int right;
+    int up;
+    int down;
+    int column;
+    int row;
+  };
+
+  static const int ROOT = 0;
+
+  // Searches with |number_of_threads| threads, passing the solutions to
+  // |sink| if it is non-NULL, and returns the number of solutions found.
+  unsigned long long run(SolutionSink* const sink,
+                         int number_of_threads) const;
+
+  const Board* const board;
+  const int number_of_columns;
+
+  std::vector<Node> nodes;
+
+  // The number of rows left in each column, indexed by header node.
+  std::vector<int> column_sizes;
+
+  // The first node of each row, and the assignments of each row, which are
+  // |assignments| from |assignment_offsets[row]| up to
+  // |assignment_offsets[row + 1]|.
+  std::vector<int> row_first_nodes;
+  std::vector<int> assignment_offsets;
+  std::vector<ExactCoverAssignment> assignments;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _EXACT_COVER_SOLVER_H_
@@ -0,0 +1,259 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/frontier_solver.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/state_list.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+namespace {
+
+// The frontier states of the active constraints, in the order of the active
+// constraints.
+typedef std::vector<FrontierState> FrontierKey;
+
+struct FrontierKeyHash {
+  size_t operator()(const FrontierKey& key) const {
+    unsigned long long hash = key.size();
+    for (size_t i = 0; i < key.size(); i++) {
+      hash ^= key[i] + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+struct FrontierEntry {
+  // The number of partial assignments with this frontier.
+  unsigned long long count;
+
+  // The last step of one of them.
+  int witness_step;
+};
+
+typedef std::unordered_map<FrontierKey, FrontierEntry, FrontierKeyHash>
+    Frontier;
+
+struct SweepWatch {
+  int constraint_index;
+  int scope_position;
+};
+
+unsigned long long saturating_add(unsigned long long a, unsigned long long b) {
+  return (a + b < a) ? ~0ull : a + b;
+}
+
+}  // namespace
+
+FrontierSolver::FrontierSolver(const Board* const board,
+                               const int* const sweep_order) :
+    board(board),
+    sweep_order(board->get_number_of_squares()),
+    has_swept(false),
+    number_of_solutions(0),
+    max_frontier_size(0),
+    solution_step(-1) {
+  const int* order =
+      (sweep_order == NULL) ? board->get_search_order() : sweep_order;
+  for (int i = 0; i < board->get_number_of_squares(); i++) {
+    this->sweep_order[i] = order[i];
+  }
+}
+
+FrontierSolver::~FrontierSolver() {
+}
+
+unsigned long long FrontierSolver::count_solutions() {
+  sweep();
+  return number_of_solutions;
+}
+
+Board* FrontierSolver::find_solution() {
+  sweep();
+  if (number_of_solutions == 0) {
+    return NULL;
+  }
+
+  const StateList* state_list = board->get_state_list();
+  Board* solution = new Board(board->get_number_of_squares(),
+                              state_list,
+                              board->get_search_order(),
+                              NULL);
+  for (int step = solution_step; step != -1;
+       step = witness_steps[step].parent) {
+    solution->set_value(witness_steps[step].square,
+                        state_list->get_state(witness_steps[step].state_index));
+  }
+  return solution;
+}
+
+size_t FrontierSolver::get_max_frontier_size() {
+  sweep();
+  return max_frontier_size;
+}
+
+void FrontierSolver::sweep() {
+  if (has_swept) {
+    return;
+  }
+  has_swept = true;
+
+  // Find the first and last step of the sweep at which each constraint sees
+  // one of its squares.
+  int number_of_squares = board->get_number_of_squares();
+  int number_of_constraints = board->get_number_of_constraints();
+  std::vector<int> step_of_square(number_of_squares);
+  for (int step = 0; step < number_of_squares; step++) {
+    step_of_square[sweep_order[step]] = step;
+  }
+  std::vector<int> first_step(number_of_constraints, number_of_squares);
+  std::vector<int> last_step(number_of_constraints, -1);
+  std::vector<std::vector<SweepWatch> > watches(number_of_squares);
+  for (int i = 0; i < number_of_constraints; i++) {
+    const Constraint* constraint = board->get_constraint(i);
+    assert(constraint->has_frontier_states());
+    for (int j = 0; j < constraint->get_scope_size(); j++) {
+      int step = step_of_square[constraint->get_scope(j)];
+      first_step[i] = std::min(first_step[i], step);
+      last_step[i] = std::max(last_step[i], step);
+      SweepWatch watch = {i, j};
+      watches[constraint->get_scope(j)].push_back(watch);
+    }
+  }
+
+  // The constraints in the keys of the frontier, and the position of each in
+  // the keys, or -1.
+  std::vector<int> active;
+  std::vector<int> position_in_key(number_of_constraints, -1);
+
+  // The frontier states of the constraints on the square being assigned.
+  std::vector<FrontierState> next_state(number_of_constraints);
+  std::vector<bool> is_on_square(number_of_constraints, false);
+
+  Frontier frontier;
+  FrontierEntry start = {1, -1};
+  frontier[FrontierKey()] = start;
+  max_frontier_size = 1;
+
+  for (int step = 0; step < number_of_squares && !frontier.empty(); step++) {
+    int square = sweep_order[step];
+    const std::vector<SweepWatch>& square_watches = watches[square];
+
+    std::vector<int> next_active;
+    for (size_t i = 0; i < active.size(); i++) {
+      if (last_step[active[i]] > step) {
+        next_active.push_back(active[i]);
+      }
+    }
+    for (size_t i = 0; i < square_watches.size(); i++) {
+      int constraint_index = square_watches[i].constraint_index;
+      is_on_square[constraint_index] = true;
+      if (first_step[constraint_index] == step &&
+          last_step[constraint_index] > step) {
+        next_active.push_back(constraint_index);
+      }
+    }
+
+    Frontier next_frontier;
+    FrontierKey next_key(next_active.size());
+    Domain domain = board->get_domain(square);
+    for (Frontier::const_iterator it = frontier.begin(); it != frontier.end();
+         ++it) {
+      const FrontierKey& key = it->first;
+      for (Domain rest = domain; rest != 0; rest &= rest - 1) {
+        int state_index = lowest_state(rest);
+
+        // Step the constraints on the square.
+        bool rejected = false;
+        for (size_t i = 0; i < square_watches.size() && !rejected; i++) {
+          int constraint_index = square_watches[i].constraint_index;
+          const Constraint* constraint =
+              board->get_constraint(constraint_index);
+          FrontierState state = (position_in_key[constraint_index] == -1) ?
+              constraint->get_initial_frontier_state() :
+              key[position_in_key[constraint_index]];
+          state = constraint->get_next_frontier_state(
+              state, square_watches[i].scope_position, state_index);
+          rejected = (state == REJECTED_FRONTIER_STATE) ||
+                     (last_step[constraint_index] == step &&
+                      !constraint->is_accepting_frontier_state(state));
+          next_state[constraint_index] = state;
+        }
+        if (rejected) {
+          continue;
+        }
+
+        for (size_t i = 0; i < next_active.size(); i++) {
+          int constraint_index = next_active[i];
+          next_key[i] = is_on_square[constraint_index] ?
+              next_state[constraint_index] :
+              key[position_in_key[constraint_index]];
+        }
+
+        FrontierEntry empty = {0, -1};
+        std::pair<Frontier::iterator, bool> inserted =
+            next_frontier.insert(std::make_pair(next_key, empty));
+        FrontierEntry& entry = inserted.first->second;
+        if (inserted.second) {
+          WitnessStep witness_step =
+              {it->second.witness_step, square, state_index};
+          entry.witness_step = witness_steps.size();
+          witness_steps.push_back(witness_step);
+        }
+        entry.count = saturating_add(entry.count, it->second.count);
+      }
+    }
+
+    for (size_t i = 0; i < square_watches.size(); i++) {
+      is_on_square[square_watches[i].constraint_index] = false;
+    }
+    for (size_t i = 0; i < active.size(); i++) {
+      position_in_key[active[i]] = -1;
+    }
+    for (size_t i = 0; i < next_active.size(); i++) {
+      position_in_key[next_active[i]] = i;
+    }
+    active.swap(next_active);
+    frontier.swap(next_frontier);
+    max_frontier_size = std::max(max_frontier_size, frontier.size());
+  }
+
+  // Every constraint has finished, so the frontier has at most the one entry.
+  assert(frontier.size() <= 1);
+  if (!frontier.empty()) {
+    number_of_solutions = frontier.begin()->second.count;
+    solution_step = frontier.begin()->second.witness_step;
+  }
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
@@ -0,0 +1,100 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Counts and finds solutions of a Board by sweeping over its squares once,
+// instead of searching.
+//
+// The sweep assigns the squares in a fixed order, and after each square keeps
+// the frontier: the distinct combinations of frontier states of the
+// constraints that have been started but not finished, each with the number of
+// partial assignments that lead to it and one such assignment. Partial
+// assignments with the same frontier behave the same on the rest of the
+// board, so for constraints with a bounded number of frontier states the
+// work grows with the size of the board times the size of the frontier, rather
+// than exponentially in the size of the board.
+//
+// Every constraint of the board must have frontier states. The validator of
+// the board is not checked, so every rule of the puzzle must be a constraint.
+// -----------------------------------------------------------------------------
+
+#ifndef _FRONTIER_SOLVER_H_
+#define _FRONTIER_SOLVER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "include/brute_force_solver/constraint.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+class FrontierSolver {
+ public:
+  // Sweeps the squares of |board| in |sweep_order|, or in the search order of
+  // the board if |sweep_order| is NULL. The squares keep their domains on
+  // |board|. The board must outlive the solver.
+  FrontierSolver(const Board* const board, const int* const sweep_order);
+  ~FrontierSolver();
+
+  // Returns the number of solutions, or ~0ull if there are at least that
+  // many.
+  unsigned long long count_solutions();
+
+  // Returns a board containing a solution, if it exists.
+  // Returns NULL if there is no solution.
+  // The caller is responsible for freeing the pointer, if it is non-NULL.
+  Board* find_solution();
+
+  // The largest number of frontier entries kept after any square.
+  size_t get_max_frontier_size();
+
+ private:
+  // One step of the partial assignment of a frontier entry: the square was
+  // assigned |state_index|, after the assignment at |parent|.
+  struct WitnessStep {
+    int parent;
+    int square;
+    int state_index;
+  };
+
+  // Runs the sweep, if it has not run yet.
+  void sweep();
+
+  const Board* const board;
+  std::vector<int> sweep_order;
+
+  bool has_swept;
+  unsigned long long number_of_solutions;
+  size_t max_frontier_size;
+
+  // The partial assignments of the frontier entries, and the last step of
+  // the solution, or -1.
+  std::vector<WitnessStep> witness_steps;
+  int solution_step;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _FRONTIER_SOLVER_H_
@@ -0,0 +1,262 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/line_constraint.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/cnf_encoder.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+LineConstraint::LineConstraint(const BinaryCell* const cells,
+                               int number_of_cells,
+                               int target,
+                               const LineThermometer* const thermometers,
+                               int number_of_thermometers) :
+    BinaryCellConstraint(cells, number_of_cells),
+    target(target),
+    free_cells(0) {
+  assert(number_of_cells <= 32);
+  assert(target <= number_of_cells);
+
+  // The thermometer that covers each cell, or -1.
+  std::vector<int> thermometer_of(number_of_cells, -1);
+  for (int i = 0; i < number_of_thermometers; i++) {
+    int step = (thermometers[i].tip >= thermometers[i].bulb) ? 1 : -1;
+    for (int cell = thermometers[i].bulb; ; cell += step) {
+      assert(thermometer_of[cell] == -1);
+      thermometer_of[cell] = i;
+      if (cell == thermometers[i].tip) {
+        break;
+      }
+    }
+  }
+
+  for (int cell = 0; cell < number_of_cells; cell++) {
+    int thermometer = thermometer_of[cell];
+    if (thermometer == -1) {
+      free_cells |= 1u << cell;
+      segment_cells.push_back(1u << cell);
+      segment_fillings.push_back(std::vector<unsigned int>(1, 0));
+      segment_fillings.back().push_back(1u << cell);
+    } else if (cell == std::min(thermometers[thermometer].bulb,
+                                thermometers[thermometer].tip)) {
+      // Add each thermometer at the first of its cells in line order.
+      int step = (thermometers[thermometer].tip >=
+                  thermometers[thermometer].bulb) ? 1 : -1;
+      std::vector<unsigned int> fillings(1, 0);
+      for (int i = thermometers[thermometer].bulb; ; i += step) {
+        fillings.push_back(fillings.back() | (1u << i));
+        if (i == thermometers[thermometer].tip) {
+          break;
+        }
+      }
+      segment_cells.push_back(fillings.back());
+      segment_fillings.push_back(fillings);
+    }
+  }
+}
+
+LineConstraint::~LineConstraint() {
+}
+
+bool LineConstraint::propagate(Board* const board,
+                               const int* const counters) const {
+  unsigned int filled = counters[0];
+  unsigned int unfilled = counters[1];
+  LineResult result = solve_cached(filled, unfilled);
+  if (!is_feasible(result)) {
+    return false;
+  }
+  for (int i = 0; i < get_number_of_cells(); i++) {
+    unsigned int bit = 1u << i;
+    if ((filled | unfilled) & bit) {
+      continue;
+    }
+    if (!(result.can_be_unfilled & bit) && !force_filled(board, i)) {
+      return false;
+    }
+    if (!(result.can_be_filled & bit) && !force_unfilled(board, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void LineConstraint::update_counters(int scope_position,
+                                     Domain old_domain,
+                                     Domain new_domain,
+                                     int* const counters) const {
+  update_cell_masks(scope_position, old_domain, new_domain, counters);
+}
+
+int LineConstraint::count_violations(const int* const state_indices) const {
+  unsigned int filled = 0;
+  for (int i = 0; i < get_number_of_cells(); i++) {
+    if (is_filled_in(i, state_indices)) {
+      filled |= 1u << i;
+    }
+  }
+
+  int violations = 0;
+  if (target != NO_TARGET) {
+    violations += abs(__builtin_popcount(filled) - target);
+  }
+  for (size_t s = 0; s < segment_fillings.size(); s++) {
+    // The filled cells of the segment beyond its longest filled run from the
+    // bulb.
+    int longest_run = 0;
+    while (longest_run + 1 < static_cast<int>(segment_fillings[s].size()) &&
+           (segment_fillings[s][longest_run + 1] & ~filled) == 0) {
+      longest_run++;
+    }
+    violations += __builtin_popcount(filled & segment_cells[s]) - longest_run;
+  }
+  return violations;
+}
+
+bool LineConstraint::add_clauses(CnfEncoder* const encoder) const {
+  std::vector<int> literals;
+  for (int i = 0; i < get_number_of_cells(); i++) {
+    literals.push_back(get_cell_literal(i, encoder));
+  }
+  if (target != NO_TARGET) {
+    encoder->get_formula()->add_exactly(literals, target);
+  }
+
+  // The fillings of a segment add one cell at a time from the bulb.
+  for (size_t s = 0; s < segment_fillings.size(); s++) {
+    for (size_t k = 2; k < segment_fillings[s].size(); k++) {
+      int below = __builtin_ctz(segment_fillings[s][k - 1] &
+                                ~segment_fillings[s][k - 2]);
+      int above = __builtin_ctz(segment_fillings[s][k] &
+                                ~segment_fillings[s][k - 1]);
+      encoder->get_formula()->add_binary(-literals[above], literals[below]);
+    }
+  }
+  return true;
+}
+
+FrontierState LineConstraint::get_next_frontier_state(
+    FrontierState frontier_state, int scope_position, int state_index) const {
+  unsigned int filled = frontier_state >> 32;
+  unsigned int unfilled = frontier_state & 0xffffffffu;
+  const std::vector<int>& cells = get_cells_at(scope_position);
+  for (size_t i = 0; i < cells.size(); i++) {
+    if (is_filled_by(cells[i], state_index)) {
+      filled |= 1u << cells[i];
+    } else {
+      unfilled |= 1u << cells[i];
+    }
+  }
+
+  // Move the filled free cells to the lowest free cells seen.
+  unsigned int seen_free = (filled | unfilled) & free_cells;
+  int number_filled_free = __builtin_popcount(filled & free_cells);
+  filled &= ~free_cells;
+  for (int i = 0; i < number_filled_free; i++) {
+    filled |= seen_free & -seen_free;
+    seen_free &= seen_free - 1;
+  }
+  unfilled = (unfilled & ~free_cells) | seen_free;
+
+  if (!is_feasible(solve_cached(filled, unfilled))) {
+    return REJECTED_FRONTIER_STATE;
+  }
+  return (static_cast<FrontierState>(filled) << 32) | unfilled;
+}
+
+LineConstraint::LineResult LineConstraint::solve_cached(
+    unsigned int filled, unsigned int unfilled) const {
+  unsigned long long key =
+      (static_cast<unsigned long long>(filled) << 32) | unfilled;
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    std::unordered_map<unsigned long long, LineResult>::const_iterator it =
+        cache.find(key);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+
+  LineResult result = solve(filled, unfilled);
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (cache.size() >= MAX_CACHE_SIZE) {
+    cache.clear();
+  }
+  cache[key] = result;
+  return result;
+}
+
+LineConstraint::LineResult LineConstraint::solve(unsigned int filled,
+                                                 unsigned int unfilled) const {
+  // reachable[s] has bit c set if the segments before s can have c filled
+  // cells, and completable[s] has bit c set if the segments from s onward
+  // can be filled so that the line reaches its target from c.
+  int number_of_segments = segment_cells.size();
+  std::vector<unsigned long long> reachable(number_of_segments + 1, 0);
+  std::vector<unsigned long long> completable(number_of_segments + 1, 0);
+
+  reachable[0] = 1;
+  for (int s = 0; s < number_of_segments; s++) {
+    for (size_t k = 0; k < segment_fillings[s].size(); k++) {
+      unsigned int filling = segment_fillings[s][k];
+      if (!(filling & unfilled) && !(segment_cells[s] & ~filling & filled)) {
+        reachable[s + 1] |= reachable[s] << k;
+      }
+    }
+  }
+
+  completable[number_of_segments] =
+      (target == NO_TARGET) ? ~0ull : (1ull << target);
+  for (int s = number_of_segments - 1; s >= 0; s--) {
+    for (size_t k = 0; k < segment_fillings[s].size(); k++) {
+      unsigned int filling = segment_fillings[s][k];
+      if (!(filling & unfilled) && !(segment_cells[s] & ~filling & filled)) {
+        completable[s] |= completable[s + 1] >> k;
+      }
+    }
+  }
+
+  LineResult result = {0, 0};
+  if (!(reachable[0] & completable[0])) {
+    return result;
+  }
+  for (int s = 0; s < number_of_segments; s++) {
+    for (size_t k = 0; k < segment_fillings[s].size(); k++) {
+      unsigned int filling = segment_fillings[s][k];
+      if (!(filling & unfilled) && !(segment_cells[s] & ~filling & filled) &&
+          (reachable[s] & (completable[s + 1] >> k))) {
+        result.can_be_filled |= filling;
+        result.can_be_unfilled |= segment_cells[s] & ~filling;
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
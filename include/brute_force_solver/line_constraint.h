@@ -0,0 +1,141 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// An exact solver for one row or column of two-valued cells.
+//
+// A line may have a count of filled cells and may hold thermometers that lie
+// along it. Given the cells that are already known, the solver finds every
+// filling of the line that satisfies both, and forces the cells that are the
+// same in all of them. Line solvers run whenever a cell of the line changes, so
+// repeated line solving over the rows and columns reaches a fixpoint before
+// the search picks the next square.
+// -----------------------------------------------------------------------------
+
+#ifndef _LINE_CONSTRAINT_H_
+#define _LINE_CONSTRAINT_H_
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "include/brute_force_solver/binary_constraints.h"
+#include "include/brute_force_solver/domain.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+// A thermometer along a line, from the cell at position |bulb| of the line to
+// the cell at position |tip|. The bulb may be at either end.
+struct LineThermometer {
+  int bulb;
+  int tip;
+};
+
+// The cells are listed in line order, and a line has at most 32 cells. With a
+// |target| of NO_TARGET the line has no count, and only its thermometers
+// constrain it.
+class LineConstraint : public BinaryCellConstraint {
+ public:
+  static const int NO_TARGET = -1;
+
+  // The |cells| and |thermometers| arrays are copied. The thermometers must
+  // not overlap.
+  LineConstraint(const BinaryCell* const cells,
+                 int number_of_cells,
+                 int target,
+                 const LineThermometer* const thermometers,
+                 int number_of_thermometers);
+  virtual ~LineConstraint();
+
+  virtual bool propagate(Board* const board, const int* const counters) const;
+
+  // The bitmasks of the cells that are known to be filled, and unfilled.
+  virtual int get_number_of_counters() const {
+    return 2;
+  }
+
+  virtual void update_counters(int scope_position,
+                               Domain old_domain,
+                               Domain new_domain,
+                               int* const counters) const;
+
+  // How far the number of filled cells is from the target, plus the number
+  // of filled cells above an unfilled cell in some thermometer.
+  virtual int count_violations(const int* const state_indices) const;
+
+  // A cardinality constraint on the cells, and a chain of implications along
+  // each thermometer.
+  virtual bool add_clauses(CnfEncoder* const encoder) const;
+
+  // The frontier state is the known unfilled cells in the low 32 bits and the
+  // known filled cells in the high 32 bits. Cells outside the thermometers
+  // only matter through their number, so their filled ones are moved to the
+  // lowest of the cells seen, which keeps the number of frontier states down.
+  virtual bool has_frontier_states() const {
+    return true;
+  }
+
+  virtual FrontierState get_next_frontier_state(FrontierState frontier_state,
+                                                int scope_position,
+                                                int state_index) const;
+
+ private:
+  // The cells that can be filled, and that can be unfilled, in some filling
+  // of the line. Both are zero if the line has no filling.
+  struct LineResult {
+    unsigned int can_be_filled;
+    unsigned int can_be_unfilled;
+  };
+
+  // Runs the line solver for the given known cells, or looks up the result
+  // in the cache.
+  LineResult solve_cached(unsigned int filled, unsigned int unfilled) const;
+  LineResult solve(unsigned int filled, unsigned int unfilled) const;
+
+  static bool is_feasible(const LineResult& result) {
+    return result.can_be_filled != 0 || result.can_be_unfilled != 0;
+  }
+
+  const int target;
+
+  // The line is split into segments: each thermometer is a segment, and so is
+  // each cell outside a thermometer. A segment with k filled cells has the
+  // filling segment_fillings[segment][k].
+  std::vector<unsigned int> segment_cells;
+  std::vector<std::vector<unsigned int> > segment_fillings;
+
+  // The cells outside the thermometers.
+  unsigned int free_cells;
+
+  // Solved lines, keyed by the known filled and unfilled cells. The cache is
+  // shared by every board the constraint is added to, so it is guarded by a
+  // mutex, and it is cleared when it grows past MAX_CACHE_SIZE.
+  static const size_t MAX_CACHE_SIZE = 1 << 16;
+  mutable std::unordered_map<unsigned long long, LineResult> cache;
+  mutable std::mutex cache_mutex;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _LINE_CONSTRAINT_H_
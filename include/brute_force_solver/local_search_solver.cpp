@@ -0,0 +1,304 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/local_search_solver.h"
+
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/state_list.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+namespace {
+
+// The walkers check the clock every this many steps.
+const int STEPS_PER_CLOCK_CHECK = 1024;
+
+bool is_past(const timespec& deadline) {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec > deadline.tv_sec) ||
+         (now.tv_sec == deadline.tv_sec && now.tv_nsec >= deadline.tv_nsec);
+}
+
+}  // namespace
+
+class LocalSearchSolver::Walker {
+ public:
+  Walker(LocalSearchSolver* const solver, unsigned int seed) :
+      solver(solver),
+      board(solver->board),
+      random(seed),
+      assignment(board->get_number_of_squares()),
+      violations(board->get_number_of_constraints()),
+      position_in_violated(board->get_number_of_constraints(), -1) {
+  }
+
+  void run(const timespec& deadline) {
+    restart();
+    int best_violations = INT_MAX;
+    int steps_since_improvement = 0;
+    for (int step = 0; ; step++) {
+      if (total_violations < best_violations) {
+        best_violations = total_violations;
+        steps_since_improvement = 0;
+        solver->report(assignment, total_violations);
+        if (total_violations == 0) {
+          solver->is_solved = true;
+          return;
+        }
+      } else if (++steps_since_improvement > solver->restart_interval) {
+        restart();
+        best_violations = INT_MAX;
+        continue;
+      }
+      if (step % STEPS_PER_CLOCK_CHECK == 0 &&
+          (solver->is_solved || is_past(deadline))) {
+        return;
+      }
+
+      // Pick a violated constraint, and a square of it that can change.
+      const Constraint* constraint = board->get_constraint(
+          violated[uniform(violated.size())]);
+      open_squares.clear();
+      for (int i = 0; i < constraint->get_scope_size(); i++) {
+        if (domain_size(board->get_domain(constraint->get_scope(i))) > 1) {
+          open_squares.push_back(constraint->get_scope(i));
+        }
+      }
+      if (open_squares.empty()) {
+        continue;
+      }
+      int square = open_squares[uniform(open_squares.size())];
+
+      int state_index;
+      int added;
+      if (probability(random) < solver->noise) {
+        state_index = random_state(board->get_domain(square));
+        added = count_added_violations(square, state_index);
+      } else {
+        choose_min_conflicts_state(square, &state_index, &added);
+      }
+      if (added <= 0 ||
+          probability(random) < exp(-added / temperature)) {
+        move(square, state_index);
+      }
+      temperature *= solver->cooling;
+    }
+  }
+
+ private:
+  // Starts again from a random assignment.
+  void restart() {
+    for (int i = 0; i < board->get_number_of_squares(); i++) {
+      assignment[i] = random_state(board->get_domain(i));
+    }
+    violated.clear();
+    total_violations = 0;
+    for (int i = 0; i < board->get_number_of_constraints(); i++) {
+      position_in_violated[i] = -1;
+      violations[i] = 0;
+      set_violations(
+          i, board->get_constraint(i)->count_violations(assignment.data()));
+    }
+    temperature = solver->initial_temperature;
+  }
+
+  // Returns the change in total violations if |square| took the state
+  // |state_index|.
+  int count_added_violations(int square, int state_index) {
+    int old_state_index = assignment[square];
+    assignment[square] = state_index;
+    int added = 0;
+    const std::vector<int>& constraints = solver->constraints_of_square[square];
+    for (size_t i = 0; i < constraints.size(); i++) {
+      added += board->get_constraint(constraints[i])->count_violations(
+                   assignment.data()) -
+               violations[constraints[i]];
+    }
+    assignment[square] = old_state_index;
+    return added;
+  }
+
+  // Finds the state other than the current one that adds the fewest
+  // violations, breaking ties at random.
+  void choose_min_conflicts_state(int square, int* state_index, int* added) {
+    int number_of_ties = 0;
+    *added = INT_MAX;
+    *state_index = assignment[square];
+    for (Domain rest = board->get_domain(square); rest != 0; rest &= rest - 1) {
+      int candidate = lowest_state(rest);
+      if (candidate == assignment[square]) {
+        continue;
+      }
+      int candidate_added = count_added_violations(square, candidate);
+      if (candidate_added < *added) {
+        *added = candidate_added;
+        *state_index = candidate;
+        number_of_ties = 1;
+      } else if (candidate_added == *added &&
+                 uniform(++number_of_ties) == 0) {
+        *state_index = candidate;
+      }
+    }
+  }
+
+  void move(int square, int state_index) {
+    assignment[square] = state_index;
+    const std::vector<int>& constraints = solver->constraints_of_square[square];
+    for (size_t i = 0; i < constraints.size(); i++) {
+      set_violations(constraints[i],
+                     board->get_constraint(constraints[i])->count_violations(
+                         assignment.data()));
+    }
+  }
+
+  // Updates the violations of a constraint, keeping |violated| in step.
+  void set_violations(int constraint_index, int new_violations) {
+    total_violations += new_violations - violations[constraint_index];
+    violations[constraint_index] = new_violations;
+    int position = position_in_violated[constraint_index];
+    if (new_violations > 0 && position == -1) {
+      position_in_violated[constraint_index] = violated.size();
+      violated.push_back(constraint_index);
+    } else if (new_violations == 0 && position != -1) {
+      violated[position] = violated.back();
+      position_in_violated[violated[position]] = position;
+      violated.pop_back();
+      position_in_violated[constraint_index] = -1;
+    }
+  }
+
+  int random_state(Domain domain) {
+    for (int skip = uniform(domain_size(domain)); skip > 0; skip--) {
+      domain &= domain - 1;
+    }
+    return lowest_state(domain);
+  }
+
+  // Returns a random integer in [0, n).
+  int uniform(int n) {
+    return std::uniform_int_distribution<int>(0, n - 1)(random);
+  }
+
+  LocalSearchSolver* const solver;
+  const Board* const board;
+  std::mt19937 random;
+  std::uniform_real_distribution<double> probability;
+
+  std::vector<int> assignment;
+  std::vector<int> violations;
+  int total_violations;
+  double temperature;
+
+  // The constraints with violations, and the position of each constraint in
+  // |violated|, or -1.
+  std::vector<int> violated;
+  std::vector<int> position_in_violated;
+
+  std::vector<int> open_squares;
+};
+
+LocalSearchSolver::LocalSearchSolver(const Board* const board,
+                                     unsigned int seed) :
+    board(board),
+    seed(seed),
+    noise(0.1),
+    initial_temperature(1.0),
+    cooling(0.9999),
+    restart_interval(10000),
+    constraints_of_square(board->get_number_of_squares()),
+    is_solved(false),
+    best_violations(INT_MAX) {
+  for (int i = 0; i < board->get_number_of_constraints(); i++) {
+    const Constraint* constraint = board->get_constraint(i);
+    for (int j = 0; j < constraint->get_scope_size(); j++) {
+      constraints_of_square[constraint->get_scope(j)].push_back(i);
+    }
+  }
+}
+
+LocalSearchSolver::~LocalSearchSolver() {
+}
+
+Board* LocalSearchSolver::find_best_assignment(int number_of_walkers,
+                                               double time_budget) {
+  if (number_of_walkers < 1) {
+    return NULL;
+  }
+  for (int i = 0; i < board->get_number_of_squares(); i++) {
+    if (board->get_domain(i) == 0) {
+      return NULL;
+    }
+  }
+
+  timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  long long nanoseconds =
+      deadline.tv_nsec + static_cast<long long>(time_budget * 1e9);
+  deadline.tv_sec += nanoseconds / 1000000000;
+  deadline.tv_nsec = nanoseconds % 1000000000;
+
+  is_solved = false;
+  best_violations = INT_MAX;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < number_of_walkers; i++) {
+    threads.push_back(std::thread([this, i, &deadline]() {
+      Walker walker(this, seed + i);
+      walker.run(deadline);
+    }));
+  }
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  const StateList* state_list = board->get_state_list();
+  Board* best = new Board(board->get_number_of_squares(),
+                          state_list,
+                          board->get_search_order(),
+                          NULL);
+  for (int i = 0; i < board->get_number_of_squares(); i++) {
+    best->set_value(i, state_list->get_state(best_assignment[i]));
+  }
+  return best;
+}
+
+void LocalSearchSolver::report(const std::vector<int>& assignment,
+                               int violations) {
+  std::lock_guard<std::mutex> lock(best_mutex);
+  if (violations < best_violations) {
+    best_violations = violations;
+    best_assignment = assignment;
+  }
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
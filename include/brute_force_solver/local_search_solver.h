@@ -0,0 +1,111 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Searches for a solution of a Board by local search over complete
+// assignments, for boards too large for the exhaustive search.
+//
+// Each walker starts from a random assignment that respects the domains of the
+// board, and repeatedly picks a violated constraint and a square in its
+// scope, and moves the square to the state with the fewest violations
+// (min-conflicts). With probability |noise| it tries a random state instead.
+// Moves that add violations are accepted with probability
+// exp(-added / temperature), as in simulated annealing, and the temperature
+// cools with every step. A walker that has not improved on its best
+// assignment for |restart_interval| steps restarts from a new random
+// assignment.
+//
+// Walkers run independently, one per thread, until one finds an assignment
+// with no violations or the time budget runs out. The constraints report
+// their violations with Constraint::count_violations(); the validator of the
+// board is not checked.
+// -----------------------------------------------------------------------------
+
+#ifndef _LOCAL_SEARCH_SOLVER_H_
+#define _LOCAL_SEARCH_SOLVER_H_
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+class LocalSearchSolver {
+ public:
+  // The board must outlive the solver. Walker i uses the random seed
+  // |seed| + i.
+  LocalSearchSolver(const Board* const board, unsigned int seed);
+  ~LocalSearchSolver();
+
+  void set_noise(double noise) {
+    this->noise = noise;
+  }
+
+  void set_temperature(double initial_temperature, double cooling) {
+    this->initial_temperature = initial_temperature;
+    this->cooling = cooling;
+  }
+
+  void set_restart_interval(int restart_interval) {
+    this->restart_interval = restart_interval;
+  }
+
+  // Runs |number_of_walkers| walkers for at most |time_budget| seconds.
+  // Returns a board with the best assignment found, which is a solution if
+  // get_best_violations() is 0, or NULL if |number_of_walkers| is less than 1
+  // or some square has an empty domain.
+  // The caller is responsible for freeing the pointer, if it is non-NULL.
+  Board* find_best_assignment(int number_of_walkers, double time_budget);
+
+  // The total violations of the best assignment of the last run.
+  int get_best_violations() const {
+    return best_violations;
+  }
+
+ private:
+  class Walker;
+
+  // Takes |assignment| as the best one if it has fewer violations.
+  void report(const std::vector<int>& assignment, int violations);
+
+  const Board* const board;
+  const unsigned int seed;
+
+  double noise;
+  double initial_temperature;
+  double cooling;
+  int restart_interval;
+
+  // For each square, the indices of the constraints on it.
+  std::vector<std::vector<int> > constraints_of_square;
+
+  std::atomic<bool> is_solved;
+  std::mutex best_mutex;
+  std::vector<int> best_assignment;
+  int best_violations;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _LOCAL_SEARCH_SOLVER_H_
@@ -0,0 +1,377 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/meet_in_the_middle_solver.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/solution_sink.h"
+#include "include/brute_force_solver/spill_buffer.h"
+#include "include/brute_force_solver/state_list.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+namespace {
+
+unsigned long long saturating_add(unsigned long long a, unsigned long long b) {
+  return (a + b < a) ? ~0ull : a + b;
+}
+
+unsigned long long saturating_multiply(unsigned long long a,
+                                       unsigned long long b) {
+  return (b != 0 && a > ~0ull / b) ? ~0ull : a * b;
+}
+
+}  // namespace
+
+// The records of a half with the same signature: how many there are, and the
+// index of the first, which stands for all of them in find_solution().
+struct MeetInTheMiddleSolver::Group {
+  unsigned long long count;
+  size_t first_record;
+};
+
+// Stores the solutions of one half as records, and counts them by signature.
+class MeetInTheMiddleSolver::HalfSink : public SolutionSink {
+ public:
+  HalfSink(const MeetInTheMiddleSolver* const solver,
+           int half_index,
+           Groups* const groups) :
+      solver(solver),
+      half(solver->halves[half_index]),
+      is_first(half_index == 0),
+      groups(groups),
+      record(half.signature_size + half.squares.size()),
+      failed(false) {
+  }
+
+  virtual bool add_solution(const Board* const board) {
+    if (is_first) {
+      for (size_t i = 0; i < solver->spanning_constraints.size(); i++) {
+        FrontierState state = solver->get_first_half_state(i, board);
+        if (state == REJECTED_FRONTIER_STATE) {
+          return true;
+        }
+        memcpy(&record[i * sizeof(state)], &state, sizeof(state));
+      }
+    } else {
+      for (size_t i = 0; i < half.boundary_squares.size(); i++) {
+        record[i] = board->get_state_index(half.boundary_squares[i]);
+      }
+    }
+    for (size_t i = 0; i < half.squares.size(); i++) {
+      record[half.signature_size + i] =
+          board->get_state_index(half.squares[i]);
+    }
+
+    if (!half.records->append(record.data())) {
+      failed = true;
+      return false;
+    }
+    Group group = {0, half.records->size() - 1};
+    std::pair<Groups::iterator, bool> inserted = groups->insert(
+        std::make_pair(std::string(reinterpret_cast<const char*>(record.data()),
+                                   half.signature_size),
+                       group));
+    inserted.first->second.count++;
+    return true;
+  }
+
+  bool has_failed() const {
+    return failed;
+  }
+
+ private:
+  const MeetInTheMiddleSolver* const solver;
+  const Half& half;
+  const bool is_first;
+  Groups* const groups;
+  std::vector<unsigned char> record;
+  bool failed;
+};
+
+MeetInTheMiddleSolver::MeetInTheMiddleSolver(
+    const Board* const board,
+    const int* const first_half,
+    int first_half_size,
+    size_t memory_cap,
+    const char* const spill_directory) :
+    board(board),
+    has_joined(false),
+    failed(false),
+    number_of_solutions(0) {
+  int number_of_squares = board->get_number_of_squares();
+  std::vector<bool> is_first(number_of_squares, false);
+  for (int i = 0; i < first_half_size; i++) {
+    is_first[first_half[i]] = true;
+  }
+  for (int i = 0; i < number_of_squares; i++) {
+    halves[is_first[i] ? 0 : 1].squares.push_back(i);
+  }
+
+  // Find the spanning constraints, and what they read from the second half.
+  std::vector<int> boundary_index(number_of_squares, -1);
+  for (int i = 0; i < board->get_number_of_constraints(); i++) {
+    const Constraint* constraint = board->get_constraint(i);
+    std::vector<int> first_positions;
+    std::vector<int> second_positions;
+    for (int j = 0; j < constraint->get_scope_size(); j++) {
+      if (is_first[constraint->get_scope(j)]) {
+        first_positions.push_back(j);
+      } else {
+        second_positions.push_back(j);
+      }
+    }
+    if (first_positions.empty() || second_positions.empty()) {
+      continue;
+    }
+
+    assert(constraint->has_frontier_states());
+    spanning_constraints.push_back(constraint);
+    first_half_positions.push_back(first_positions);
+    second_half_reads.push_back(std::vector<BoundaryRead>());
+    for (size_t j = 0; j < second_positions.size(); j++) {
+      int square = constraint->get_scope(second_positions[j]);
+      if (boundary_index[square] == -1) {
+        boundary_index[square] = halves[1].boundary_squares.size();
+        halves[1].boundary_squares.push_back(square);
+      }
+      BoundaryRead read = {second_positions[j], boundary_index[square]};
+      second_half_reads.back().push_back(read);
+    }
+  }
+
+  halves[0].signature_size =
+      spanning_constraints.size() * sizeof(FrontierState);
+  halves[1].signature_size = halves[1].boundary_squares.size();
+  for (int half = 0; half < 2; half++) {
+    halves[half].records = new SpillBuffer(
+        halves[half].signature_size + halves[half].squares.size(),
+        memory_cap / 2,
+        spill_directory);
+  }
+}
+
+MeetInTheMiddleSolver::~MeetInTheMiddleSolver() {
+  delete halves[0].records;
+  delete halves[1].records;
+}
+
+unsigned long long MeetInTheMiddleSolver::count_solutions() {
+  join();
+  return number_of_solutions;
+}
+
+Board* MeetInTheMiddleSolver::find_solution() {
+  join();
+  if (number_of_solutions == 0) {
+    return NULL;
+  }
+
+  const StateList* state_list = board->get_state_list();
+  Board* solution = new Board(board->get_number_of_squares(),
+                              state_list,
+                              board->get_search_order(),
+                              NULL);
+  for (int half = 0; half < 2; half++) {
+    const unsigned char* record =
+        halves[half].records->get(solution_records[half]) +
+        halves[half].signature_size;
+    for (size_t i = 0; i < halves[half].squares.size(); i++) {
+      solution->set_value(halves[half].squares[i],
+                          state_list->get_state(record[i]));
+    }
+  }
+  return solution;
+}
+
+FrontierState MeetInTheMiddleSolver::get_first_half_state(
+    int i, const Board* const board) const {
+  const Constraint* constraint = spanning_constraints[i];
+  FrontierState state = constraint->get_initial_frontier_state();
+  for (size_t j = 0;
+       j < first_half_positions[i].size() && state != REJECTED_FRONTIER_STATE;
+       j++) {
+    int position = first_half_positions[i][j];
+    state = constraint->get_next_frontier_state(
+        state,
+        position,
+        board->get_state_index(constraint->get_scope(position)));
+  }
+  return state;
+}
+
+void MeetInTheMiddleSolver::join() {
+  if (has_joined) {
+    return;
+  }
+  has_joined = true;
+
+  Groups groups[2];
+  for (int half = 0; half < 2 && !failed; half++) {
+    HalfSink sink(this, half, &groups[half]);
+    board->find_all_solutions(halves[half].squares.data(),
+                              halves[half].squares.size(),
+                              &sink);
+    failed = sink.has_failed();
+  }
+
+  // The distinct frontier states of each spanning constraint after the first
+  // half.
+  size_t number_of_constraints = spanning_constraints.size();
+  std::vector<std::vector<FrontierState> > first_states(number_of_constraints);
+  std::vector<std::unordered_set<FrontierState> > is_seen(
+      number_of_constraints);
+  for (Groups::const_iterator first = groups[0].begin();
+       first != groups[0].end();
+       ++first) {
+    for (size_t i = 0; i < number_of_constraints; i++) {
+      FrontierState state = get_signature_state(first->first, i);
+      if (is_seen[i].insert(state).second) {
+        first_states[i].push_back(state);
+      }
+    }
+  }
+
+  // The first half states that each spanning constraint accepts, sorted, by
+  // the values it reads from the second half. Each state runs over each
+  // distinct set of values once.
+  std::vector<std::unordered_map<std::string, std::vector<FrontierState> > >
+      accepted(number_of_constraints);
+  std::vector<const std::vector<FrontierState>*> candidates(
+      number_of_constraints);
+  std::vector<size_t> choices(number_of_constraints);
+  std::string key(halves[0].signature_size, '\0');
+  for (Groups::const_iterator second = groups[1].begin();
+       second != groups[1].end();
+       ++second) {
+    const unsigned char* boundary =
+        reinterpret_cast<const unsigned char*>(second->first.data());
+    unsigned long long number_of_keys = 1;
+    for (size_t i = 0; i < number_of_constraints; i++) {
+      std::string values;
+      for (size_t j = 0; j < second_half_reads[i].size(); j++) {
+        values.push_back(boundary[second_half_reads[i][j].boundary_index]);
+      }
+      std::unordered_map<std::string, std::vector<FrontierState> >::iterator
+          it = accepted[i].find(values);
+      if (it == accepted[i].end()) {
+        std::vector<FrontierState> states;
+        for (size_t j = 0; j < first_states[i].size(); j++) {
+          if (accepts(i, first_states[i][j], boundary)) {
+            states.push_back(first_states[i][j]);
+          }
+        }
+        std::sort(states.begin(), states.end());
+        it = accepted[i].insert(std::make_pair(values, states)).first;
+      }
+      candidates[i] = &it->second;
+      number_of_keys = saturating_multiply(number_of_keys, it->second.size());
+    }
+    if (number_of_keys == 0) {
+      continue;
+    }
+
+    if (number_of_keys <= groups[0].size()) {
+      // Look up every signature that the second half accepts.
+      std::fill(choices.begin(), choices.end(), 0);
+      while (true) {
+        for (size_t i = 0; i < number_of_constraints; i++) {
+          FrontierState state = (*candidates[i])[choices[i]];
+          memcpy(&key[i * sizeof(state)], &state, sizeof(state));
+        }
+        Groups::const_iterator first = groups[0].find(key);
+        if (first != groups[0].end()) {
+          add_match(first->second, second->second);
+        }
+        size_t i = 0;
+        while (i < number_of_constraints &&
+               ++choices[i] == candidates[i]->size()) {
+          choices[i] = 0;
+          i++;
+        }
+        if (i == number_of_constraints) {
+          break;
+        }
+      }
+    } else {
+      // There are fewer first half signatures than accepted ones.
+      for (Groups::const_iterator first = groups[0].begin();
+           first != groups[0].end();
+           ++first) {
+        bool is_match = true;
+        for (size_t i = 0; i < number_of_constraints && is_match; i++) {
+          is_match = std::binary_search(candidates[i]->begin(),
+                                        candidates[i]->end(),
+                                        get_signature_state(first->first, i));
+        }
+        if (is_match) {
+          add_match(first->second, second->second);
+        }
+      }
+    }
+  }
+}
+
+FrontierState MeetInTheMiddleSolver::get_signature_state(
+    const std::string& signature, int i) const {
+  FrontierState state;
+  memcpy(&state, signature.data() + i * sizeof(state), sizeof(state));
+  return state;
+}
+
+bool MeetInTheMiddleSolver::accepts(int i,
+                                    FrontierState state,
+                                    const unsigned char* boundary) const {
+  for (size_t j = 0; j < second_half_reads[i].size(); j++) {
+    state = spanning_constraints[i]->get_next_frontier_state(
+        state,
+        second_half_reads[i][j].scope_position,
+        boundary[second_half_reads[i][j].boundary_index]);
+    if (state == REJECTED_FRONTIER_STATE) {
+      return false;
+    }
+  }
+  return spanning_constraints[i]->is_accepting_frontier_state(state);
+}
+
+void MeetInTheMiddleSolver::add_match(const Group& first,
+                                      const Group& second) {
+  if (number_of_solutions == 0) {
+    solution_records[0] = first.first_record;
+    solution_records[1] = second.first_record;
+  }
+  number_of_solutions = saturating_add(
+      number_of_solutions, saturating_multiply(first.count, second.count));
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
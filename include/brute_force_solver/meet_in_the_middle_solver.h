@@ -0,0 +1,164 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Counts and finds solutions of a Board that splits into two halves.
+//
+// Each half is searched on its own, with the other half empty, and every way
+// to fill it in is stored with its boundary signature: what the constraints
+// that span both halves read from it. For the first half that is the frontier
+// state of each such constraint, and for the second half it is the values of
+// the squares those constraints read. Halves are grouped by signature, and a
+// pair of groups matches if every spanning constraint accepts the frontier
+// state of the first continued with the values of the second. The join is a
+// hash join: each spanning constraint runs each of its distinct first half
+// states over each distinct set of values it reads from the second half once,
+// and the first half signatures that a second half group accepts are looked up
+// by equality.
+//
+// This trades memory for time: the solver holds every solution of both halves.
+// Up to |memory_cap| bytes of them are held in memory, and the rest spill to a
+// memory-mapped temporary file. As with the FrontierSolver, the constraints
+// that span both halves must have frontier states, and the validator is only
+// checked on each half, so every rule that spans the halves must be a
+// constraint.
+// -----------------------------------------------------------------------------
+
+#ifndef _MEET_IN_THE_MIDDLE_SOLVER_H_
+#define _MEET_IN_THE_MIDDLE_SOLVER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/spill_buffer.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+class MeetInTheMiddleSolver {
+ public:
+  // The first half is the |first_half_size| squares of |first_half|, and the
+  // second half is the rest of |board|. The board must outlive the solver.
+  MeetInTheMiddleSolver(const Board* const board,
+                        const int* const first_half,
+                        int first_half_size,
+                        size_t memory_cap,
+                        const char* const spill_directory);
+  ~MeetInTheMiddleSolver();
+
+  // Returns the number of solutions, or ~0ull if there are at least that
+  // many.
+  unsigned long long count_solutions();
+
+  // Returns a board containing a solution, if it exists.
+  // Returns NULL if there is no solution.
+  // The caller is responsible for freeing the pointer, if it is non-NULL.
+  Board* find_solution();
+
+  // Returns true if the solutions of a half could not be stored, in which
+  // case the results above are incomplete.
+  bool has_failed() {
+    join();
+    return failed;
+  }
+
+  // Returns true if the solutions of a half spilled to a file.
+  bool has_spilled() {
+    join();
+    return halves[0].records->is_spilled() || halves[1].records->is_spilled();
+  }
+
+ private:
+  class HalfSink;
+  struct Group;
+
+  // The groups of records of a half, by signature.
+  typedef std::unordered_map<std::string, Group> Groups;
+
+  struct Half {
+    // The squares of the half, and for the second half the squares that the
+    // spanning constraints read.
+    std::vector<int> squares;
+    std::vector<int> boundary_squares;
+
+    // Each record is the boundary signature followed by the state index of
+    // every square of the half.
+    size_t signature_size;
+    SpillBuffer* records;
+  };
+
+  // A square of the second half read by a spanning constraint: its position
+  // in the scope, and in the boundary squares of the second half.
+  struct BoundaryRead {
+    int scope_position;
+    int boundary_index;
+  };
+
+  // Returns the frontier state of the spanning constraint |i| after the
+  // squares of the first half on |board|, which may be
+  // REJECTED_FRONTIER_STATE.
+  FrontierState get_first_half_state(int i, const Board* const board) const;
+
+  // Searches both halves, if that has not been done yet, and matches them.
+  void join();
+
+  // Returns the frontier state of the spanning constraint |i| in the first
+  // half signature |signature|.
+  FrontierState get_signature_state(const std::string& signature,
+                                    int i) const;
+
+  // Returns true if the spanning constraint |i| accepts the first half
+  // frontier state |state| continued with the second half signature
+  // |boundary|.
+  bool accepts(int i, FrontierState state, const unsigned char* boundary) const;
+
+  // Counts the solutions made of the groups |first| and |second|.
+  void add_match(const Group& first, const Group& second);
+
+  const Board* const board;
+
+  // The constraints that span both halves, and the squares of the second
+  // half that each reads.
+  std::vector<const Constraint*> spanning_constraints;
+  std::vector<std::vector<BoundaryRead> > second_half_reads;
+
+  // The scope positions of each spanning constraint in the first half.
+  std::vector<std::vector<int> > first_half_positions;
+
+  Half halves[2];
+
+  bool has_joined;
+  bool failed;
+  unsigned long long number_of_solutions;
+
+  // The records of a solution in each half, if there is one.
+  size_t solution_records[2];
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _MEET_IN_THE_MIDDLE_SOLVER_H_
@@ -0,0 +1,111 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/pairwise_constraint.h"
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/cnf_encoder.h"
+#include "include/brute_force_solver/domain.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+PairwiseConstraint::PairwiseConstraint(int first_square,
+                                       int second_square,
+                                       const Domain* const compatible,
+                                       int number_of_states) :
+    Constraint(2),
+    first_square(first_square),
+    second_square(second_square),
+    number_of_states(number_of_states),
+    compatible(new Domain[number_of_states]) {
+  set_scope(0, first_square);
+  set_scope(1, second_square);
+  for (int i = 0; i < number_of_states; i++) {
+    this->compatible[i] = compatible[i];
+  }
+}
+
+PairwiseConstraint::~PairwiseConstraint() {
+  delete[] compatible;
+}
+
+bool PairwiseConstraint::propagate(Board* const board,
+                                   const int* const counters) const {
+  // Keep the states of the first square that have support in the second.
+  Domain second_domain = board->get_domain(second_square);
+  Domain first_domain = board->get_domain(first_square);
+  Domain supported_first = 0;
+  for (Domain rest = first_domain; rest != 0; rest &= rest - 1) {
+    int state = lowest_state(rest);
+    if (compatible[state] & second_domain) {
+      supported_first |= single_state_domain(state);
+    }
+  }
+  if (!board->restrict_domain(first_square, supported_first)) {
+    return false;
+  }
+
+  // Every state kept for the second square is supported by one of these, so
+  // this single pass in each direction reaches the fixpoint.
+  Domain supported_second = 0;
+  for (Domain rest = supported_first; rest != 0; rest &= rest - 1) {
+    supported_second |= compatible[lowest_state(rest)];
+  }
+  return board->restrict_domain(second_square, supported_second);
+}
+
+FrontierState PairwiseConstraint::get_next_frontier_state(
+    FrontierState frontier_state, int scope_position, int state_index) const {
+  const FrontierState finished = 1 + 2 * number_of_states;
+  if (frontier_state == 0) {
+    return 1 + scope_position * number_of_states + state_index;
+  }
+
+  int first_state;
+  int second_state;
+  if (scope_position == 0) {
+    first_state = state_index;
+    second_state = frontier_state - 1 - number_of_states;
+  } else {
+    first_state = frontier_state - 1;
+    second_state = state_index;
+  }
+  if (!domain_contains(compatible[first_state], second_state)) {
+    return REJECTED_FRONTIER_STATE;
+  }
+  return finished;
+}
+
+bool PairwiseConstraint::add_clauses(CnfEncoder* const encoder) const {
+  for (int i = 0; i < number_of_states; i++) {
+    for (int j = 0; j < number_of_states; j++) {
+      if (!domain_contains(compatible[i], j)) {
+        encoder->get_formula()->add_binary(
+            -encoder->get_variable(first_square, i),
+            -encoder->get_variable(second_square, j));
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
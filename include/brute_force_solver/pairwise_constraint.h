@@ -0,0 +1,74 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef _PAIRWISE_CONSTRAINT_H_
+#define _PAIRWISE_CONSTRAINT_H_
+
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+// A constraint between two squares given by a table of compatible states:
+// the state j of |second_square| is allowed next to the state i of
+// |first_square| if bit j of |compatible[i]| is set.
+//
+// Propagation makes the pair arc consistent: every state left in either
+// domain has a compatible state in the other.
+class PairwiseConstraint : public Constraint {
+ public:
+  // The |compatible| array has one entry per state, and is copied.
+  PairwiseConstraint(int first_square,
+                     int second_square,
+                     const Domain* const compatible,
+                     int number_of_states);
+  virtual ~PairwiseConstraint();
+
+  virtual bool propagate(Board* const board, const int* const counters) const;
+
+  // The frontier state is 0 before either square is assigned, 1 + i once
+  // the first square is assigned state i, 1 + |number_of_states| + j once the
+  // second square is assigned state j, and 1 + 2 * |number_of_states| once
+  // both are.
+  virtual bool has_frontier_states() const {
+    return true;
+  }
+
+  virtual FrontierState get_next_frontier_state(FrontierState frontier_state,
+                                                int scope_position,
+                                                int state_index) const;
+
+  // Forbids each incompatible pair of states with a binary clause.
+  virtual bool add_clauses(CnfEncoder* const encoder) const;
+
+ private:
+  const int first_square;
+  const int second_square;
+  const int number_of_states;
+  Domain* const compatible;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _PAIRWISE_CONSTRAINT_H_
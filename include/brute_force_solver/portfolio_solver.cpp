@@ -0,0 +1,258 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/portfolio_solver.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/search_order_tuner.h"
+#include "include/brute_force_solver/state_list.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+namespace {
+
+// The configurations, most conservative first.
+const PortfolioConfiguration CONFIGURATIONS[] = {
+  {PORTFOLIO_BOARD_ORDER, false, PORTFOLIO_NATURAL_VALUES},
+  {PORTFOLIO_GREEDY_ORDER, false, PORTFOLIO_NATURAL_VALUES},
+  {PORTFOLIO_BOARD_ORDER, false, PORTFOLIO_RANDOM_VALUES},
+  {PORTFOLIO_BOARD_ORDER, true, PORTFOLIO_NATURAL_VALUES},
+  {PORTFOLIO_GREEDY_ORDER, true, PORTFOLIO_RANDOM_VALUES},
+  {PORTFOLIO_BOARD_ORDER, false, PORTFOLIO_REVERSED_VALUES},
+  {PORTFOLIO_BOARD_ORDER, true, PORTFOLIO_RANDOM_VALUES},
+  {PORTFOLIO_GREEDY_ORDER, false, PORTFOLIO_RANDOM_VALUES},
+};
+
+const int NUMBER_OF_CONFIGURATIONS =
+    sizeof(CONFIGURATIONS) / sizeof(CONFIGURATIONS[0]);
+
+// A perturbed order swaps squares at most this far apart.
+const int PERTURBATION_DISTANCE = 4;
+
+// Returns the |i|th term of the Luby sequence, counting from 1.
+unsigned long long luby(unsigned long long i) {
+  int k = 1;
+  while ((1ull << k) - 1 < i) {
+    k++;
+  }
+  if (i == (1ull << k) - 1) {
+    return 1ull << (k - 1);
+  }
+  return luby(i - (1ull << (k - 1)) + 1);
+}
+
+unsigned long long saturating_multiply(unsigned long long a,
+                                       unsigned long long b) {
+  return (b != 0 && a > ~0ull / b) ? ~0ull : a * b;
+}
+
+}  // namespace
+
+PortfolioSolver::PortfolioSolver(const Board* const board,
+                                 int number_of_threads,
+                                 unsigned int seed) :
+    board(board),
+    number_of_threads(std::max(1, number_of_threads)),
+    seed(seed),
+    restart_base(1000),
+    configurations(CONFIGURATIONS, CONFIGURATIONS + NUMBER_OF_CONFIGURATIONS),
+    wins(NUMBER_OF_CONFIGURATIONS, 0),
+    greedy_order(board->get_number_of_squares()),
+    is_won(false),
+    winner(-1),
+    solution(NULL),
+    number_of_restarts(0) {
+  SearchOrderTuner tuner(board, 0, 1);
+  tuner.make_greedy_order(&greedy_order[0]);
+}
+
+PortfolioSolver::~PortfolioSolver() {
+  delete solution;
+}
+
+std::string PortfolioSolver::get_configuration_name(int i) const {
+  const PortfolioConfiguration& configuration = configurations[i];
+  std::string name = (configuration.order == PORTFOLIO_BOARD_ORDER) ?
+      "board order" : "greedy order";
+  if (configuration.is_perturbed) {
+    name += ", perturbed";
+  }
+  if (configuration.values == PORTFOLIO_REVERSED_VALUES) {
+    name += ", reversed values";
+  } else if (configuration.values == PORTFOLIO_RANDOM_VALUES) {
+    name += ", random values";
+  }
+  return name;
+}
+
+Board* PortfolioSolver::find_solution() {
+  delete solution;
+  solution = NULL;
+  winner = -1;
+  is_won = false;
+  number_of_restarts = 0;
+
+  // Run the configurations with the most wins; ties go to the earlier one.
+  std::vector<int> ranking(configurations.size());
+  for (size_t i = 0; i < ranking.size(); i++) {
+    ranking[i] = i;
+  }
+  std::stable_sort(ranking.begin(), ranking.end(), [this](int a, int b) {
+    return wins[a] > wins[b];
+  });
+  ranking.resize(std::min(ranking.size(),
+                          static_cast<size_t>(number_of_threads)));
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < ranking.size(); i++) {
+    threads.push_back(std::thread(&PortfolioSolver::run, this, ranking[i]));
+  }
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+
+  Board* result = solution;
+  solution = NULL;
+  return result;
+}
+
+void PortfolioSolver::run(int i) {
+  const PortfolioConfiguration& configuration = configurations[i];
+  std::mt19937 random(seed + i);
+  int number_of_squares = board->get_number_of_squares();
+  int number_of_states = board->get_state_list()->get_number_of_states();
+
+  // Searches of this configuration stop as soon as any configuration wins.
+  Board* own_board = board->copy();
+  own_board->set_stop_flag(&is_won);
+  own_board->set_progress_listener(NULL, 0);
+  own_board->set_search_trace(NULL);
+
+  std::vector<int> base_order(board->get_search_order(),
+                              board->get_search_order() + number_of_squares);
+  if (configuration.order == PORTFOLIO_GREEDY_ORDER) {
+    base_order = greedy_order;
+  }
+  std::vector<int> order(base_order);
+  std::vector<int> value_order(number_of_states);
+  for (int j = 0; j < number_of_states; j++) {
+    value_order[j] = j;
+  }
+  if (configuration.values == PORTFOLIO_REVERSED_VALUES) {
+    std::reverse(value_order.begin(), value_order.end());
+  }
+  own_board->set_value_order(&value_order[0]);
+
+  bool is_random = configuration.is_perturbed ||
+                   configuration.values == PORTFOLIO_RANDOM_VALUES;
+  for (unsigned long long attempt = 1; !is_won; attempt++) {
+    if (configuration.is_perturbed) {
+      order = base_order;
+      for (int j = 0; j <= number_of_squares / 8; j++) {
+        int a = random() % number_of_squares;
+        int b = std::min(number_of_squares - 1,
+                         a + 1 + static_cast<int>(
+                             random() % PERTURBATION_DISTANCE));
+        std::swap(order[a], order[b]);
+      }
+    }
+    if (configuration.values == PORTFOLIO_RANDOM_VALUES) {
+      std::shuffle(value_order.begin(), value_order.end(), random);
+    }
+
+    unsigned long long limit =
+        is_random ? saturating_multiply(restart_base, luby(attempt)) : ~0ull;
+    bool finished = false;
+    Board* found = NULL;
+    own_board->probe_search(&order[0], limit, &finished, &found);
+    if (finished) {
+      report(i, found);
+      break;
+    }
+    delete found;
+    if (!is_won) {
+      number_of_restarts++;
+    }
+  }
+  delete own_board;
+}
+
+void PortfolioSolver::report(int i, Board* found) {
+  std::lock_guard<std::mutex> lock(winner_mutex);
+  if (winner != -1) {
+    delete found;
+    return;
+  }
+  winner = i;
+  solution = found;
+  is_won = true;
+}
+
+bool PortfolioSolver::load_profile(const char* const path) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+  int number_of_configurations = 0;
+  bool valid = fscanf(file,
+                      " portfolio_profile configurations %d wins",
+                      &number_of_configurations) == 1 &&
+               number_of_configurations ==
+                   static_cast<int>(configurations.size());
+  std::vector<int> loaded(configurations.size());
+  for (size_t i = 0; i < loaded.size() && valid; i++) {
+    valid = fscanf(file, "%d", &loaded[i]) == 1 && loaded[i] >= 0;
+  }
+  fclose(file);
+
+  if (valid) {
+    wins = loaded;
+  }
+  return valid;
+}
+
+bool PortfolioSolver::save_profile(const char* const path) const {
+  FILE* file = fopen(path, "w");
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file, "portfolio_profile\n");
+  fprintf(file, "configurations %d\n", static_cast<int>(wins.size()));
+  fprintf(file, "wins");
+  for (size_t i = 0; i < wins.size(); i++) {
+    fprintf(file, " %d", wins[i]);
+  }
+  fprintf(file, "\n");
+  return fclose(file) == 0;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
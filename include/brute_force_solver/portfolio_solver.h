@@ -0,0 +1,151 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Runs several configurations of the search of a Board at once, one per
+// thread, and takes the answer of the first to finish. A search with a fixed
+// order can lose hours to one bad early choice; a portfolio of differently
+// ordered searches is much less likely to have all of them make it.
+//
+// A configuration picks the search order (the order of the board, or the
+// greedy order of SearchOrderTuner, either of which may be randomly
+// perturbed) and the value order (the order of the StateList, reversed, or
+// random). The configurations with a random part restart after a number of
+// nodes that follows the Luby sequence (1, 1, 2, 1, 1, 2, 4, 1, ...) times a
+// base, drawing new random choices at each restart; the others run once, to
+// the end. The first configuration to find a solution, or to show that there
+// is none, wins, and the others are stopped.
+//
+// The winner can be recorded in a profile file. When there are fewer threads
+// than configurations, the configurations with the most recorded wins are the
+// ones that run.
+// -----------------------------------------------------------------------------
+
+#ifndef _PORTFOLIO_SOLVER_H_
+#define _PORTFOLIO_SOLVER_H_
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+enum PortfolioOrder {
+  PORTFOLIO_BOARD_ORDER,
+  PORTFOLIO_GREEDY_ORDER,
+};
+
+enum PortfolioValues {
+  PORTFOLIO_NATURAL_VALUES,
+  PORTFOLIO_REVERSED_VALUES,
+  PORTFOLIO_RANDOM_VALUES,
+};
+
+struct PortfolioConfiguration {
+  PortfolioOrder order;
+  bool is_perturbed;
+  PortfolioValues values;
+};
+
+class PortfolioSolver {
+ public:
+  // The board must outlive the solver. Configuration i uses the random seed
+  // |seed| + i.
+  PortfolioSolver(const Board* const board,
+                  int number_of_threads,
+                  unsigned int seed);
+  ~PortfolioSolver();
+
+  // Sets the number of nodes of the shortest run between restarts.
+  void set_restart_base(unsigned long long restart_base) {
+    this->restart_base = restart_base;
+  }
+
+  int get_number_of_configurations() const {
+    return configurations.size();
+  }
+
+  // Describes configuration |i|, e.g. "greedy order, random values".
+  std::string get_configuration_name(int i) const;
+
+  // Runs the portfolio. Returns the solution of the winner, or NULL if it
+  // showed that there is none. The caller is responsible for freeing the
+  // pointer, if it is non-NULL.
+  Board* find_solution();
+
+  // The configuration that won the last run.
+  int get_winner() const {
+    return winner;
+  }
+
+  // The number of restarts of all the configurations in the last run.
+  int get_number_of_restarts() const {
+    return number_of_restarts;
+  }
+
+  // Counts the last winner in the wins of the profile.
+  void record_winner() {
+    if (winner != -1) {
+      wins[winner]++;
+    }
+  }
+
+  // Reads the wins of each configuration from the profile file at |path|.
+  // Returns false, and leaves the wins alone, if there is no such file or it
+  // is not a profile of these configurations.
+  bool load_profile(const char* const path);
+
+  // Writes the wins of each configuration to the profile file at |path|.
+  // Returns false if the file cannot be written.
+  bool save_profile(const char* const path) const;
+
+ private:
+  // Runs configuration |i| until some configuration wins.
+  void run(int i);
+
+  // Takes the answer of configuration |i|, if it is the first.
+  void report(int i, Board* solution);
+
+  const Board* const board;
+  const int number_of_threads;
+  const unsigned int seed;
+  unsigned long long restart_base;
+
+  std::vector<PortfolioConfiguration> configurations;
+  std::vector<int> wins;
+
+  // The greedy order of the board.
+  std::vector<int> greedy_order;
+
+  std::atomic<bool> is_won;
+  std::mutex winner_mutex;
+  int winner;
+  Board* solution;
+  std::atomic<int> number_of_restarts;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _PORTFOLIO_SOLVER_H_
@@ -0,0 +1,42 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/progress_listener.h"
+
+#include <stdio.h>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+void StderrProgressListener::report(const SearchProgress& progress) {
+  fprintf(stderr,
+          "%.2f%% done, %llu nodes in %.1f s (%.0f nodes/s)",
+          100.0 * progress.fraction_done,
+          progress.number_of_nodes,
+          progress.elapsed_seconds,
+          progress.nodes_per_second);
+  if (progress.seconds_left >= 0) {
+    fprintf(stderr, ", about %.1f s left", progress.seconds_left);
+  }
+  fprintf(stderr, "\n");
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
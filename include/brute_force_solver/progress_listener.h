@@ -0,0 +1,63 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef _PROGRESS_LISTENER_H_
+#define _PROGRESS_LISTENER_H_
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+// A snapshot of a running search.
+struct SearchProgress {
+  // The nodes visited so far, i.e. the states tried.
+  unsigned long long number_of_nodes;
+  double elapsed_seconds;
+
+  // The fraction of the search tree explored, weighing each branch by the
+  // branching seen on the path to it, so every child of a node counts the
+  // same. This is an estimate: it is exact only for a uniform tree.
+  double fraction_done;
+
+  double nodes_per_second;
+
+  // The estimated time left, or -1 if nothing has been explored yet.
+  double seconds_left;
+};
+
+// Receives progress reports from a running search.
+class ProgressListener {
+ public:
+  virtual ~ProgressListener() {
+  }
+
+  // Called from the search thread; keep it short.
+  virtual void report(const SearchProgress& progress) = 0;
+};
+
+// Prints each report as a line on stderr.
+class StderrProgressListener : public ProgressListener {
+ public:
+  virtual void report(const SearchProgress& progress);
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _PROGRESS_LISTENER_H_
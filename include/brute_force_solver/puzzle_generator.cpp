@@ -0,0 +1,152 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/puzzle_generator.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/solution_generator.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+PuzzleGenerator::PuzzleGenerator(const Board* const board,
+                                 int number_of_threads) :
+    board(board),
+    number_of_threads(std::max(1, number_of_threads)),
+    clues(NULL),
+    kept_board(NULL),
+    number_of_searches(0) {
+}
+
+PuzzleGenerator::~PuzzleGenerator() {
+  delete kept_board;
+}
+
+bool PuzzleGenerator::remove_clues(
+    const std::vector<const Constraint*>& clues,
+    std::vector<int>* kept,
+    unsigned long long* number_of_nodes) {
+  this->clues = &clues;
+  statuses.assign(clues.size(), CLUE_UNDECIDED);
+  delete kept_board;
+  kept_board = board->copy();
+  kept_board->set_progress_listener(NULL, 0);
+  kept_board->set_search_trace(NULL);
+  kept_board->propagate();
+
+  Check all_clues;
+  check(-1, &all_clues);
+  number_of_searches++;
+  if (!all_clues.is_unique) {
+    return false;
+  }
+
+  std::vector<int> batch;
+  std::vector<Check> results;
+  size_t first_undecided = 0;
+  while (true) {
+    batch.clear();
+    for (size_t i = first_undecided;
+         i < clues.size() && static_cast<int>(batch.size()) < number_of_threads;
+         i++) {
+      if (statuses[i] == CLUE_UNDECIDED) {
+        batch.push_back(i);
+      }
+    }
+    if (batch.empty()) {
+      break;
+    }
+    first_undecided = batch[0];
+
+    results.resize(batch.size());
+    if (batch.size() == 1) {
+      check(batch[0], &results[0]);
+    } else {
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < batch.size(); i++) {
+        threads.push_back(std::thread(&PuzzleGenerator::check,
+                                      this,
+                                      batch[i],
+                                      &results[i]));
+      }
+      for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+      }
+    }
+    number_of_searches += batch.size();
+
+    // Only the first removal is known to be right; the checks after it that
+    // succeeded assumed the clue was still there, and run again.
+    bool is_removed = false;
+    for (size_t i = 0; i < batch.size(); i++) {
+      if (!results[i].is_unique) {
+        keep(batch[i]);
+      } else if (!is_removed) {
+        statuses[batch[i]] = CLUE_REMOVED;
+        is_removed = true;
+      }
+    }
+  }
+
+  Check puzzle;
+  check(-1, &puzzle);
+  number_of_searches++;
+  kept->clear();
+  for (size_t i = 0; i < clues.size(); i++) {
+    if (statuses[i] == CLUE_KEPT) {
+      kept->push_back(i);
+    }
+  }
+  *number_of_nodes = puzzle.number_of_nodes;
+  return true;
+}
+
+void PuzzleGenerator::check(int skipped, Check* result) const {
+  Board* puzzle = kept_board->copy();
+  for (size_t i = 0; i < clues->size(); i++) {
+    if (statuses[i] == CLUE_UNDECIDED && static_cast<int>(i) != skipped) {
+      puzzle->add_constraint((*clues)[i]);
+    }
+  }
+
+  // Stop at the second solution: one more cannot change the answer.
+  SolutionGenerator solutions(puzzle);
+  int number_of_solutions = 0;
+  while (number_of_solutions < 2 && solutions.next()) {
+    number_of_solutions++;
+  }
+  result->is_unique = (number_of_solutions == 1);
+  result->number_of_nodes = solutions.get_number_of_nodes();
+  delete puzzle;
+}
+
+void PuzzleGenerator::keep(int i) {
+  statuses[i] = CLUE_KEPT;
+  kept_board->add_constraint((*clues)[i]);
+  kept_board->propagate();
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
@@ -0,0 +1,108 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Turns the clues of a known solution into a puzzle whose solution is unique,
+// by removing every clue that the solution does not need.
+//
+// The Board holds the rules of the puzzle, and the clues are constraints that
+// the solution satisfies. The generator tries the clues in the order given:
+// a clue is removed if the rest still have only one solution, and is kept for
+// good otherwise. Uniqueness is checked with a SolutionGenerator that stops
+// after the second solution.
+//
+// The clues that are kept for good are added to a board once, and their
+// propagation carries over to the checks of all the later clues, which only
+// add the clues still undecided.
+//
+// Several clues are checked at once, one per thread, each against the
+// current clues. Removing clues only adds solutions, so the result is the
+// same as when checking one at a time: a check that fails stays failed once
+// earlier clues are removed, and a check that succeeds after an earlier
+// removal is simply run again.
+// -----------------------------------------------------------------------------
+
+#ifndef _PUZZLE_GENERATOR_H_
+#define _PUZZLE_GENERATOR_H_
+
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+class Constraint;
+
+class PuzzleGenerator {
+ public:
+  // The board must outlive the generator. It should not have a node limit.
+  PuzzleGenerator(const Board* const board, int number_of_threads);
+  ~PuzzleGenerator();
+
+  // Removes the clues that the puzzle does not need. Returns false if the
+  // board with all of |clues| does not have exactly one solution. Otherwise
+  // fills in the indices of the clues that are kept, in |kept|, and the
+  // number of nodes that a search needs to solve the puzzle and show that the
+  // solution is unique, in |number_of_nodes|.
+  bool remove_clues(const std::vector<const Constraint*>& clues,
+                    std::vector<int>* kept,
+                    unsigned long long* number_of_nodes);
+
+  // The number of uniqueness checks over all calls.
+  int get_number_of_searches() const {
+    return number_of_searches;
+  }
+
+ private:
+  enum ClueStatus {
+    CLUE_UNDECIDED,
+    CLUE_KEPT,
+    CLUE_REMOVED,
+  };
+
+  // The answer of a uniqueness check.
+  struct Check {
+    bool is_unique;
+    unsigned long long number_of_nodes;
+  };
+
+  // Checks the puzzle with the kept clues and the undecided clues except the
+  // one at |skipped|, or all of them if it is -1.
+  void check(int skipped, Check* result) const;
+
+  // Keeps the clue at |i| for good.
+  void keep(int i);
+
+  const Board* const board;
+  const int number_of_threads;
+
+  // The clues of the current call, their status, and the board with the
+  // clues that are kept.
+  const std::vector<const Constraint*>* clues;
+  std::vector<ClueStatus> statuses;
+  Board* kept_board;
+
+  int number_of_searches;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _PUZZLE_GENERATOR_H_
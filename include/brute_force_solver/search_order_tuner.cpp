@@ -0,0 +1,284 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/search_order_tuner.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+namespace {
+
+// Returns |order| with a random swap, move or reversal of a run of squares.
+std::vector<int> perturb(const std::vector<int>& order, std::mt19937* random) {
+  std::vector<int> result(order);
+  int size = result.size();
+  if (size < 2) {
+    return result;
+  }
+  int i = (*random)() % size;
+  int j = (*random)() % (size - 1);
+  if (j >= i) {
+    j++;
+  }
+  switch ((*random)() % 3) {
+    case 0:
+      std::swap(result[i], result[j]);
+      break;
+    case 1: {
+      int square = result[i];
+      result.erase(result.begin() + i);
+      result.insert(result.begin() + j, square);
+      break;
+    }
+    default:
+      std::reverse(result.begin() + std::min(i, j),
+                   result.begin() + std::max(i, j) + 1);
+      break;
+  }
+  return result;
+}
+
+}  // namespace
+
+SearchOrderTuner::SearchOrderTuner(const Board* const board,
+                                   unsigned long long node_limit,
+                                   int number_of_threads) :
+    board(board),
+    node_limit(node_limit),
+    number_of_threads(number_of_threads),
+    beam_width(4),
+    perturbations(8),
+    initial_score(0),
+    number_of_probes(0) {
+}
+
+SearchOrderTuner::~SearchOrderTuner() {
+}
+
+unsigned long long SearchOrderTuner::tune(int number_of_rounds,
+                                          unsigned int seed,
+                                          int* const best_order) {
+  int number_of_squares = board->get_number_of_squares();
+  std::mt19937 random(seed);
+  number_of_probes = 0;
+
+  std::vector<Candidate> beam(2);
+  beam[0].order.assign(board->get_search_order(),
+                       board->get_search_order() + number_of_squares);
+  beam[1].order.resize(number_of_squares);
+  make_greedy_order(&beam[1].order[0]);
+  score_all(&beam, node_limit);
+  initial_score = beam[0].score;
+  std::stable_sort(beam.begin(), beam.end(),
+                   [](const Candidate& a, const Candidate& b) {
+                     return a.score < b.score;
+                   });
+
+  for (int round = 0; round < number_of_rounds; round++) {
+    std::vector<Candidate> candidates;
+    for (size_t i = 0; i < beam.size(); i++) {
+      for (int j = 0; j < perturbations; j++) {
+        Candidate candidate;
+        candidate.order = perturb(beam[i].order, &random);
+        candidates.push_back(candidate);
+      }
+    }
+    unsigned long long limit = node_limit;
+    if (beam.size() >= static_cast<size_t>(beam_width)) {
+      limit = std::min(limit, beam.back().score);
+    }
+    score_all(&candidates, limit);
+
+    // Keep the best distinct orders, preferring those already in the beam.
+    candidates.insert(candidates.begin(), beam.begin(), beam.end());
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) {
+                       return a.score < b.score;
+                     });
+    beam.clear();
+    for (size_t i = 0;
+         i < candidates.size() && beam.size() < static_cast<size_t>(beam_width);
+         i++) {
+      bool is_new = true;
+      for (size_t j = 0; j < beam.size() && is_new; j++) {
+        is_new = (beam[j].order != candidates[i].order);
+      }
+      if (is_new) {
+        beam.push_back(candidates[i]);
+      }
+    }
+  }
+
+  std::copy(beam[0].order.begin(), beam[0].order.end(), best_order);
+  return beam[0].score;
+}
+
+void SearchOrderTuner::make_greedy_order(int* const order) const {
+  int number_of_squares = board->get_number_of_squares();
+  const int* search_order = board->get_search_order();
+
+  // The number of constraints on each square, and the squares that share a
+  // constraint with each square, once for every constraint they share.
+  std::vector<int> degrees(number_of_squares, 0);
+  std::vector<std::vector<int> > neighbours(number_of_squares);
+  for (int i = 0; i < board->get_number_of_constraints(); i++) {
+    const Constraint* constraint = board->get_constraint(i);
+    for (int j = 0; j < constraint->get_scope_size(); j++) {
+      int square = constraint->get_scope(j);
+      degrees[square]++;
+      for (int k = 0; k < constraint->get_scope_size(); k++) {
+        if (k != j) {
+          neighbours[square].push_back(constraint->get_scope(k));
+        }
+      }
+    }
+  }
+
+  // Squares with a single state left cost nothing, so they go first.
+  std::vector<bool> is_picked(number_of_squares, false);
+  std::vector<int> links(number_of_squares, 0);
+  int number_picked = 0;
+  for (int i = 0; i < number_of_squares; i++) {
+    int square = search_order[i];
+    if (domain_size(board->get_domain(square)) == 1) {
+      order[number_picked++] = square;
+      is_picked[square] = true;
+      for (size_t j = 0; j < neighbours[square].size(); j++) {
+        links[neighbours[square][j]]++;
+      }
+    }
+  }
+
+  while (number_picked < number_of_squares) {
+    int best = -1;
+    for (int i = 0; i < number_of_squares; i++) {
+      int square = search_order[i];
+      if (is_picked[square]) {
+        continue;
+      }
+      if (best == -1 || links[square] > links[best] ||
+          (links[square] == links[best] && degrees[square] > degrees[best])) {
+        best = square;
+      }
+    }
+    order[number_picked++] = best;
+    is_picked[best] = true;
+    for (size_t j = 0; j < neighbours[best].size(); j++) {
+      links[neighbours[best][j]]++;
+    }
+  }
+}
+
+unsigned long long SearchOrderTuner::score(const int* const order,
+                                           unsigned long long limit) const {
+  bool finished = false;
+  unsigned long long number_of_nodes =
+      board->probe_search(order, limit, &finished);
+  return finished ? number_of_nodes : limit + 1;
+}
+
+void SearchOrderTuner::score_all(std::vector<Candidate>* candidates,
+                                 unsigned long long limit) {
+  std::atomic<size_t> next(0);
+  auto work = [this, candidates, limit, &next]() {
+    for (size_t i = next++; i < candidates->size(); i = next++) {
+      Candidate* candidate = &(*candidates)[i];
+      candidate->score = score(&candidate->order[0], limit);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < number_of_threads; i++) {
+    threads.push_back(std::thread(work));
+  }
+  work();
+  for (size_t i = 0; i < threads.size(); i++) {
+    threads[i].join();
+  }
+  number_of_probes += candidates->size();
+}
+
+bool SearchOrderTuner::save_profile(const char* const path,
+                                    int number_of_squares,
+                                    const int* const order,
+                                    unsigned long long score) {
+  FILE* file = fopen(path, "w");
+  if (file == NULL) {
+    return false;
+  }
+  fprintf(file, "search_order_profile\n");
+  fprintf(file, "squares %d\n", number_of_squares);
+  fprintf(file, "score %llu\n", score);
+  fprintf(file, "order");
+  for (int i = 0; i < number_of_squares; i++) {
+    fprintf(file, " %d", order[i]);
+  }
+  fprintf(file, "\n");
+  return fclose(file) == 0;
+}
+
+bool SearchOrderTuner::load_profile(const char* const path,
+                                    int number_of_squares,
+                                    int* const order) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+  int squares = 0;
+  unsigned long long score = 0;
+  bool valid = fscanf(file,
+                      " search_order_profile squares %d score %llu order",
+                      &squares,
+                      &score) == 2 &&
+               squares == number_of_squares;
+
+  // The order must hold every square exactly once.
+  std::vector<int> loaded(number_of_squares);
+  std::vector<bool> seen(number_of_squares, false);
+  for (int i = 0; i < number_of_squares && valid; i++) {
+    valid = fscanf(file, "%d", &loaded[i]) == 1 &&
+            0 <= loaded[i] && loaded[i] < number_of_squares &&
+            !seen[loaded[i]];
+    if (valid) {
+      seen[loaded[i]] = true;
+    }
+  }
+  fclose(file);
+
+  if (valid) {
+    std::copy(loaded.begin(), loaded.end(), order);
+  }
+  return valid;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
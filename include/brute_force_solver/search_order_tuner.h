@@ -0,0 +1,131 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Tunes the search order of a Board, in place of ordering the squares by hand.
+//
+// Each candidate order is scored by a probe: the search of find_solution()
+// with the squares in that order, cut off after a number of nodes. The score
+// is the number of nodes the probe tried, and a probe that runs out of nodes
+// scores one more than its limit.
+//
+// The tuner starts from the order of the board and a greedy order, which
+// picks next the square that shares the most constraints with the squares
+// already picked (breaking ties by the number of constraints on the square,
+// then by the order of the board). It then runs a beam search: every round
+// makes random perturbations (swaps, moves and reversals of runs of squares)
+// of each order in the beam, probes them in parallel, and keeps the best
+// orders seen. Once the beam is full, probes stop at the score of its worst
+// order, since an order that needs more nodes cannot enter it.
+//
+// The best order can be saved to a profile file, so that later runs of the
+// same puzzle load it instead of tuning again.
+// -----------------------------------------------------------------------------
+
+#ifndef _SEARCH_ORDER_TUNER_H_
+#define _SEARCH_ORDER_TUNER_H_
+
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+class SearchOrderTuner {
+ public:
+  // The board must outlive the tuner. Probes try at most |node_limit| nodes.
+  SearchOrderTuner(const Board* const board,
+                   unsigned long long node_limit,
+                   int number_of_threads);
+  ~SearchOrderTuner();
+
+  // Makes every round perturb each of at most |beam_width| orders
+  // |perturbations| times.
+  void set_beam(int beam_width, int perturbations) {
+    this->beam_width = beam_width;
+    this->perturbations = perturbations;
+  }
+
+  // Runs |number_of_rounds| rounds of the beam search, with random seed
+  // |seed|, and writes the best order found to |best_order|, which has room
+  // for every square of the board. Returns the score of that order.
+  unsigned long long tune(int number_of_rounds,
+                          unsigned int seed,
+                          int* const best_order);
+
+  // Writes the greedy order by constraint degree to |order|.
+  void make_greedy_order(int* const order) const;
+
+  // The score of the order of the board, from the last call to tune().
+  unsigned long long get_initial_score() const {
+    return initial_score;
+  }
+
+  // The number of probes run by the last call to tune().
+  int get_number_of_probes() const {
+    return number_of_probes;
+  }
+
+  // Writes |order|, of |number_of_squares| squares with score |score|, to the
+  // profile file at |path|. Returns false if the file cannot be written.
+  static bool save_profile(const char* const path,
+                           int number_of_squares,
+                           const int* const order,
+                           unsigned long long score);
+
+  // Reads an order of |number_of_squares| squares from the profile file at
+  // |path| into |order|. Returns false, and leaves |order| alone, if there is
+  // no such file, or it does not hold an order of that many squares.
+  static bool load_profile(const char* const path,
+                           int number_of_squares,
+                           int* const order);
+
+ private:
+  struct Candidate {
+    std::vector<int> order;
+    unsigned long long score = 0;
+  };
+
+  // Returns the number of nodes that a probe of |order| tries, or |limit|
+  // plus one if it runs out of nodes.
+  unsigned long long score(const int* const order,
+                           unsigned long long limit) const;
+
+  // Scores the orders of |candidates| with probes of at most |limit| nodes,
+  // split between the threads.
+  void score_all(std::vector<Candidate>* candidates,
+                 unsigned long long limit);
+
+  const Board* const board;
+  const unsigned long long node_limit;
+  const int number_of_threads;
+
+  int beam_width;
+  int perturbations;
+
+  unsigned long long initial_score;
+  int number_of_probes;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _SEARCH_ORDER_TUNER_H_
@@ -0,0 +1,157 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/search_trace.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+const char TRACE_MAGIC[8] = {'B', 'F', 'T', 'R', 'A', 'C', 'E', '1'};
+
+namespace {
+
+// How long the flusher sleeps when no ring has events.
+const int FLUSHER_SLEEP_MICROSECONDS = 1000;
+
+}  // namespace
+
+TraceRing::TraceRing(std::atomic<bool>* const has_work, int index) :
+    has_work(has_work),
+    index(index),
+    head(0),
+    tail(0),
+    is_closed(false) {
+}
+
+void TraceRing::add(int type, int square, int state_index, int depth) {
+  uint32_t position = head.load(std::memory_order_relaxed);
+  while (position - tail.load(std::memory_order_acquire) >= CAPACITY) {
+    *has_work = true;
+    std::this_thread::yield();
+  }
+
+  TraceEvent& event = events[position & (CAPACITY - 1)];
+  event.type = type;
+  event.state_index = state_index;
+  event.depth = depth;
+  event.square = square;
+  head.store(position + 1, std::memory_order_release);
+}
+
+size_t TraceRing::flush(FILE* file) {
+  uint32_t first = tail.load(std::memory_order_relaxed);
+  uint32_t last = head.load(std::memory_order_acquire);
+  uint32_t count = last - first;
+  if (count == 0) {
+    return 0;
+  }
+
+  int32_t header[2] = {index, static_cast<int32_t>(count)};
+  fwrite(header, sizeof(header), 1, file);
+  uint32_t start = first & (CAPACITY - 1);
+  uint32_t until_wrap = CAPACITY - start;
+  if (count <= until_wrap) {
+    fwrite(events + start, sizeof(TraceEvent), count, file);
+  } else {
+    fwrite(events + start, sizeof(TraceEvent), until_wrap, file);
+    fwrite(events, sizeof(TraceEvent), count - until_wrap, file);
+  }
+  tail.store(last, std::memory_order_release);
+  return count;
+}
+
+SearchTrace::SearchTrace(const char* const path) :
+    file(fopen(path, "wb")),
+    number_of_rings_opened(0),
+    has_work(false),
+    is_stopping(false) {
+  if (file == NULL) {
+    return;
+  }
+  fwrite(TRACE_MAGIC, sizeof(TRACE_MAGIC), 1, file);
+  flusher = std::thread(&SearchTrace::run_flusher, this);
+}
+
+SearchTrace::~SearchTrace() {
+  if (file == NULL) {
+    return;
+  }
+  is_stopping = true;
+  flusher.join();
+  for (size_t i = 0; i < rings.size(); i++) {
+    rings[i]->flush(file);
+    delete rings[i];
+  }
+  fclose(file);
+}
+
+TraceRing* SearchTrace::open_ring() {
+  if (file == NULL) {
+    return NULL;
+  }
+  std::lock_guard<std::mutex> lock(rings_mutex);
+  TraceRing* ring = new TraceRing(&has_work, number_of_rings_opened++);
+  rings.push_back(ring);
+  return ring;
+}
+
+void SearchTrace::close_ring(TraceRing* const ring) {
+  if (ring != NULL) {
+    ring->is_closed.store(true, std::memory_order_release);
+  }
+}
+
+void SearchTrace::run_flusher() {
+  while (!is_stopping) {
+    size_t number_flushed = 0;
+    {
+      std::lock_guard<std::mutex> lock(rings_mutex);
+      for (size_t i = 0; i < rings.size(); ) {
+        // A ring closed before the flush has all its events by then.
+        bool was_closed = rings[i]->is_closed.load(std::memory_order_acquire);
+        number_flushed += rings[i]->flush(file);
+        if (was_closed) {
+          delete rings[i];
+          rings[i] = rings.back();
+          rings.pop_back();
+        } else {
+          i++;
+        }
+      }
+    }
+    if (number_flushed == 0 && !has_work.exchange(false)) {
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(FLUSHER_SLEEP_MICROSECONDS));
+    }
+  }
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
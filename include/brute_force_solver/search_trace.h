@@ -0,0 +1,145 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Records the events of Board searches to a compact binary log, to compare how
+// two versions of the engine search the same board.
+//
+// Each search writes its events to its own ring buffer, with no locks: the
+// search is the only writer of the ring and the flusher thread the only
+// reader. The flusher drains the rings to the file in the background, and a
+// search only waits for it when its ring is full, so no event is lost.
+//
+// The file starts with TRACE_MAGIC, followed by chunks. A chunk is the index
+// of a ring and a count, as two 32-bit ints, followed by that many
+// TraceEvents, all in the byte order of the machine. The events of a ring
+// come in the order they happened, though chunks of different rings
+// interleave.
+// -----------------------------------------------------------------------------
+
+#ifndef _SEARCH_TRACE_H_
+#define _SEARCH_TRACE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+extern const char TRACE_MAGIC[8];
+
+enum TraceEventType {
+  // The search tries a state for a square.
+  TRACE_ASSIGN = 1,
+  // The state tried fails propagation, the validator or the lookahead.
+  TRACE_REJECT = 2,
+  // The search is done with the subtree under the state tried.
+  TRACE_BACKTRACK = 3,
+  // The search fills in every square of its group of squares; that is a
+  // solution unless the board was split into groups. The square is -1.
+  TRACE_SOLUTION = 4,
+};
+
+struct TraceEvent {
+  uint8_t type;
+  uint8_t state_index;
+  // The position of the square in the search order of its group of squares.
+  uint16_t depth;
+  int32_t square;
+};
+
+// The events of one search.
+class TraceRing {
+ public:
+  TraceRing(std::atomic<bool>* const has_work, int index);
+
+  int get_index() const {
+    return index;
+  }
+
+  // Adds an event, waiting for the flusher if the ring is full. Only the
+  // search that owns the ring may call this.
+  void add(int type, int square, int state_index, int depth);
+
+ private:
+  friend class SearchTrace;
+
+  // The number of events a ring holds; a power of 2.
+  static const uint32_t CAPACITY = 1 << 14;
+
+  // Copies the events added since the last call to |file|, as one chunk.
+  // Returns the number of events copied.
+  size_t flush(FILE* file);
+
+  std::atomic<bool>* const has_work;
+  const int index;
+
+  TraceEvent events[CAPACITY];
+
+  // Events [tail, head) are waiting to be flushed; both only grow, and wrap
+  // around the ring.
+  std::atomic<uint32_t> head;
+  std::atomic<uint32_t> tail;
+
+  // Set by the search when it is done with the ring.
+  std::atomic<bool> is_closed;
+};
+
+class SearchTrace {
+ public:
+  // Starts writing to the file at |path|; check is_open() for errors.
+  explicit SearchTrace(const char* const path);
+
+  // Flushes every event, and closes the file.
+  ~SearchTrace();
+
+  bool is_open() const {
+    return file != NULL;
+  }
+
+  // Returns a new ring for a search. The ring belongs to the trace; the search
+  // must call close_ring() when it is done with it.
+  TraceRing* open_ring();
+  void close_ring(TraceRing* const ring);
+
+ private:
+  // Drains the rings until the trace is destroyed.
+  void run_flusher();
+
+  FILE* file;
+
+  std::mutex rings_mutex;
+  std::vector<TraceRing*> rings;
+  int number_of_rings_opened;
+
+  std::atomic<bool> has_work;
+  std::atomic<bool> is_stopping;
+  std::thread flusher;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _SEARCH_TRACE_H_
@@ -0,0 +1,414 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/sharded_solver.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/solution_sink.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+namespace {
+
+// From the coordinator to a worker: the shard to search, or -1 to exit, and
+// how many workers were lost on it before.
+struct Task {
+  int32_t shard;
+  int32_t attempt;
+};
+
+// From a worker to the coordinator. A solution is followed by the state
+// index of every square, as int32_t.
+enum MessageType {
+  MESSAGE_SOLUTION = 1,
+  MESSAGE_DONE = 2,
+};
+
+struct Message {
+  int32_t type;
+  int32_t shard;
+  // The number of solutions of the shard, for MESSAGE_DONE.
+  uint64_t count;
+};
+
+unsigned long long saturating_add(unsigned long long a, unsigned long long b) {
+  return (a + b < a) ? ~0ull : a + b;
+}
+
+bool send_all(int socket, const void* data, size_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  while (size > 0) {
+    ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    }
+    if (sent <= 0) {
+      return false;
+    }
+    bytes += sent;
+    size -= sent;
+  }
+  return true;
+}
+
+bool receive_all(int socket, void* data, size_t size) {
+  char* bytes = static_cast<char*>(data);
+  while (size > 0) {
+    ssize_t received = recv(socket, bytes, size, 0);
+    if (received < 0 && errno == EINTR) {
+      continue;
+    }
+    if (received <= 0) {
+      return false;
+    }
+    bytes += received;
+    size -= received;
+  }
+  return true;
+}
+
+// Keeps the state indices of the prefix squares of each solution.
+class PrefixSink : public SolutionSink {
+ public:
+  PrefixSink(const std::vector<int>& squares,
+             std::vector<std::vector<int> >* prefixes) :
+      squares(squares),
+      prefixes(prefixes) {
+  }
+
+  virtual bool add_solution(const Board* const board) {
+    std::vector<int> prefix(squares.size());
+    for (size_t i = 0; i < squares.size(); i++) {
+      prefix[i] = board->get_state_index(squares[i]);
+    }
+    prefixes->push_back(prefix);
+    return true;
+  }
+
+ private:
+  const std::vector<int>& squares;
+  std::vector<std::vector<int> >* prefixes;
+};
+
+// Sends each solution of a shard to the coordinator.
+class SocketSink : public SolutionSink {
+ public:
+  SocketSink(int socket, int shard) : socket(socket), shard(shard) {
+  }
+
+  virtual bool add_solution(const Board* const board) {
+    Message message = {MESSAGE_SOLUTION, shard, 0};
+    std::vector<int32_t> state_indices(board->get_number_of_squares());
+    for (size_t i = 0; i < state_indices.size(); i++) {
+      state_indices[i] = board->get_state_index(i);
+    }
+    if (!send_all(socket, &message, sizeof(message)) ||
+        !send_all(socket,
+                  &state_indices[0],
+                  state_indices.size() * sizeof(int32_t))) {
+      // The coordinator is gone; there is no one left to report to.
+      _exit(1);
+    }
+    return true;
+  }
+
+ private:
+  const int socket;
+  const int shard;
+};
+
+}  // namespace
+
+ShardedSolver::ShardedSolver(const Board* const board,
+                             int number_of_workers,
+                             int prefix_length) :
+    board(board),
+    number_of_workers(std::max(1, number_of_workers)),
+    prefix_length(std::min(std::max(0, prefix_length),
+                           board->get_number_of_squares())),
+    crash_shard(-1),
+    number_of_lost_workers(0),
+    number_of_failed_shards(0) {
+}
+
+ShardedSolver::~ShardedSolver() {
+}
+
+unsigned long long ShardedSolver::count_solutions() {
+  return run(NULL);
+}
+
+void ShardedSolver::find_all_solutions(SolutionSink* const sink) {
+  run(sink);
+}
+
+void ShardedSolver::make_prefixes() {
+  const int* search_order = board->get_search_order();
+  prefix_squares.assign(search_order, search_order + prefix_length);
+  prefixes.clear();
+  if (prefix_length == 0) {
+    prefixes.push_back(std::vector<int>());
+    return;
+  }
+  PrefixSink sink(prefix_squares, &prefixes);
+  board->find_all_solutions(&prefix_squares[0], prefix_length, &sink);
+}
+
+unsigned long long ShardedSolver::run(SolutionSink* const sink) {
+  make_prefixes();
+  queue.clear();
+  for (size_t i = 0; i < prefixes.size(); i++) {
+    queue.push_back(i);
+  }
+  attempts.assign(prefixes.size(), 0);
+  number_of_lost_workers = 0;
+  number_of_failed_shards = 0;
+  bool find_all = (sink != NULL);
+
+  workers.assign(
+      std::min(static_cast<size_t>(number_of_workers), prefixes.size()),
+      Worker());
+  for (size_t i = 0; i < workers.size(); i++) {
+    workers[i].pid = -1;
+    workers[i].socket = -1;
+    workers[i].shard = -1;
+  }
+  for (size_t i = 0; i < workers.size(); i++) {
+    start_worker(&workers[i], find_all);
+  }
+
+  Board* solution = board->copy();
+  int number_of_squares = board->get_number_of_squares();
+  std::vector<int32_t> state_indices(number_of_squares);
+  unsigned long long count = 0;
+  bool is_stopped = false;
+  while (!is_stopped) {
+    // Hand the waiting shards to the idle workers.
+    std::vector<pollfd> polls;
+    std::vector<Worker*> busy;
+    for (size_t i = 0; i < workers.size(); i++) {
+      Worker* worker = &workers[i];
+      while (worker->pid != -1 && worker->shard == -1 && !queue.empty()) {
+        int shard = queue.front();
+        queue.erase(queue.begin());
+        worker->shard = shard;
+        Task task = {shard, attempts[shard]};
+        if (!send_all(worker->socket, &task, sizeof(task))) {
+          lose_worker(worker);
+          start_worker(worker, find_all);
+        }
+      }
+      if (worker->shard != -1) {
+        pollfd poll_entry = {worker->socket, POLLIN, 0};
+        polls.push_back(poll_entry);
+        busy.push_back(worker);
+      }
+    }
+    if (busy.empty()) {
+      // Every shard is done, or there is no worker left to take the rest.
+      number_of_failed_shards += queue.size();
+      queue.clear();
+      break;
+    }
+
+    if (poll(&polls[0], polls.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+
+    for (size_t i = 0; i < busy.size() && !is_stopped; i++) {
+      if (polls[i].revents == 0) {
+        continue;
+      }
+      Worker* worker = busy[i];
+      Message message;
+      if (!receive_all(worker->socket, &message, sizeof(message)) ||
+          message.shard != worker->shard) {
+        lose_worker(worker);
+        start_worker(worker, find_all);
+        continue;
+      }
+
+      if (message.type == MESSAGE_SOLUTION) {
+        if (!receive_all(worker->socket,
+                         &state_indices[0],
+                         number_of_squares * sizeof(int32_t))) {
+          lose_worker(worker);
+          start_worker(worker, find_all);
+          continue;
+        }
+        worker->solutions.insert(worker->solutions.end(),
+                                 state_indices.begin(),
+                                 state_indices.end());
+        continue;
+      }
+
+      // The shard is done: only now do its solutions count.
+      if (find_all) {
+        for (size_t j = 0;
+             j < worker->solutions.size() && !is_stopped;
+             j += number_of_squares) {
+          for (int k = 0; k < number_of_squares; k++) {
+            solution->set_state_index(k, worker->solutions[j + k]);
+          }
+          is_stopped = !sink->add_solution(solution);
+        }
+      } else {
+        count = saturating_add(count, message.count);
+      }
+      worker->solutions.clear();
+      worker->shard = -1;
+    }
+  }
+  delete solution;
+
+  for (size_t i = 0; i < workers.size(); i++) {
+    stop_worker(&workers[i]);
+  }
+  workers.clear();
+  return count;
+}
+
+bool ShardedSolver::start_worker(Worker* worker, bool find_all) {
+  worker->pid = -1;
+  worker->socket = -1;
+  worker->shard = -1;
+  worker->solutions.clear();
+
+  int sockets[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+    return false;
+  }
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(sockets[0]);
+    close(sockets[1]);
+    return false;
+  }
+  if (pid == 0) {
+    // Holding the sockets of the other workers would keep them from seeing
+    // the coordinator close them.
+    close(sockets[0]);
+    for (size_t i = 0; i < workers.size(); i++) {
+      if (workers[i].socket != -1) {
+        close(workers[i].socket);
+      }
+    }
+    work(sockets[1], find_all);
+  }
+  close(sockets[1]);
+  worker->pid = pid;
+  worker->socket = sockets[0];
+  return true;
+}
+
+void ShardedSolver::work(int socket, bool find_all) {
+  // Searches never report to anything of the coordinator.
+  Board* base = board->copy();
+  base->set_progress_listener(NULL, 0);
+  base->set_search_trace(NULL);
+  base->set_stop_flag(NULL);
+
+  int number_of_squares = board->get_number_of_squares();
+  std::vector<int> all_squares(number_of_squares);
+  for (int i = 0; i < number_of_squares; i++) {
+    all_squares[i] = i;
+  }
+
+  Task task;
+  while (receive_all(socket, &task, sizeof(task)) && task.shard >= 0) {
+    Board* shard_board = base->copy();
+    bool is_consistent = true;
+    for (int i = 0; i < prefix_length && is_consistent; i++) {
+      is_consistent = shard_board->restrict_domain(
+          prefix_squares[i], single_state_domain(prefixes[task.shard][i]));
+    }
+
+    Message done = {MESSAGE_DONE, task.shard, 0};
+    if (is_consistent) {
+      if (find_all) {
+        SocketSink sink(socket, task.shard);
+        shard_board->find_all_solutions(&all_squares[0],
+                                        number_of_squares,
+                                        &sink);
+      } else {
+        done.count = shard_board->count_solutions();
+      }
+    }
+    delete shard_board;
+
+    if (task.shard == crash_shard && task.attempt == 0) {
+      _exit(1);
+    }
+    if (!send_all(socket, &done, sizeof(done))) {
+      break;
+    }
+  }
+  _exit(0);
+}
+
+void ShardedSolver::lose_worker(Worker* worker) {
+  stop_worker(worker);
+  number_of_lost_workers++;
+  if (worker->shard != -1) {
+    int shard = worker->shard;
+    attempts[shard]++;
+    if (attempts[shard] >= MAX_ATTEMPTS) {
+      number_of_failed_shards++;
+    } else {
+      queue.insert(queue.begin(), shard);
+    }
+  }
+  worker->shard = -1;
+  worker->solutions.clear();
+}
+
+void ShardedSolver::stop_worker(Worker* worker) {
+  if (worker->pid == -1) {
+    return;
+  }
+  // Closing the socket tells an idle worker to exit; a busy one is killed.
+  close(worker->socket);
+  if (worker->shard != -1) {
+    kill(worker->pid, SIGKILL);
+  }
+  waitpid(worker->pid, NULL, 0);
+  worker->pid = -1;
+  worker->socket = -1;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
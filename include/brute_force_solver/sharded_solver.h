@@ -0,0 +1,154 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Splits the search of a Board between worker processes on the same machine,
+// for searches too large for the memory of one process, or that should not
+// take the caller down if they crash.
+//
+// The coordinator, in the calling process, enumerates the ways to fill in the
+// first |prefix_length| squares of the search order; each is a shard, the
+// subtree below that prefix. It then forks the workers, each connected to it
+// by a Unix domain socket pair, and hands out the shards one at a time, so a
+// worker that finishes early takes the next shard and the load balances
+// itself. Workers inherit the board and its constraints with the rest of the
+// memory of the process, so only shard numbers and results cross the
+// sockets.
+//
+// A worker that dies, or closes its socket, loses only its current shard: the
+// coordinator discards what that shard reported so far, puts it back at the
+// front of the queue, and forks a replacement. A shard is given up after
+// MAX_ATTEMPTS lost workers, and is_complete() then returns false.
+//
+// Solutions reach the sink in the calling process, a whole shard at a time,
+// once the worker reports the shard done. Fork only copies the calling
+// thread, so the solver should run while no other thread of the process
+// holds a lock; the workers do not record traces or report progress.
+// -----------------------------------------------------------------------------
+
+#ifndef _SHARDED_SOLVER_H_
+#define _SHARDED_SOLVER_H_
+
+#include <sys/types.h>
+
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+class SolutionSink;
+
+class ShardedSolver {
+ public:
+  // The board must outlive the solver.
+  ShardedSolver(const Board* const board,
+                int number_of_workers,
+                int prefix_length);
+  ~ShardedSolver();
+
+  // Makes the first worker to run shard |shard| exit before reporting it
+  // done, to check that losing a worker is survived; -1 turns this off.
+  void set_crash_injection(int shard) {
+    crash_shard = shard;
+  }
+
+  // Returns the number of solutions of the board, as Board::count_solutions()
+  // does, summed over the shards that finished.
+  unsigned long long count_solutions();
+
+  // Passes every solution of the board to |sink|, until the sink stops the
+  // search.
+  void find_all_solutions(SolutionSink* const sink);
+
+  // The number of shards of the last search.
+  int get_number_of_shards() const {
+    return prefixes.size();
+  }
+
+  // The number of workers of the last search that died or closed their
+  // socket before their shard was done.
+  int get_number_of_lost_workers() const {
+    return number_of_lost_workers;
+  }
+
+  // Returns true if every shard of the last search finished, or the sink
+  // stopped it.
+  bool is_complete() const {
+    return number_of_failed_shards == 0;
+  }
+
+  // A shard is given up after this many workers are lost on it.
+  static const int MAX_ATTEMPTS = 3;
+
+ private:
+  struct Worker {
+    pid_t pid;
+    int socket;
+    // The shard being searched, or -1 if idle.
+    int shard;
+    // The solutions the shard has reported so far, one state index per
+    // square.
+    std::vector<int> solutions;
+  };
+
+  // Fills in |prefixes| from the first |prefix_length| squares of the search
+  // order.
+  void make_prefixes();
+
+  // Runs the coordinator, counting the solutions if |sink| is NULL, and
+  // passing them to |sink| otherwise. Returns the count.
+  unsigned long long run(SolutionSink* const sink);
+
+  // Forks a worker. Returns false, and leaves the worker stopped, if it
+  // cannot.
+  bool start_worker(Worker* worker, bool find_all);
+
+  // Runs in the worker process; never returns.
+  void work(int socket, bool find_all);
+
+  // Waits for a lost worker, and queues its shard again.
+  void lose_worker(Worker* worker);
+
+  void stop_worker(Worker* worker);
+
+  const Board* const board;
+  const int number_of_workers;
+  const int prefix_length;
+  int crash_shard;
+
+  // The squares of the prefixes, and the state index of each, by shard.
+  std::vector<int> prefix_squares;
+  std::vector<std::vector<int> > prefixes;
+
+  // The shards waiting for a worker, and the workers lost on each shard.
+  std::vector<int> queue;
+  std::vector<int> attempts;
+
+  std::vector<Worker> workers;
+
+  int number_of_lost_workers;
+  int number_of_failed_shards;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _SHARDED_SOLVER_H_
@@ -0,0 +1,139 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/solution_generator.h"
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/search_trace.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+SolutionGenerator::SolutionGenerator(const Board* const board) :
+    board(board->copy()),
+    squares(board->get_search_order(),
+            board->get_search_order() + board->get_number_of_squares()),
+    is_started(false),
+    is_finished(false) {
+}
+
+SolutionGenerator::~SolutionGenerator() {
+  if (is_started && !is_finished) {
+    finish();
+  }
+  delete board;
+}
+
+bool SolutionGenerator::next() {
+  if (is_finished) {
+    return false;
+  }
+  if (!is_started) {
+    is_started = true;
+    board->start_search();
+    if (!board->propagate()) {
+      return finish();
+    }
+    if (squares.empty()) {
+      // The board is its own solution, and the only one.
+      board->trace(TRACE_SOLUTION, -1, 0, 0);
+      return true;
+    }
+    push(0);
+  }
+
+  int number_of_states = board->state_list->get_number_of_states();
+  while (!path.empty()) {
+    Frame* frame = &path.back();
+    int square = squares[frame->index];
+    if (frame->is_descended) {
+      // Everything below the last state tried has been searched.
+      board->trace(TRACE_BACKTRACK, square,
+                   board->get_state_to_try(frame->next_position - 1),
+                   frame->index);
+      frame->is_descended = false;
+    }
+    board->undo(frame->trail_size);
+
+    int position = frame->next_position;
+    while (position < number_of_states &&
+           !domain_contains(frame->domain, board->get_state_to_try(position))) {
+      position++;
+    }
+    if (position == number_of_states) {
+      path.pop_back();
+      continue;
+    }
+    frame->next_position = position + 1;
+    int state = board->get_state_to_try(position);
+
+    if (!board->count_node()) {
+      return finish();
+    }
+    board->track_progress(frame->index,
+                          frame->child++,
+                          domain_size(frame->domain));
+    board->assign(square, state);
+    board->trace(TRACE_ASSIGN, square, state, frame->index);
+    if (!board->is_consistent(frame->index)) {
+      board->trace(TRACE_REJECT, square, state, frame->index);
+      continue;
+    }
+
+    frame->is_descended = true;
+    if (frame->index + 1 == squares.size()) {
+      // Stop here; the next call backtracks from this solution.
+      board->trace(TRACE_SOLUTION, -1, 0, squares.size());
+      return true;
+    }
+    push(frame->index + 1);
+  }
+  return finish();
+}
+
+unsigned long long SolutionGenerator::get_number_of_nodes() const {
+  return board->number_of_nodes;
+}
+
+void SolutionGenerator::push(size_t index) {
+  Frame frame;
+  frame.index = index;
+  frame.domain = board->domains[squares[index]];
+  frame.next_position = 0;
+  frame.child = 0;
+  frame.trail_size = board->trail.size();
+  frame.is_descended = false;
+  path.push_back(frame);
+}
+
+bool SolutionGenerator::finish() {
+  is_finished = true;
+  path.clear();
+  board->finish_search();
+  return false;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
@@ -0,0 +1,139 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Produces the solutions of a Board one at a time, on demand, on the thread
+// that asks for them.
+//
+// The generator runs the same search as Board::find_all_solutions(), but keeps
+// its path on an explicit stack instead of the call stack, so it can stop
+// after each solution and carry on from there on the next call to next().
+// Nothing runs between calls, so a front end or a pipeline stage can take as
+// many solutions as it wants without a thread per search:
+//
+//   SolutionGenerator solutions(&board);
+//   for (const Board* solution : solutions) {
+//     solution->pretty_print();
+//   }
+// -----------------------------------------------------------------------------
+
+#ifndef _SOLUTION_GENERATOR_H_
+#define _SOLUTION_GENERATOR_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "include/brute_force_solver/domain.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+class SolutionGenerator {
+ public:
+  // Searches a copy of |board|, which must outlive the generator. The copy
+  // keeps the node limit, stop flag, progress listener and trace of the
+  // board.
+  explicit SolutionGenerator(const Board* const board);
+  ~SolutionGenerator();
+
+  // Moves on to the next solution. Returns false once there are no more, or
+  // the search stopped at its node limit or stop flag.
+  bool next();
+
+  // The current solution, which the next call to next() changes. Only valid
+  // after next() returns true.
+  const Board* get_solution() const {
+    return board;
+  }
+
+  // The number of nodes searched so far.
+  unsigned long long get_number_of_nodes() const;
+
+  // Walks the solutions that are left, calling next() as it goes.
+  class Iterator {
+   public:
+    explicit Iterator(SolutionGenerator* const generator) :
+        generator(generator) {
+    }
+
+    const Board* operator*() const {
+      return generator->get_solution();
+    }
+
+    Iterator& operator++() {
+      if (!generator->next()) {
+        generator = NULL;
+      }
+      return *this;
+    }
+
+    bool operator!=(const Iterator& other) const {
+      return generator != other.generator;
+    }
+
+   private:
+    // NULL once there are no solutions left.
+    SolutionGenerator* generator;
+  };
+
+  Iterator begin() {
+    return next() ? Iterator(this) : end();
+  }
+
+  Iterator end() {
+    return Iterator(NULL);
+  }
+
+ private:
+  // A square on the path of the search: its position in the search order,
+  // its domain when the search reached it, the position in the value order
+  // of the next state to try, the number of states tried, the size of the
+  // trail before the first try, and whether the search went below the last
+  // state tried.
+  struct Frame {
+    size_t index;
+    Domain domain;
+    int next_position;
+    int child;
+    size_t trail_size;
+    bool is_descended;
+  };
+
+  // Adds the square at |index| of the search order to the path.
+  void push(size_t index);
+
+  // Ends the search. Returns false.
+  bool finish();
+
+  Board* const board;
+  std::vector<int> squares;
+  std::vector<Frame> path;
+
+  bool is_started;
+  bool is_finished;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _SOLUTION_GENERATOR_H_
@@ -0,0 +1,273 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/solution_writer.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+const char SOLUTION_MAGIC[8] = {'B', 'F', 'S', 'O', 'L', 'V', 'E', '1'};
+
+SolutionWriter::SolutionWriter(FILE* const file,
+                               SolutionFormat format,
+                               int items_per_line) :
+    file(file),
+    format(format),
+    items_per_line(items_per_line),
+    is_ok(true),
+    number_of_solutions(0),
+    number_of_squares(0),
+    bits_per_square(0) {
+  buffer.reserve(BUFFER_SIZE + BUFFER_SIZE / 4);
+}
+
+SolutionWriter::~SolutionWriter() {
+  flush();
+}
+
+bool SolutionWriter::write(const Board* const board) {
+  if (!is_ok) {
+    return false;
+  }
+  if (number_of_solutions == 0) {
+    start(board);
+  }
+  assert(board->get_number_of_squares() == number_of_squares);
+  number_of_solutions++;
+
+  switch (format) {
+    case SOLUTION_FORMAT_TEXT: {
+      // The number of items written on the current line.
+      int line_counter = 0;
+      for (int i = 0; i < number_of_squares; i++) {
+        if (line_counter != 0) {
+          write_byte(' ');
+        }
+        const std::string& string =
+            state_strings[board->get_state_index(i) + 1];
+        write_bytes(string.data(), string.size());
+        line_counter++;
+        if (line_counter == items_per_line) {
+          write_byte('\n');
+          line_counter = 0;
+        }
+      }
+      if (items_per_line == 0) {
+        write_byte('\n');
+      }
+      break;
+    }
+
+    case SOLUTION_FORMAT_PACKED: {
+      uint32_t bits = 0;
+      int number_of_bits = 0;
+      for (int i = 0; i < number_of_squares; i++) {
+        bits |= static_cast<uint32_t>(board->get_state_index(i) + 1) <<
+                number_of_bits;
+        number_of_bits += bits_per_square;
+        while (number_of_bits >= 8) {
+          write_byte(bits & 0xff);
+          bits >>= 8;
+          number_of_bits -= 8;
+        }
+      }
+      if (number_of_bits > 0) {
+        write_byte(bits);
+      }
+      break;
+    }
+
+    case SOLUTION_FORMAT_DELTA: {
+      uint32_t number_of_changes = 0;
+      for (int i = 0; i < number_of_squares; i++) {
+        if (board->get_state_index(i) + 1 != previous[i]) {
+          number_of_changes++;
+        }
+      }
+      write_varint(number_of_changes);
+      int last_change = -1;
+      for (int i = 0; i < number_of_squares; i++) {
+        int value = board->get_state_index(i) + 1;
+        if (value != previous[i]) {
+          write_varint(i - last_change - 1);
+          write_varint(value);
+          previous[i] = value;
+          last_change = i;
+        }
+      }
+      break;
+    }
+  }
+
+  if (buffer.size() >= BUFFER_SIZE) {
+    return flush();
+  }
+  return true;
+}
+
+bool SolutionWriter::flush() {
+  if (is_ok && !buffer.empty() &&
+      fwrite(&buffer[0], 1, buffer.size(), file) != buffer.size()) {
+    is_ok = false;
+  }
+  buffer.clear();
+  return is_ok;
+}
+
+void SolutionWriter::start(const Board* const board) {
+  const StateList* state_list = board->get_state_list();
+  int number_of_states = state_list->get_number_of_states();
+  number_of_squares = board->get_number_of_squares();
+  bits_per_square = 1;
+  while ((1 << bits_per_square) <= number_of_states) {
+    bits_per_square++;
+  }
+  state_strings.push_back(EMPTY->get_pretty_print_string());
+  for (int i = 0; i < number_of_states; i++) {
+    state_strings.push_back(
+        state_list->get_state(i)->get_pretty_print_string());
+  }
+  previous.assign(number_of_squares, 0);
+
+  if (format != SOLUTION_FORMAT_TEXT) {
+    write_bytes(SOLUTION_MAGIC, sizeof(SOLUTION_MAGIC));
+    write_byte(format);
+    write_byte(bits_per_square);
+    for (int i = 0; i < 4; i++) {
+      write_byte((number_of_squares >> (8 * i)) & 0xff);
+    }
+  }
+}
+
+void SolutionWriter::write_varint(uint32_t value) {
+  while (value >= 0x80) {
+    write_byte((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  write_byte(value);
+}
+
+SolutionReader::SolutionReader(FILE* const file) :
+    file(file),
+    format(SOLUTION_FORMAT_TEXT),
+    bits_per_square(0),
+    number_of_squares(-1) {
+  uint8_t header[sizeof(SOLUTION_MAGIC) + 6];
+  if (fread(header, sizeof(header), 1, file) != 1 ||
+      memcmp(header, SOLUTION_MAGIC, sizeof(SOLUTION_MAGIC)) != 0) {
+    return;
+  }
+  const uint8_t* fields = header + sizeof(SOLUTION_MAGIC);
+  if ((fields[0] != SOLUTION_FORMAT_PACKED &&
+       fields[0] != SOLUTION_FORMAT_DELTA) ||
+      fields[1] == 0 || fields[1] > 8) {
+    return;
+  }
+  format = static_cast<SolutionFormat>(fields[0]);
+  bits_per_square = fields[1];
+  int32_t squares = 0;
+  for (int i = 0; i < 4; i++) {
+    squares |= static_cast<int32_t>(fields[2 + i]) << (8 * i);
+  }
+  if (squares < 0) {
+    return;
+  }
+  number_of_squares = squares;
+  record.resize((number_of_squares * bits_per_square + 7) / 8);
+  current.assign(number_of_squares, 0);
+}
+
+bool SolutionReader::read(int* const state_indices) {
+  if (!is_valid()) {
+    return false;
+  }
+
+  if (format == SOLUTION_FORMAT_PACKED) {
+    if (!record.empty() && fread(&record[0], record.size(), 1, file) != 1) {
+      return false;
+    }
+    uint32_t bits = 0;
+    int number_of_bits = 0;
+    size_t next_byte = 0;
+    for (int i = 0; i < number_of_squares; i++) {
+      while (number_of_bits < bits_per_square) {
+        bits |= static_cast<uint32_t>(record[next_byte++]) << number_of_bits;
+        number_of_bits += 8;
+      }
+      current[i] = bits & ((1u << bits_per_square) - 1);
+      bits >>= bits_per_square;
+      number_of_bits -= bits_per_square;
+    }
+  } else {
+    uint32_t number_of_changes = 0;
+    if (!read_varint(&number_of_changes)) {
+      return false;
+    }
+    int square = -1;
+    for (uint32_t i = 0; i < number_of_changes; i++) {
+      uint32_t gap = 0;
+      uint32_t value = 0;
+      if (!read_varint(&gap) || !read_varint(&value)) {
+        return false;
+      }
+      // A corrupt gap could step past the last square, or wrap around.
+      if (gap >= static_cast<uint32_t>(number_of_squares - 1 - square)) {
+        return false;
+      }
+      square += gap + 1;
+      current[square] = value;
+    }
+  }
+
+  for (int i = 0; i < number_of_squares; i++) {
+    state_indices[i] = current[i] - 1;
+  }
+  return true;
+}
+
+bool SolutionReader::read_varint(uint32_t* value) {
+  *value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    int byte = fgetc(file);
+    if (byte == EOF) {
+      return false;
+    }
+    *value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
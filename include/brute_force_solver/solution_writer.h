@@ -0,0 +1,173 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Writes solutions to a file through a buffer of its own, so that enumerating
+// millions of solutions costs a write per buffer instead of a printf per
+// square. The formats are:
+//
+// SOLUTION_FORMAT_TEXT    The pretty print strings of the squares, as
+//                         Board::pretty_print() prints them.
+// SOLUTION_FORMAT_PACKED  Every square as its state index plus one (0 for
+//                         EMPTY), in the fewest bits that hold every state,
+//                         least significant bit first. Each solution starts
+//                         on a new byte.
+// SOLUTION_FORMAT_DELTA   The squares that differ from the previous solution
+//                         (all EMPTY before the first), as a varint count,
+//                         then for each square a varint of the gap since the
+//                         previous changed square and a varint of its new
+//                         state index plus one. Solutions enumerated in
+//                         search order mostly differ in their last few
+//                         squares, so this is much smaller than packing.
+//
+// The binary formats start with a header: the 8 bytes of SOLUTION_MAGIC, a
+// byte with the format, a byte with the bits per square, and the number of
+// squares as a 4 byte little-endian integer. SolutionReader reads them back.
+// -----------------------------------------------------------------------------
+
+#ifndef _SOLUTION_WRITER_H_
+#define _SOLUTION_WRITER_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "include/brute_force_solver/solution_sink.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+// The first bytes of a file in a binary format.
+extern const char SOLUTION_MAGIC[8];
+
+enum SolutionFormat {
+  SOLUTION_FORMAT_TEXT = 0,
+  SOLUTION_FORMAT_PACKED = 1,
+  SOLUTION_FORMAT_DELTA = 2,
+};
+
+class SolutionWriter : public SolutionSink {
+ public:
+  // Writes to |file|, which the writer does not close. Text puts
+  // |items_per_line| squares on each line, or all of them on one line if it
+  // is 0; the binary formats ignore it.
+  SolutionWriter(FILE* const file, SolutionFormat format, int items_per_line);
+
+  // Flushes the buffer.
+  virtual ~SolutionWriter();
+
+  // Writes the squares of |board|. All boards written must have the same
+  // number of squares and StateList.
+  // Returns false if the file cannot be written.
+  bool write(const Board* const board);
+
+  // Writes each solution; stops the search if the file cannot be written.
+  virtual bool add_solution(const Board* const board) {
+    return write(board);
+  }
+
+  // Writes out the buffer. Returns false if the file cannot be written.
+  bool flush();
+
+  unsigned long long get_number_of_solutions() const {
+    return number_of_solutions;
+  }
+
+ private:
+  // The buffer is written out once it holds this many bytes.
+  static const size_t BUFFER_SIZE = 1 << 16;
+
+  // Learns the squares and states from the first board, and writes the
+  // header of the binary formats.
+  void start(const Board* const board);
+
+  void write_byte(uint8_t byte) {
+    buffer.push_back(byte);
+  }
+
+  void write_bytes(const char* bytes, size_t size) {
+    buffer.insert(buffer.end(), bytes, bytes + size);
+  }
+
+  void write_varint(uint32_t value);
+
+  FILE* const file;
+  const SolutionFormat format;
+  const int items_per_line;
+
+  std::vector<char> buffer;
+  bool is_ok;
+  unsigned long long number_of_solutions;
+
+  // The number of squares and bits per square of the first board, and the
+  // pretty print string of each state index plus one.
+  int number_of_squares;
+  int bits_per_square;
+  std::vector<std::string> state_strings;
+
+  // The state indices plus one of the previous solution, for deltas.
+  std::vector<int> previous;
+};
+
+// Reads the solutions of a file in a binary format of SolutionWriter.
+class SolutionReader {
+ public:
+  // Reads from |file|, which the reader does not close, starting with the
+  // header.
+  explicit SolutionReader(FILE* const file);
+
+  // Returns false if the file does not start with a valid header.
+  bool is_valid() const {
+    return number_of_squares >= 0;
+  }
+
+  int get_number_of_squares() const {
+    return number_of_squares;
+  }
+
+  SolutionFormat get_format() const {
+    return format;
+  }
+
+  // Reads the next solution into |state_indices|, one per square, with -1
+  // for EMPTY squares. Returns false at the end of the file, or if it is
+  // cut short.
+  bool read(int* const state_indices);
+
+ private:
+  bool read_varint(uint32_t* value);
+
+  FILE* const file;
+  SolutionFormat format;
+  int bits_per_square;
+  int number_of_squares;
+
+  std::vector<uint8_t> record;
+  std::vector<int> current;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _SOLUTION_WRITER_H_
@@ -0,0 +1,99 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/solve_handle.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/progress_listener.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+SolveHandle::SolveHandle(const Board* const board, double progress_interval) :
+    board(board->copy()),
+    listener(this),
+    is_cancelled(false),
+    is_finished(false),
+    solution(NULL) {
+  memset(&progress, 0, sizeof(progress));
+  this->board->set_progress_listener(&listener, progress_interval);
+  this->board->set_stop_flag(&is_cancelled);
+  thread = std::thread(&SolveHandle::run, this);
+}
+
+SolveHandle::~SolveHandle() {
+  cancel();
+  thread.join();
+  delete solution;
+  delete board;
+}
+
+bool SolveHandle::is_done() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return is_finished;
+}
+
+void SolveHandle::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this]() { return is_finished; });
+}
+
+bool SolveHandle::wait_for(double seconds) {
+  std::unique_lock<std::mutex> lock(mutex);
+  return done.wait_for(lock,
+                       std::chrono::duration<double>(seconds),
+                       [this]() { return is_finished; });
+}
+
+SearchProgress SolveHandle::get_progress() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return progress;
+}
+
+Board* SolveHandle::take_solution() {
+  wait();
+  std::lock_guard<std::mutex> lock(mutex);
+  Board* result = solution;
+  solution = NULL;
+  return result;
+}
+
+void SolveHandle::Listener::report(const SearchProgress& progress) {
+  std::lock_guard<std::mutex> lock(handle->mutex);
+  handle->progress = progress;
+}
+
+void SolveHandle::run() {
+  Board* result = board->find_solution();
+  std::lock_guard<std::mutex> lock(mutex);
+  solution = result;
+  is_finished = true;
+  done.notify_all();
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
@@ -0,0 +1,122 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Runs Board::find_solution() on a thread of its own, so that the caller can
+// go on with other work, and check on the search when it likes:
+//
+//   SolveHandle handle(&board);
+//   while (!handle.wait_for(1.0)) {
+//     SearchProgress progress = handle.get_progress();
+//     ...
+//   }
+//   Board* solution = handle.take_solution();
+//
+// Cancelling sets the stop flag of the search, which gives up at its next
+// node. The handle cancels and waits for the search when it is destroyed.
+// -----------------------------------------------------------------------------
+
+#ifndef _SOLVE_HANDLE_H_
+#define _SOLVE_HANDLE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "include/brute_force_solver/progress_listener.h"
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+class Board;
+
+class SolveHandle {
+ public:
+  // Starts searching a copy of |board|, which may be changed or destroyed
+  // once the constructor returns; its constraints must outlive the handle.
+  // The search reports its progress about every |progress_interval|
+  // seconds.
+  explicit SolveHandle(const Board* const board,
+                       double progress_interval = 0.1);
+  ~SolveHandle();
+
+  // Returns true if the search has ended.
+  bool is_done() const;
+
+  // Waits for the search to end.
+  void wait();
+
+  // Waits for at most |seconds| for the search to end. Returns true if it
+  // has ended.
+  bool wait_for(double seconds);
+
+  // Tells the search to stop; it ends soon after, with no solution unless
+  // it had just found one.
+  void cancel() {
+    is_cancelled = true;
+  }
+
+  bool was_cancelled() const {
+    return is_cancelled;
+  }
+
+  // Returns the last progress report of the search, which is all zeros until
+  // the first report.
+  SearchProgress get_progress() const;
+
+  // Waits for the search to end, and returns the solution it found, or NULL
+  // if there is none, the search was cancelled first, or the solution was
+  // already taken. The caller is responsible for freeing the pointer, if it is
+  // non-NULL.
+  Board* take_solution();
+
+ private:
+  // Keeps the last report of the search.
+  class Listener : public ProgressListener {
+   public:
+    explicit Listener(SolveHandle* const handle) : handle(handle) {
+    }
+
+    virtual void report(const SearchProgress& progress);
+
+   private:
+    SolveHandle* const handle;
+  };
+
+  void run();
+
+  Board* const board;
+  Listener listener;
+  std::atomic<bool> is_cancelled;
+
+  mutable std::mutex mutex;
+  std::condition_variable done;
+  bool is_finished;
+  Board* solution;
+  SearchProgress progress;
+
+  std::thread thread;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _SOLVE_HANDLE_H_
@@ -0,0 +1,114 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/brute_force_solver/spill_buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+SpillBuffer::SpillBuffer(size_t record_size,
+                         size_t memory_cap,
+                         const char* const spill_directory) :
+    record_size(record_size),
+    memory_cap(memory_cap),
+    spill_directory(spill_directory),
+    number_of_records(0),
+    file(-1),
+    mapped(NULL),
+    mapped_size(0) {
+}
+
+SpillBuffer::~SpillBuffer() {
+  if (mapped != NULL) {
+    munmap(mapped, mapped_size);
+  }
+  if (file != -1) {
+    close(file);
+  }
+}
+
+bool SpillBuffer::append(const void* const record) {
+  size_t used = number_of_records * record_size;
+  if (mapped == NULL && used + record_size > memory_cap) {
+    // Move the records to the file.
+    if (!map_file(std::max(2 * (used + record_size), memory_cap))) {
+      return false;
+    }
+    memcpy(mapped, memory.data(), used);
+    std::vector<unsigned char>().swap(memory);
+  }
+
+  if (mapped != NULL) {
+    if (used + record_size > mapped_size &&
+        !map_file(2 * (used + record_size))) {
+      return false;
+    }
+    memcpy(mapped + used, record, record_size);
+  } else {
+    const unsigned char* bytes = static_cast<const unsigned char*>(record);
+    memory.insert(memory.end(), bytes, bytes + record_size);
+  }
+  number_of_records++;
+  return true;
+}
+
+bool SpillBuffer::map_file(size_t bytes) {
+  if (file == -1) {
+    std::string path = spill_directory + "/spill_buffer_XXXXXX";
+    std::vector<char> path_template(path.begin(), path.end());
+    path_template.push_back('\0');
+    file = mkstemp(path_template.data());
+    if (file == -1) {
+      return false;
+    }
+    // The file goes away once it is closed.
+    unlink(path_template.data());
+  }
+
+  // Round up to whole pages.
+  size_t page_size = sysconf(_SC_PAGESIZE);
+  bytes = (bytes + page_size - 1) / page_size * page_size;
+  if (ftruncate(file, bytes) != 0) {
+    return false;
+  }
+  void* new_mapping =
+      mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+  if (new_mapping == MAP_FAILED) {
+    return false;
+  }
+  if (mapped != NULL) {
+    munmap(mapped, mapped_size);
+  }
+  mapped = static_cast<unsigned char*>(new_mapping);
+  mapped_size = bytes;
+  return true;
+}
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
@@ -0,0 +1,80 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef _SPILL_BUFFER_H_
+#define _SPILL_BUFFER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+namespace lib_kxing {
+namespace brute_force_solver {
+
+// An array of fixed-size records. It is kept in memory until it holds more
+// than |memory_cap| bytes, and is then moved to a memory-mapped temporary file
+// in |spill_directory|, which is deleted with the buffer.
+class SpillBuffer {
+ public:
+  SpillBuffer(size_t record_size,
+              size_t memory_cap,
+              const char* const spill_directory);
+  ~SpillBuffer();
+
+  // Copies |record_size| bytes from |record| to the end of the buffer.
+  // Returns false if the temporary file could not be created or grown.
+  bool append(const void* const record);
+
+  // The pointer is only valid until the next append().
+  const unsigned char* get(size_t i) const {
+    return ((mapped != NULL) ? mapped : memory.data()) + i * record_size;
+  }
+
+  size_t size() const {
+    return number_of_records;
+  }
+
+  bool is_spilled() const {
+    return mapped != NULL;
+  }
+
+ private:
+  // Maps at least |bytes| bytes of the temporary file, creating the file if
+  // needed.
+  bool map_file(size_t bytes);
+
+  const size_t record_size;
+  const size_t memory_cap;
+  const std::string spill_directory;
+
+  size_t number_of_records;
+  std::vector<unsigned char> memory;
+
+  // The temporary file, or -1, and its mapping, or NULL.
+  int file;
+  unsigned char* mapped;
+  size_t mapped_size;
+};
+
+}  // namespace brute_force_solver
+}  // namespace lib_kxing
+
+#endif  // _SPILL_BUFFER_H_
@@ -20,6 +20,8 @@
 
 #include "include/brute_force_solver/state_list.h"
 
+#include <assert.h>
+
 #include "include/brute_force_solver/state.h"
 
 namespace lib_kxing {
@@ -32,6 +34,20 @@ StateList::StateList(const State* const * const states, int number_of_states) :
 StateList::~StateList() {
 }
 
+int StateList::index_of(const State* const state) const {
+  if (state == EMPTY) {
+    return -1;
+  }
+
+  for (int i = 0; i < number_of_states; i++) {
+    if (states[i] == state) {
+      return i;
+    }
+  }
+  assert(false);
+  return -1;
+}
+
 #ifndef NDEBUG
 bool StateList::is_valid_state(const State* const state) const {
   if (state == EMPTY) {
@@ -39,6 +39,10 @@ class StateList {
     return states[index];
   }
 
+  // Returns the index of |state| in the list, or -1 if |state| is EMPTY.
+  // This is a linear scan.
+  int index_of(const State* const state) const;
+
   #ifndef NDEBUG
   bool is_valid_state(const State* const state) const;
   #endif
@@ -0,0 +1,287 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/dictionary/trie.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace lib_kxing {
+namespace dictionary {
+
+namespace {
+
+const char MAGIC[8] = {'K', 'X', 'T', 'R', 'I', 'E', '1', '\0'};
+
+struct SavedTrieHeader {
+  char magic[8];
+  unsigned int number_of_nodes;
+  unsigned int reserved;
+};
+
+// Appends the upper-cased word in [start, end) to |words|, unless it contains
+// characters other than letters.
+void add_word(const char* start, const char* end,
+              std::vector<std::string>* words) {
+  // Tolerate DOS line endings.
+  while (end > start && (end[-1] == '\r' || end[-1] == ' ')) {
+    end--;
+  }
+  if (start == end) {
+    return;
+  }
+
+  std::string word(start, end);
+  for (size_t i = 0; i < word.size(); i++) {
+    if (!isalpha(static_cast<unsigned char>(word[i]))) {
+      return;
+    }
+    word[i] = toupper(static_cast<unsigned char>(word[i]));
+  }
+  words->push_back(word);
+}
+
+void add_words(const char* text, size_t length,
+               std::vector<std::string>* words) {
+  const char* end = text + length;
+  const char* line = text;
+  while (line < end) {
+    const char* newline =
+        static_cast<const char*>(memchr(line, '\n', end - line));
+    if (newline == NULL) {
+      newline = end;
+    }
+    add_word(line, newline, words);
+    line = newline + 1;
+  }
+}
+
+// Builds the nodes from the words, which are sorted and deduplicated in
+// place. Nodes are created in breadth-first order, so that the children of
+// each node are contiguous and every child has a larger index than its parent.
+TrieNode* build_nodes(std::vector<std::string>* word_list,
+                      int* number_of_nodes) {
+  std::sort(word_list->begin(), word_list->end());
+  word_list->erase(std::unique(word_list->begin(), word_list->end()),
+                   word_list->end());
+  const std::vector<std::string>& words = *word_list;
+
+  struct Range {
+    size_t low;
+    size_t high;
+    size_t depth;
+  };
+  std::vector<Range> ranges;
+  std::vector<TrieNode> nodes;
+
+  Range root = {0, words.size(), 0};
+  ranges.push_back(root);
+  TrieNode empty_node = {0, 0, 0};
+  nodes.push_back(empty_node);
+
+  for (size_t node = 0; node < nodes.size(); node++) {
+    Range range = ranges[node];
+    size_t i = range.low;
+
+    // Words are sorted, so the prefix itself comes first.
+    if (i < range.high && words[i].size() == range.depth) {
+      nodes[node].completion_lengths |= 1;
+      i++;
+    }
+
+    nodes[node].first_child = nodes.size();
+    while (i < range.high) {
+      char letter = words[i][range.depth];
+      size_t j = i;
+      while (j < range.high && words[j][range.depth] == letter) {
+        j++;
+      }
+      nodes[node].children |= 1u << (letter - 'A');
+      Range child = {i, j, range.depth + 1};
+      ranges.push_back(child);
+      nodes.push_back(empty_node);
+      i = j;
+    }
+  }
+
+  // Children come after their parents, so a reverse pass sees every child
+  // before its parent.
+  for (size_t node = nodes.size(); node-- > 0;) {
+    int number_of_children = __builtin_popcount(nodes[node].children);
+    for (int i = 0; i < number_of_children; i++) {
+      nodes[node].completion_lengths |=
+          nodes[nodes[node].first_child + i].completion_lengths << 1;
+    }
+  }
+
+  *number_of_nodes = nodes.size();
+  TrieNode* result = new TrieNode[nodes.size()];
+  std::copy(nodes.begin(), nodes.end(), result);
+  return result;
+}
+
+}  // namespace
+
+// static
+Trie* Trie::from_word_list(const char* path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+
+  std::vector<std::string> words;
+  struct stat file_stat;
+  void* text = MAP_FAILED;
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    text = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+
+  if (text != MAP_FAILED) {
+    madvise(text, file_stat.st_size, MADV_SEQUENTIAL);
+    add_words(static_cast<const char*>(text), file_stat.st_size, &words);
+    munmap(text, file_stat.st_size);
+  } else {
+    // Not mappable (for example, a pipe): read it instead.
+    std::string contents;
+    char buffer[1 << 16];
+    ssize_t length;
+    while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+      contents.append(buffer, length);
+    }
+    if (length < 0) {
+      close(fd);
+      return NULL;
+    }
+    add_words(contents.data(), contents.size(), &words);
+  }
+  close(fd);
+
+  int number_of_nodes;
+  TrieNode* nodes = build_nodes(&words, &number_of_nodes);
+  return new Trie(nodes, number_of_nodes, NULL, 0);
+}
+
+// static
+Trie* Trie::from_words(const char* const* words, int number_of_words) {
+  std::vector<std::string> word_list;
+  for (int i = 0; i < number_of_words; i++) {
+    add_word(words[i], words[i] + strlen(words[i]), &word_list);
+  }
+
+  int number_of_nodes;
+  TrieNode* nodes = build_nodes(&word_list, &number_of_nodes);
+  return new Trie(nodes, number_of_nodes, NULL, 0);
+}
+
+// static
+Trie* Trie::load(const char* path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 ||
+      static_cast<size_t>(file_stat.st_size) < sizeof(SavedTrieHeader)) {
+    close(fd);
+    return NULL;
+  }
+
+  size_t length = file_stat.st_size;
+  void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return NULL;
+  }
+
+  const SavedTrieHeader* header =
+      static_cast<const SavedTrieHeader*>(mapping);
+  if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header->number_of_nodes == 0 ||
+      length != sizeof(SavedTrieHeader) +
+                header->number_of_nodes * sizeof(TrieNode)) {
+    munmap(mapping, length);
+    return NULL;
+  }
+
+  const TrieNode* nodes = reinterpret_cast<const TrieNode*>(header + 1);
+  return new Trie(nodes, header->number_of_nodes, mapping, length);
+}
+
+Trie::~Trie() {
+  if (mapping != NULL) {
+    munmap(mapping, mapping_length);
+  } else {
+    delete[] nodes;
+  }
+}
+
+bool Trie::save(const char* path) const {
+  FILE* file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+
+  SavedTrieHeader header;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.number_of_nodes = number_of_nodes;
+  header.reserved = 0;
+
+  bool success =
+      fwrite(&header, sizeof(header), 1, file) == 1 &&
+      fwrite(nodes, sizeof(TrieNode), number_of_nodes, file) ==
+          static_cast<size_t>(number_of_nodes);
+  return (fclose(file) == 0) && success;
+}
+
+int Trie::find(const char* prefix) const {
+  int node = ROOT;
+  for (int i = 0; prefix[i] != '\0' && node != NO_NODE; i++) {
+    int letter = toupper(static_cast<unsigned char>(prefix[i])) - 'A';
+    if (letter < 0 || letter >= NUMBER_OF_LETTERS) {
+      return NO_NODE;
+    }
+    node = child(node, letter);
+  }
+  return node;
+}
+
+Trie::Trie(const TrieNode* nodes,
+           int number_of_nodes,
+           void* mapping,
+           size_t mapping_length) :
+    nodes(nodes),
+    number_of_nodes(number_of_nodes),
+    mapping(mapping),
+    mapping_length(mapping_length) {
+}
+
+}  // namespace dictionary
+}  // namespace lib_kxing
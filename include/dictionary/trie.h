@@ -0,0 +1,140 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// A compact trie over the letters A-Z, for checking that squares of a letter
+// board spell dictionary words.
+//
+// Each node stores a bitmask of the letters that have children, and the index
+// of its first child; the children of a node are stored contiguously in
+// alphabetical order, so following a letter is a popcount. Each node also
+// stores the lengths of the words that complete its prefix, so that a prefix
+// can be rejected as soon as no word of the required length extends it.
+//
+// Every operation on a prefix of length n is O(n).
+// -----------------------------------------------------------------------------
+
+#ifndef _TRIE_H_
+#define _TRIE_H_
+
+#include <stddef.h>
+
+namespace lib_kxing {
+namespace dictionary {
+
+const int NUMBER_OF_LETTERS = 26;
+
+// The longest completion tracked by Trie::can_complete().
+const int MAX_COMPLETION_LENGTH = 31;
+
+struct TrieNode {
+  // Bit i is set if the node has a child for the letter ('A' + i).
+  unsigned int children;
+
+  // Index of the child with the lowest letter.
+  unsigned int first_child;
+
+  // Bit k is set if some word is exactly k letters longer than this node's
+  // prefix. Bit 0 is set if the prefix is a word.
+  unsigned int completion_lengths;
+};
+
+class Trie {
+ public:
+  static const int ROOT = 0;
+  static const int NO_NODE = -1;
+
+  // Builds a trie from a file with one word per line. Letters are
+  // case-insensitive, and lines with characters other than letters are
+  // skipped. The file is memory-mapped if possible.
+  // Returns NULL if the file cannot be read.
+  // The caller is responsible for freeing the pointer, if it is non-NULL.
+  static Trie* from_word_list(const char* path);
+
+  // Builds a trie from an array of |number_of_words| words.
+  // The caller is responsible for freeing the pointer.
+  static Trie* from_words(const char* const* words, int number_of_words);
+
+  // Loads a trie written by save(). The nodes are used in place from a memory
+  // mapping of the file, so this takes time independent of the trie size.
+  // Returns NULL if the file cannot be read, or is not a saved trie.
+  // The caller is responsible for freeing the pointer, if it is non-NULL.
+  static Trie* load(const char* path);
+
+  ~Trie();
+
+  // Writes the trie to |path|. Returns false on failure.
+  bool save(const char* path) const;
+
+  int get_number_of_nodes() const {
+    return number_of_nodes;
+  }
+
+  // Returns the child of |node| for the letter ('A' + |letter|), or NO_NODE.
+  int child(int node, int letter) const {
+    unsigned int bit = 1u << letter;
+    if (!(nodes[node].children & bit)) {
+      return NO_NODE;
+    }
+    return nodes[node].first_child +
+           __builtin_popcount(nodes[node].children & (bit - 1));
+  }
+
+  bool is_word(int node) const {
+    return nodes[node].completion_lengths & 1;
+  }
+
+  // Returns true if some word is exactly |remaining| letters longer than the
+  // prefix of |node|. Completions longer than MAX_COMPLETION_LENGTH are not
+  // tracked, and are assumed possible if the node has children.
+  bool can_complete(int node, int remaining) const {
+    if (remaining > MAX_COMPLETION_LENGTH) {
+      return nodes[node].children != 0;
+    }
+    return (nodes[node].completion_lengths >> remaining) & 1;
+  }
+
+  // Returns the node of |prefix|, or NO_NODE if no word starts with |prefix|.
+  int find(const char* prefix) const;
+
+  bool contains(const char* word) const {
+    int node = find(word);
+    return (node != NO_NODE) && is_word(node);
+  }
+
+ private:
+  Trie(const TrieNode* nodes,
+       int number_of_nodes,
+       void* mapping,
+       size_t mapping_length);
+
+  const TrieNode* const nodes;
+  const int number_of_nodes;
+
+  // The memory mapping that holds |nodes|, or NULL if |nodes| was allocated
+  // with new[].
+  void* const mapping;
+  const size_t mapping_length;
+};
+
+}  // namespace dictionary
+}  // namespace lib_kxing
+
+#endif  // _TRIE_H_
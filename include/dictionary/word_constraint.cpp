@@ -0,0 +1,129 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/dictionary/word_constraint.h"
+
+#include <ctype.h>
+
+#include <unordered_map>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+#include "include/dictionary/trie.h"
+
+namespace lib_kxing {
+namespace dictionary {
+
+using brute_force_solver::Board;
+using brute_force_solver::Constraint;
+using brute_force_solver::Domain;
+using brute_force_solver::StateList;
+
+using brute_force_solver::domain_contains;
+using brute_force_solver::single_state_domain;
+
+WordConstraint::WordConstraint(const Trie* const trie,
+                               const StateList* const state_list,
+                               const int* const path,
+                               int length) :
+    Constraint(path, length),
+    trie(trie),
+    number_of_states(state_list->get_number_of_states()),
+    letter_of_state(new int[state_list->get_number_of_states()]) {
+  for (int i = 0; i < number_of_states; i++) {
+    unsigned char letter =
+        state_list->get_state(i)->get_pretty_print_string()[0];
+    letter_of_state[i] = isalpha(letter) ? (toupper(letter) - 'A') : -1;
+  }
+}
+
+WordConstraint::~WordConstraint() {
+  delete[] letter_of_state;
+}
+
+bool WordConstraint::propagate(Board* const board,
+                               const int* const counters) const {
+  int length = get_scope_size();
+  std::vector<Domain> supports(length, 0);
+  std::unordered_map<long long, bool> is_fitting;
+  if (!find_supports(board, Trie::ROOT, 0, &supports[0], &is_fitting)) {
+    return false;
+  }
+  for (int i = 0; i < length; i++) {
+    if (!board->restrict_domain(get_scope(i), supports[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WordConstraint::find_supports(
+    const Board* const board,
+    int node,
+    int position,
+    Domain* const supports,
+    std::unordered_map<long long, bool>* const is_fitting) const {
+  int length = get_scope_size();
+  if (position == length) {
+    return trie->is_word(node);
+  }
+  // The words below a node walked before have added their states already.
+  long long key = static_cast<long long>(node) * length + position;
+  std::unordered_map<long long, bool>::const_iterator it =
+      is_fitting->find(key);
+  if (it != is_fitting->end()) {
+    return it->second;
+  }
+
+  bool is_any_fitting = false;
+  Domain domain = board->get_domain(get_scope(position));
+  for (int state = 0; state < number_of_states; state++) {
+    if (!domain_contains(domain, state) || letter_of_state[state] == -1) {
+      continue;
+    }
+    int child = trie->child(node, letter_of_state[state]);
+    if (child == Trie::NO_NODE ||
+        !trie->can_complete(child, length - position - 1)) {
+      continue;
+    }
+    if (find_supports(board, child, position + 1, supports, is_fitting)) {
+      supports[position] |= single_state_domain(state);
+      is_any_fitting = true;
+    }
+  }
+  (*is_fitting)[key] = is_any_fitting;
+  return is_any_fitting;
+}
+
+int WordConstraint::count_violations(const int* const state_indices) const {
+  int node = Trie::ROOT;
+  for (int i = 0; i < get_scope_size() && node != Trie::NO_NODE; i++) {
+    int letter = letter_of_state[state_indices[get_scope(i)]];
+    node = (letter == -1) ? Trie::NO_NODE : trie->child(node, letter);
+  }
+  return (node != Trie::NO_NODE && trie->is_word(node)) ? 0 : 1;
+}
+
+}  // namespace dictionary
+}  // namespace lib_kxing
@@ -0,0 +1,81 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef _WORD_CONSTRAINT_H_
+#define _WORD_CONSTRAINT_H_
+
+#include <unordered_map>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/state_list.h"
+#include "include/dictionary/trie.h"
+
+namespace lib_kxing {
+namespace dictionary {
+
+// Requires a path of squares on a letter board to spell a word from a Trie.
+// Propagation keeps, for each square of the path, only the letters that some
+// word of the right length has there, among the words that fit the domains of
+// every square of the path.
+//
+// The letter of a state is the first character of its pretty-print string.
+// The squares of the path must be distinct.
+class WordConstraint : public brute_force_solver::Constraint {
+ public:
+  // Requires the |length| squares of |path|, in order, to spell a word. The
+  // array is copied.
+  WordConstraint(const Trie* const trie,
+                 const brute_force_solver::StateList* const state_list,
+                 const int* const path,
+                 int length);
+  virtual ~WordConstraint();
+
+  virtual bool propagate(brute_force_solver::Board* const board,
+                         const int* const counters) const;
+
+  // Returns 0 if the path spells a word, and 1 otherwise.
+  virtual int count_violations(const int* const state_indices) const;
+
+ private:
+  // Walks the words below |node|, whose prefix fills the first |position|
+  // squares of the path, and adds the states they use to |supports|.
+  // Returns true if some word fits. |is_fitting| remembers the answer for
+  // the nodes already walked at each position.
+  bool find_supports(const brute_force_solver::Board* const board,
+                     int node,
+                     int position,
+                     brute_force_solver::Domain* const supports,
+                     std::unordered_map<long long, bool>* const is_fitting)
+      const;
+
+  const Trie* const trie;
+  const int number_of_states;
+
+  // Maps a state index to a letter index in [0, NUMBER_OF_LETTERS), or -1 if
+  // the state is not a letter.
+  int* const letter_of_state;
+};
+
+}  // namespace dictionary
+}  // namespace lib_kxing
+
+#endif  // _WORD_CONSTRAINT_H_
@@ -0,0 +1,69 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/glyph_board/glyph_board.h"
+
+#include "include/glyph_board/glyph_set.h"
+
+namespace lib_kxing {
+namespace glyph_board {
+
+GlyphBoard::GlyphBoard(int big_rows,
+                       int big_columns,
+                       const GlyphSet* const glyph_set) :
+    big_rows(big_rows),
+    big_columns(big_columns),
+    pixel_rows(big_rows * glyph_set->rows),
+    pixel_columns(big_columns * glyph_set->columns),
+    glyph_set(glyph_set),
+    big_squares(new int[pixel_rows * pixel_columns]),
+    bits(new GlyphMask[pixel_rows * pixel_columns]) {
+  assert(glyph_set->number_of_pixels() <= 32);
+
+  for (int pixel = 0; pixel < get_number_of_pixels(); pixel++) {
+    int row = pixel / pixel_columns;
+    int column = pixel % pixel_columns;
+    big_squares[pixel] = (row / glyph_set->rows) * big_columns +
+                         (column / glyph_set->columns);
+    bits[pixel] = glyph_set->pixel_bit(row % glyph_set->rows,
+                                       column % glyph_set->columns);
+  }
+}
+
+GlyphBoard::~GlyphBoard() {
+  delete[] big_squares;
+  delete[] bits;
+}
+
+int GlyphBoard::pixel_of(int big_square,
+                         int glyph_row,
+                         int glyph_column) const {
+  assert(0 <= big_square && big_square < big_rows * big_columns);
+  assert(0 <= glyph_row && glyph_row < glyph_set->rows);
+  assert(0 <= glyph_column && glyph_column < glyph_set->columns);
+
+  int row = (big_square / big_columns) * glyph_set->rows + glyph_row;
+  int column =
+      (big_square % big_columns) * glyph_set->columns + glyph_column;
+  return row * pixel_columns + column;
+}
+
+}  // namespace glyph_board
+}  // namespace lib_kxing
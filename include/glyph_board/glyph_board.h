@@ -0,0 +1,210 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// A glyph board is a Board whose squares each hold a glyph from a GlyphSet,
+// read as a finer grid of pixels. For example, a 5 by 5 Board of Braille
+// letters is a 15 by 10 grid of pixels.
+//
+// Pixels are numbered in row-major order over the whole pixel grid. The
+// coordinate maps from pixels to squares are precomputed, so reading a pixel
+// is two table lookups and no division.
+//
+// GlyphBoard is sized at run time. FixedGlyphBoard is sized at compile time,
+// and its maps are built by the compiler.
+// -----------------------------------------------------------------------------
+
+#ifndef _GLYPH_BOARD_H_
+#define _GLYPH_BOARD_H_
+
+#include <assert.h>
+
+#include "include/brute_force_solver/board.h"
+#include "include/glyph_board/glyph_set.h"
+
+namespace lib_kxing {
+namespace glyph_board {
+
+enum PixelType {
+  PIXEL_EMPTY,
+  PIXEL_FILLED,
+  PIXEL_UNFILLED,
+};
+
+// Returns the type of a pixel given the glyph index of its square (-1 if the
+// square is EMPTY), and the bit of the pixel within the glyph.
+inline PixelType pixel_type(const GlyphSet& glyph_set,
+                            int glyph,
+                            GlyphMask bit) {
+  if (glyph < 0) {
+    return PIXEL_EMPTY;
+  }
+  assert(glyph < glyph_set.number_of_glyphs);
+  return (glyph_set.masks[glyph] & bit) ? PIXEL_FILLED : PIXEL_UNFILLED;
+}
+
+// Returns the glyphs that have the pixel |bit| filled, as a Domain of glyph
+// (and so state) indices.
+inline brute_force_solver::Domain glyphs_with_pixel(const GlyphSet& glyph_set,
+                                                    GlyphMask bit) {
+  brute_force_solver::Domain glyphs = 0;
+  for (int i = 0; i < glyph_set.number_of_glyphs; i++) {
+    if (glyph_set.masks[i] & bit) {
+      glyphs |= brute_force_solver::single_state_domain(i);
+    }
+  }
+  return glyphs;
+}
+
+class GlyphBoard {
+ public:
+  GlyphBoard(int big_rows, int big_columns, const GlyphSet* const glyph_set);
+  ~GlyphBoard();
+
+  int get_pixel_rows() const {
+    return pixel_rows;
+  }
+
+  int get_pixel_columns() const {
+    return pixel_columns;
+  }
+
+  int get_number_of_pixels() const {
+    return pixel_rows * pixel_columns;
+  }
+
+  const GlyphSet* get_glyph_set() const {
+    return glyph_set;
+  }
+
+  // Returns the Board square that holds |pixel|.
+  int big_square_of_pixel(int pixel) const {
+    assert(is_valid_pixel(pixel));
+    return big_squares[pixel];
+  }
+
+  // Returns the bit of |pixel| within the glyph of its square.
+  GlyphMask bit_of_pixel(int pixel) const {
+    assert(is_valid_pixel(pixel));
+    return bits[pixel];
+  }
+
+  // Returns the pixel at (|glyph_row|, |glyph_column|) of the glyph in
+  // |big_square|.
+  int pixel_of(int big_square, int glyph_row, int glyph_column) const;
+
+  PixelType get_pixel(const brute_force_solver::Board* const board,
+                      int pixel) const {
+    return pixel_type(*glyph_set,
+                      board->get_state_index(big_square_of_pixel(pixel)),
+                      bit_of_pixel(pixel));
+  }
+
+ private:
+  const int big_rows;
+  const int big_columns;
+  const int pixel_rows;
+  const int pixel_columns;
+  const GlyphSet* const glyph_set;
+
+  // Arrays of length get_number_of_pixels().
+  int* const big_squares;
+  GlyphMask* const bits;
+
+  #ifndef NDEBUG
+  bool is_valid_pixel(int pixel) const {
+    return (0 <= pixel) && (pixel < get_number_of_pixels());
+  }
+  #endif
+};
+
+// The precomputed coordinate maps of a FixedGlyphBoard.
+template <int BIG_ROWS, int BIG_COLUMNS, int GLYPH_ROWS, int GLYPH_COLUMNS>
+struct PixelMap {
+  static constexpr int NUMBER_OF_PIXELS =
+      BIG_ROWS * GLYPH_ROWS * BIG_COLUMNS * GLYPH_COLUMNS;
+
+  int big_squares[NUMBER_OF_PIXELS];
+  GlyphMask bits[NUMBER_OF_PIXELS];
+};
+
+template <int BIG_ROWS, int BIG_COLUMNS, int GLYPH_ROWS, int GLYPH_COLUMNS>
+constexpr PixelMap<BIG_ROWS, BIG_COLUMNS, GLYPH_ROWS, GLYPH_COLUMNS>
+build_pixel_map() {
+  PixelMap<BIG_ROWS, BIG_COLUMNS, GLYPH_ROWS, GLYPH_COLUMNS> map = {};
+  const int pixel_columns = BIG_COLUMNS * GLYPH_COLUMNS;
+  for (int pixel = 0; pixel < map.NUMBER_OF_PIXELS; pixel++) {
+    int row = pixel / pixel_columns;
+    int column = pixel % pixel_columns;
+    map.big_squares[pixel] =
+        (row / GLYPH_ROWS) * BIG_COLUMNS + (column / GLYPH_COLUMNS);
+    map.bits[pixel] =
+        1u << ((row % GLYPH_ROWS) * GLYPH_COLUMNS + (column % GLYPH_COLUMNS));
+  }
+  return map;
+}
+
+template <int BIG_ROWS, int BIG_COLUMNS, int GLYPH_ROWS, int GLYPH_COLUMNS>
+class FixedGlyphBoard {
+ public:
+  static constexpr int NUMBER_OF_SQUARES = BIG_ROWS * BIG_COLUMNS;
+  static constexpr int PIXEL_ROWS = BIG_ROWS * GLYPH_ROWS;
+  static constexpr int PIXEL_COLUMNS = BIG_COLUMNS * GLYPH_COLUMNS;
+  static constexpr int NUMBER_OF_PIXELS = PIXEL_ROWS * PIXEL_COLUMNS;
+
+  static constexpr int big_square_of_pixel(int pixel) {
+    return PIXEL_MAP.big_squares[pixel];
+  }
+
+  static constexpr GlyphMask bit_of_pixel(int pixel) {
+    return PIXEL_MAP.bits[pixel];
+  }
+
+  static constexpr int pixel_of(int big_square,
+                                int glyph_row,
+                                int glyph_column) {
+    return ((big_square / BIG_COLUMNS) * GLYPH_ROWS + glyph_row) *
+               PIXEL_COLUMNS +
+           (big_square % BIG_COLUMNS) * GLYPH_COLUMNS + glyph_column;
+  }
+
+  static PixelType get_pixel(const brute_force_solver::Board* const board,
+                             const GlyphSet& glyph_set,
+                             int pixel) {
+    assert(glyph_set.rows == GLYPH_ROWS);
+    assert(glyph_set.columns == GLYPH_COLUMNS);
+    assert(0 <= pixel && pixel < NUMBER_OF_PIXELS);
+    return pixel_type(glyph_set,
+                      board->get_state_index(big_square_of_pixel(pixel)),
+                      bit_of_pixel(pixel));
+  }
+
+ private:
+  static constexpr PixelMap<BIG_ROWS, BIG_COLUMNS, GLYPH_ROWS, GLYPH_COLUMNS>
+      PIXEL_MAP = build_pixel_map<BIG_ROWS,
+                                  BIG_COLUMNS,
+                                  GLYPH_ROWS,
+                                  GLYPH_COLUMNS>();
+};
+
+}  // namespace glyph_board
+}  // namespace lib_kxing
+
+#endif  // _GLYPH_BOARD_H_
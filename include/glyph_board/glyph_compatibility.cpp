@@ -0,0 +1,128 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/glyph_board/glyph_compatibility.h"
+
+#include <assert.h>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/pairwise_constraint.h"
+
+namespace lib_kxing {
+namespace glyph_board {
+
+using brute_force_solver::Board;
+using brute_force_solver::Domain;
+using brute_force_solver::PairwiseConstraint;
+using brute_force_solver::single_state_domain;
+
+GlyphWindow::GlyphWindow(const GlyphSet* const glyph_set,
+                         Boundary boundary,
+                         int first_glyph,
+                         int second_glyph) :
+    glyph_set(glyph_set) {
+  glyphs[0][0] = glyphs[0][1] = glyphs[1][0] = glyphs[1][1] = -1;
+  switch (boundary) {
+    case BOUNDARY_HORIZONTAL:
+      glyphs[0][0] = first_glyph;
+      glyphs[0][1] = second_glyph;
+      break;
+    case BOUNDARY_VERTICAL:
+      glyphs[0][0] = first_glyph;
+      glyphs[1][0] = second_glyph;
+      break;
+    case BOUNDARY_DIAGONAL:
+      glyphs[0][0] = first_glyph;
+      glyphs[1][1] = second_glyph;
+      break;
+    case BOUNDARY_ANTI_DIAGONAL:
+      glyphs[0][1] = first_glyph;
+      glyphs[1][0] = second_glyph;
+      break;
+  }
+}
+
+void build_compatibility_table(const GlyphSet* const glyph_set,
+                               Boundary boundary,
+                               GlyphWindowPredicate predicate,
+                               Domain* compatible) {
+  assert(glyph_set->number_of_glyphs <=
+         brute_force_solver::MAX_NUMBER_OF_STATES);
+
+  for (int i = 0; i < glyph_set->number_of_glyphs; i++) {
+    compatible[i] = 0;
+    for (int j = 0; j < glyph_set->number_of_glyphs; j++) {
+      if (predicate(GlyphWindow(glyph_set, boundary, i, j))) {
+        compatible[i] |= single_state_domain(j);
+      }
+    }
+  }
+}
+
+BoundaryConstraints::BoundaryConstraints(int big_rows,
+                                         int big_columns,
+                                         const GlyphSet* const glyph_set,
+                                         Boundary boundary,
+                                         GlyphWindowPredicate predicate) :
+    table(new Domain[glyph_set->number_of_glyphs]) {
+  build_compatibility_table(glyph_set, boundary, predicate, table);
+
+  // The offsets of the second square from the first.
+  int row_offset = (boundary == BOUNDARY_HORIZONTAL) ? 0 : 1;
+  int column_offset = 0;
+  if (boundary == BOUNDARY_HORIZONTAL || boundary == BOUNDARY_DIAGONAL) {
+    column_offset = 1;
+  } else if (boundary == BOUNDARY_ANTI_DIAGONAL) {
+    column_offset = -1;
+  }
+
+  for (int row = 0; row < big_rows; row++) {
+    for (int column = 0; column < big_columns; column++) {
+      int next_row = row + row_offset;
+      int next_column = column + column_offset;
+      if (next_row >= big_rows ||
+          next_column < 0 || next_column >= big_columns) {
+        continue;
+      }
+      constraints.push_back(
+          new PairwiseConstraint(row * big_columns + column,
+                                 next_row * big_columns + next_column,
+                                 table,
+                                 glyph_set->number_of_glyphs));
+    }
+  }
+}
+
+BoundaryConstraints::~BoundaryConstraints() {
+  for (size_t i = 0; i < constraints.size(); i++) {
+    delete constraints[i];
+  }
+  delete[] table;
+}
+
+void BoundaryConstraints::add_to(Board* const board) const {
+  for (size_t i = 0; i < constraints.size(); i++) {
+    board->add_constraint(constraints[i]);
+  }
+}
+
+}  // namespace glyph_board
+}  // namespace lib_kxing
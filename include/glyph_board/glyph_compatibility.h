@@ -0,0 +1,122 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Compatibility tables between neighbouring glyphs.
+//
+// Rules such as "no 2 by 2 block of filled pixels" only look at a few pixels
+// at a time, so whether two neighbouring squares can hold a pair of glyphs
+// depends only on the two glyphs and on how the squares touch. These tables
+// are computed once per kind of boundary, and turned into PairwiseConstraints
+// so that the search removes incompatible glyphs by arc consistency instead
+// of by calling the validator.
+// -----------------------------------------------------------------------------
+
+#ifndef _GLYPH_COMPATIBILITY_H_
+#define _GLYPH_COMPATIBILITY_H_
+
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/pairwise_constraint.h"
+#include "include/glyph_board/glyph_board.h"
+#include "include/glyph_board/glyph_set.h"
+
+namespace lib_kxing {
+namespace glyph_board {
+
+// How the second square of a pair touches the first.
+enum Boundary {
+  BOUNDARY_HORIZONTAL,     // To the right of the first square.
+  BOUNDARY_VERTICAL,       // Below the first square.
+  BOUNDARY_DIAGONAL,       // Below and to the right of the first square.
+  BOUNDARY_ANTI_DIAGONAL,  // Below and to the left of the first square.
+};
+
+// The pixels of a pair of glyphs, laid out in a 2 by 2 block of glyph
+// positions. The positions not covered by the pair read as PIXEL_EMPTY.
+class GlyphWindow {
+ public:
+  GlyphWindow(const GlyphSet* const glyph_set,
+              Boundary boundary,
+              int first_glyph,
+              int second_glyph);
+
+  int get_rows() const {
+    return 2 * glyph_set->rows;
+  }
+
+  int get_columns() const {
+    return 2 * glyph_set->columns;
+  }
+
+  PixelType get_pixel(int row, int column) const {
+    int glyph = glyphs[row / glyph_set->rows][column / glyph_set->columns];
+    return pixel_type(*glyph_set,
+                      glyph,
+                      glyph_set->pixel_bit(row % glyph_set->rows,
+                                           column % glyph_set->columns));
+  }
+
+ private:
+  const GlyphSet* const glyph_set;
+
+  // The glyph at each position of the block, or -1.
+  int glyphs[2][2];
+};
+
+// Returns false if the pixels of the window break a rule.
+typedef bool (*GlyphWindowPredicate)(const GlyphWindow& window);
+
+// Fills |compatible|, which has one entry per glyph: bit j of |compatible[i]|
+// is set if |predicate| accepts glyph i next to glyph j across |boundary|.
+void build_compatibility_table(const GlyphSet* const glyph_set,
+                               Boundary boundary,
+                               GlyphWindowPredicate predicate,
+                               brute_force_solver::Domain* compatible);
+
+// The PairwiseConstraints for every pair of squares of a |big_rows| by
+// |big_columns| board that touch across |boundary|. The states of the Board
+// must be in the order of the glyphs.
+class BoundaryConstraints {
+ public:
+  BoundaryConstraints(int big_rows,
+                      int big_columns,
+                      const GlyphSet* const glyph_set,
+                      Boundary boundary,
+                      GlyphWindowPredicate predicate);
+  ~BoundaryConstraints();
+
+  const brute_force_solver::Domain* get_table() const {
+    return table;
+  }
+
+  void add_to(brute_force_solver::Board* const board) const;
+
+ private:
+  brute_force_solver::Domain* const table;
+  std::vector<brute_force_solver::PairwiseConstraint*> constraints;
+};
+
+}  // namespace glyph_board
+}  // namespace lib_kxing
+
+#endif  // _GLYPH_COMPATIBILITY_H_
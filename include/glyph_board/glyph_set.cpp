@@ -0,0 +1,52 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/glyph_board/glyph_set.h"
+
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+
+namespace lib_kxing {
+namespace glyph_board {
+
+using brute_force_solver::State;
+using brute_force_solver::StateList;
+
+GlyphStates::GlyphStates(const GlyphSet* const glyph_set) :
+    number_of_states(glyph_set->number_of_glyphs),
+    states(new State*[glyph_set->number_of_glyphs]),
+    state_list(new StateList(states, glyph_set->number_of_glyphs)) {
+  char pretty_print_string[2] = {'\0', '\0'};
+  for (int i = 0; i < number_of_states; i++) {
+    pretty_print_string[0] = glyph_set->names[i];
+    states[i] = new State(pretty_print_string);
+  }
+}
+
+GlyphStates::~GlyphStates() {
+  delete state_list;
+  for (int i = 0; i < number_of_states; i++) {
+    delete states[i];
+  }
+  delete[] states;
+}
+
+}  // namespace glyph_board
+}  // namespace lib_kxing
@@ -0,0 +1,92 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef _GLYPH_SET_H_
+#define _GLYPH_SET_H_
+
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+
+namespace lib_kxing {
+namespace glyph_board {
+
+// The pixels of a glyph, where the pixel at (row, column) is bit
+// (row * columns + column), and set if the pixel is filled. Glyphs have at
+// most 32 pixels.
+typedef unsigned int GlyphMask;
+
+// Returns the mask of a glyph drawn as a string of its rows, where '#' is a
+// filled pixel and anything else is an unfilled pixel.
+constexpr GlyphMask glyph_mask(const char* picture) {
+  GlyphMask mask = 0;
+  for (int i = 0; picture[i] != '\0'; i++) {
+    if (picture[i] == '#') {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+}
+
+// An alphabet of glyphs of the same shape.
+struct GlyphSet {
+  int rows;
+  int columns;
+  int number_of_glyphs;
+
+  // Array of length |number_of_glyphs|.
+  const GlyphMask* masks;
+
+  // The single-character name of each glyph, used for pretty printing.
+  const char* names;
+
+  constexpr int number_of_pixels() const {
+    return rows * columns;
+  }
+
+  constexpr GlyphMask pixel_bit(int row, int column) const {
+    return 1u << (row * columns + column);
+  }
+};
+
+// Owns one State per glyph of a GlyphSet, in the same order as the glyphs, so
+// that the state index of a square on a Board is also its glyph index.
+class GlyphStates {
+ public:
+  explicit GlyphStates(const GlyphSet* const glyph_set);
+  ~GlyphStates();
+
+  const brute_force_solver::StateList* get_state_list() const {
+    return state_list;
+  }
+
+  const brute_force_solver::State* get_state(int glyph) const {
+    return states[glyph];
+  }
+
+ private:
+  const int number_of_states;
+  brute_force_solver::State** const states;
+  const brute_force_solver::StateList* const state_list;
+};
+
+}  // namespace glyph_board
+}  // namespace lib_kxing
+
+#endif  // _GLYPH_SET_H_
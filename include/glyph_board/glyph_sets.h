@@ -0,0 +1,161 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Glyph sets for some alphabets that show up in puzzles. The masks are
+// computed at compile time from the pictures, where '#' is a filled pixel.
+// -----------------------------------------------------------------------------
+
+#ifndef _GLYPH_SETS_H_
+#define _GLYPH_SETS_H_
+
+#include "include/glyph_board/glyph_set.h"
+
+namespace lib_kxing {
+namespace glyph_board {
+
+// Braille letters, 3 rows by 2 columns.
+inline constexpr GlyphMask BRAILLE_MASKS[] = {
+  glyph_mask("#." ".." ".."),  // A.
+  glyph_mask("#." "#." ".."),  // B.
+  glyph_mask("##" ".." ".."),  // C.
+  glyph_mask("##" ".#" ".."),  // D.
+  glyph_mask("#." ".#" ".."),  // E.
+  glyph_mask("##" "#." ".."),  // F.
+  glyph_mask("##" "##" ".."),  // G.
+  glyph_mask("#." "##" ".."),  // H.
+  glyph_mask(".#" "#." ".."),  // I.
+  glyph_mask(".#" "##" ".."),  // J.
+  glyph_mask("#." ".." "#."),  // K.
+  glyph_mask("#." "#." "#."),  // L.
+  glyph_mask("##" ".." "#."),  // M.
+  glyph_mask("##" ".#" "#."),  // N.
+  glyph_mask("#." ".#" "#."),  // O.
+  glyph_mask("##" "#." "#."),  // P.
+  glyph_mask("##" "##" "#."),  // Q.
+  glyph_mask("#." "##" "#."),  // R.
+  glyph_mask(".#" "#." "#."),  // S.
+  glyph_mask(".#" "##" "#."),  // T.
+  glyph_mask("#." ".." "##"),  // U.
+  glyph_mask("#." "#." "##"),  // V.
+  glyph_mask(".#" "##" ".#"),  // W.
+  glyph_mask("##" ".." "##"),  // X.
+  glyph_mask("##" ".#" "##"),  // Y.
+  glyph_mask("#." ".#" "##"),  // Z.
+};
+
+// Seven-segment digits, drawn on 5 rows by 3 columns. Each segment is a
+// single pixel: the middle column of rows 0, 2 and 4 holds the horizontal
+// segments, and the outer columns of rows 1 and 3 hold the vertical ones.
+inline constexpr GlyphMask SEVEN_SEGMENT_MASKS[] = {
+  glyph_mask(".#." "#.#" "..." "#.#" ".#."),  // 0.
+  glyph_mask("..." "..#" "..." "..#" "..."),  // 1.
+  glyph_mask(".#." "..#" ".#." "#.." ".#."),  // 2.
+  glyph_mask(".#." "..#" ".#." "..#" ".#."),  // 3.
+  glyph_mask("..." "#.#" ".#." "..#" "..."),  // 4.
+  glyph_mask(".#." "#.." ".#." "..#" ".#."),  // 5.
+  glyph_mask(".#." "#.." ".#." "#.#" ".#."),  // 6.
+  glyph_mask(".#." "..#" "..." "..#" "..."),  // 7.
+  glyph_mask(".#." "#.#" ".#." "#.#" ".#."),  // 8.
+  glyph_mask(".#." "#.#" ".#." "..#" ".#."),  // 9.
+};
+
+// Flag semaphore letters, drawn on 3 rows by 3 columns as seen by the
+// receiver. The center pixel is the signaller, and the two arms fill two of
+// the eight surrounding pixels.
+inline constexpr GlyphMask SEMAPHORE_MASKS[] = {
+  glyph_mask("..." ".#." "##."),  // A.
+  glyph_mask("..." "##." ".#."),  // B.
+  glyph_mask("#.." ".#." ".#."),  // C.
+  glyph_mask(".#." ".#." ".#."),  // D.
+  glyph_mask("..#" ".#." ".#."),  // E.
+  glyph_mask("..." ".##" ".#."),  // F.
+  glyph_mask("..." ".#." ".##"),  // G.
+  glyph_mask("..." "##." "#.."),  // H.
+  glyph_mask("#.." ".#." "#.."),  // I.
+  glyph_mask(".#." ".##" "..."),  // J.
+  glyph_mask(".#." ".#." "#.."),  // K.
+  glyph_mask("..#" ".#." "#.."),  // L.
+  glyph_mask("..." ".##" "#.."),  // M.
+  glyph_mask("..." ".#." "#.#"),  // N.
+  glyph_mask("#.." "##." "..."),  // O.
+  glyph_mask(".#." "##." "..."),  // P.
+  glyph_mask("..#" "##." "..."),  // Q.
+  glyph_mask("..." "###" "..."),  // R.
+  glyph_mask("..." "##." "..#"),  // S.
+  glyph_mask("##." ".#." "..."),  // T.
+  glyph_mask("#.#" ".#." "..."),  // U.
+  glyph_mask(".#." ".#." "..#"),  // V.
+  glyph_mask("..#" ".##" "..."),  // W.
+  glyph_mask("..#" ".#." "..#"),  // X.
+  glyph_mask("#.." ".##" "..."),  // Y.
+  glyph_mask("..." ".##" "..#"),  // Z.
+};
+
+// Upper-case letters in a 5 by 5 pixel font.
+inline constexpr GlyphMask PIXEL_FONT_MASKS[] = {
+  glyph_mask(".###." "#...#" "#####" "#...#" "#...#"),  // A.
+  glyph_mask("####." "#...#" "####." "#...#" "####."),  // B.
+  glyph_mask(".####" "#...." "#...." "#...." ".####"),  // C.
+  glyph_mask("####." "#...#" "#...#" "#...#" "####."),  // D.
+  glyph_mask("#####" "#...." "####." "#...." "#####"),  // E.
+  glyph_mask("#####" "#...." "####." "#...." "#...."),  // F.
+  glyph_mask(".####" "#...." "#..##" "#...#" ".###."),  // G.
+  glyph_mask("#...#" "#...#" "#####" "#...#" "#...#"),  // H.
+  glyph_mask("#####" "..#.." "..#.." "..#.." "#####"),  // I.
+  glyph_mask("..###" "...#." "...#." "#..#." ".##.."),  // J.
+  glyph_mask("#...#" "#..#." "###.." "#..#." "#...#"),  // K.
+  glyph_mask("#...." "#...." "#...." "#...." "#####"),  // L.
+  glyph_mask("#...#" "##.##" "#.#.#" "#...#" "#...#"),  // M.
+  glyph_mask("#...#" "##..#" "#.#.#" "#..##" "#...#"),  // N.
+  glyph_mask(".###." "#...#" "#...#" "#...#" ".###."),  // O.
+  glyph_mask("####." "#...#" "####." "#...." "#...."),  // P.
+  glyph_mask(".###." "#...#" "#.#.#" "#..#." ".##.#"),  // Q.
+  glyph_mask("####." "#...#" "####." "#..#." "#...#"),  // R.
+  glyph_mask(".####" "#...." ".###." "....#" "####."),  // S.
+  glyph_mask("#####" "..#.." "..#.." "..#.." "..#.."),  // T.
+  glyph_mask("#...#" "#...#" "#...#" "#...#" ".###."),  // U.
+  glyph_mask("#...#" "#...#" "#...#" ".#.#." "..#.."),  // V.
+  glyph_mask("#...#" "#...#" "#.#.#" "##.##" "#...#"),  // W.
+  glyph_mask("#...#" ".#.#." "..#.." ".#.#." "#...#"),  // X.
+  glyph_mask("#...#" ".#.#." "..#.." "..#.." "..#.."),  // Y.
+  glyph_mask("#####" "...#." "..#.." ".#..." "#####"),  // Z.
+};
+
+inline constexpr GlyphSet BRAILLE_GLYPHS = {
+  3, 2, 26, BRAILLE_MASKS, "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+};
+
+inline constexpr GlyphSet SEVEN_SEGMENT_GLYPHS = {
+  5, 3, 10, SEVEN_SEGMENT_MASKS, "0123456789",
+};
+
+inline constexpr GlyphSet SEMAPHORE_GLYPHS = {
+  3, 3, 26, SEMAPHORE_MASKS, "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+};
+
+inline constexpr GlyphSet PIXEL_FONT_GLYPHS = {
+  5, 5, 26, PIXEL_FONT_MASKS, "ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+};
+
+}  // namespace glyph_board
+}  // namespace lib_kxing
+
+#endif  // _GLYPH_SETS_H_
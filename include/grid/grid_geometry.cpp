@@ -0,0 +1,80 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/grid/grid_geometry.h"
+
+#include <vector>
+
+namespace lib_kxing {
+namespace grid {
+
+GridGeometry::GridGeometry(int rows, int columns) :
+    rows(rows),
+    columns(columns),
+    number_of_windows((rows > 1 && columns > 1) ?
+                      (rows - 1) * (columns - 1) : 0),
+    square_rows(rows * columns),
+    square_columns(rows * columns),
+    number_of_neighbours4(rows * columns, 0),
+    neighbours4(rows * columns * NUMBER_OF_ORTHOGONAL_DIRECTIONS, -1),
+    padded_squares(rows * columns),
+    unpadded_squares((rows + 2) * (columns + 2), -1) {
+  for (int row = 0; row < rows; row++) {
+    for (int column = 0; column < columns; column++) {
+      int square = row * columns + column;
+      square_rows[square] = row;
+      square_columns[square] = column;
+
+      int padded = (row + 1) * (columns + 2) + (column + 1);
+      padded_squares[square] = padded;
+      unpadded_squares[padded] = square;
+
+      for (int i = 0; i < NUMBER_OF_ORTHOGONAL_DIRECTIONS; i++) {
+        int next_row = row + DELTA_ROW[i];
+        int next_column = column + DELTA_COLUMN[i];
+        if (contains(next_row, next_column)) {
+          neighbours4[square * NUMBER_OF_ORTHOGONAL_DIRECTIONS +
+                      number_of_neighbours4[square]++] =
+              next_row * columns + next_column;
+        }
+      }
+    }
+  }
+
+  for (int row = 0; row + 1 < rows; row++) {
+    for (int column = 0; column + 1 < columns; column++) {
+      int square = row * columns + column;
+      windows.push_back(square);
+      windows.push_back(square + 1);
+      windows.push_back(square + columns);
+      windows.push_back(square + columns + 1);
+    }
+  }
+
+  for (int i = 0; i < NUMBER_OF_DIRECTIONS; i++) {
+    padded_offsets[i] = DELTA_ROW[i] * (columns + 2) + DELTA_COLUMN[i];
+  }
+}
+
+GridGeometry::~GridGeometry() {
+}
+
+}  // namespace grid
+}  // namespace lib_kxing
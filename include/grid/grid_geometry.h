@@ -0,0 +1,169 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// The geometry of a rectangular grid of squares, numbered in row-major order,
+// with every table a puzzle needs precomputed as flat arrays: the coordinates
+// of each square, its orthogonal neighbours, and the 2 by 2 windows. Flood
+// fills and window scans iterate these tables instead of computing coordinates
+// and checking bounds in their inner loops.
+//
+// The grid also has a padded layout, with a border one square wide around it.
+// A puzzle that keeps its values in a padded array, with a sentinel in the
+// border, can step to a neighbour by adding an offset, with no bounds check.
+// -----------------------------------------------------------------------------
+
+#ifndef _GRID_GEOMETRY_H_
+#define _GRID_GEOMETRY_H_
+
+#include <assert.h>
+
+#include <vector>
+
+namespace lib_kxing {
+namespace grid {
+
+// The directions to the neighbours of a square, as changes of row and column.
+// The first four are orthogonal; all eight include the diagonals.
+const int NUMBER_OF_ORTHOGONAL_DIRECTIONS = 4;
+const int NUMBER_OF_DIRECTIONS = 8;
+const int DELTA_ROW[NUMBER_OF_DIRECTIONS] = {1, 0, -1, 0, 1, 1, -1, -1};
+const int DELTA_COLUMN[NUMBER_OF_DIRECTIONS] = {0, 1, 0, -1, 1, -1, 1, -1};
+
+// The squares of a window, in this order.
+enum WindowCorner {
+  WINDOW_TOP_LEFT,
+  WINDOW_TOP_RIGHT,
+  WINDOW_BOTTOM_LEFT,
+  WINDOW_BOTTOM_RIGHT,
+  NUMBER_OF_WINDOW_CORNERS,
+};
+
+class GridGeometry {
+ public:
+  GridGeometry(int rows, int columns);
+  ~GridGeometry();
+
+  int get_rows() const {
+    return rows;
+  }
+
+  int get_columns() const {
+    return columns;
+  }
+
+  int get_number_of_squares() const {
+    return rows * columns;
+  }
+
+  int row_of(int square) const {
+    assert(is_valid_square(square));
+    return square_rows[square];
+  }
+
+  int column_of(int square) const {
+    assert(is_valid_square(square));
+    return square_columns[square];
+  }
+
+  int square_at(int row, int column) const {
+    assert(contains(row, column));
+    return row * columns + column;
+  }
+
+  bool contains(int row, int column) const {
+    return (0 <= row && row < rows && 0 <= column && column < columns);
+  }
+
+  // The orthogonal neighbours of |square| inside the grid, in the order of
+  // the directions.
+  int get_number_of_neighbours4(int square) const {
+    assert(is_valid_square(square));
+    return number_of_neighbours4[square];
+  }
+
+  const int* get_neighbours4(int square) const {
+    assert(is_valid_square(square));
+    return &neighbours4[square * NUMBER_OF_ORTHOGONAL_DIRECTIONS];
+  }
+
+  // The 2 by 2 windows, in row-major order of their top left squares. Each is
+  // NUMBER_OF_WINDOW_CORNERS squares, in the order of WindowCorner.
+  int get_number_of_windows() const {
+    return number_of_windows;
+  }
+
+  const int* get_window(int window) const {
+    assert(0 <= window && window < number_of_windows);
+    return &windows[window * NUMBER_OF_WINDOW_CORNERS];
+  }
+
+  // The padded layout has (rows + 2) rows of (columns + 2) squares.
+  int get_number_of_padded_squares() const {
+    return (rows + 2) * (columns + 2);
+  }
+
+  int padded_of(int square) const {
+    assert(is_valid_square(square));
+    return padded_squares[square];
+  }
+
+  // Returns the square at a padded index, or -1 in the border.
+  int square_of_padded(int padded) const {
+    assert(0 <= padded && padded < get_number_of_padded_squares());
+    return unpadded_squares[padded];
+  }
+
+  // The offsets from a padded index to its neighbours, in the order of the
+  // directions.
+  const int* get_padded_offsets() const {
+    return padded_offsets;
+  }
+
+ private:
+  const int rows;
+  const int columns;
+  const int number_of_windows;
+
+  std::vector<int> square_rows;
+  std::vector<int> square_columns;
+
+  // Neighbours are stored NUMBER_OF_ORTHOGONAL_DIRECTIONS to a square; only
+  // the first few are used.
+  std::vector<int> number_of_neighbours4;
+  std::vector<int> neighbours4;
+
+  std::vector<int> windows;
+
+  std::vector<int> padded_squares;
+  std::vector<int> unpadded_squares;
+  int padded_offsets[NUMBER_OF_DIRECTIONS];
+
+  #ifndef NDEBUG
+  bool is_valid_square(int square) const {
+    return (0 <= square) && (square < get_number_of_squares());
+  }
+  #endif
+};
+
+}  // namespace grid
+}  // namespace lib_kxing
+
+#endif  // _GRID_GEOMETRY_H_
@@ -0,0 +1,128 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/sat_solver/cnf_formula.h"
+
+#include <stdio.h>
+
+#include <vector>
+
+namespace lib_kxing {
+namespace sat_solver {
+
+CnfFormula::CnfFormula() :
+    number_of_variables(0) {
+}
+
+CnfFormula::~CnfFormula() {
+}
+
+void CnfFormula::add_at_most(const std::vector<int>& literals, int k) {
+  int n = literals.size();
+  if (k >= n) {
+    return;
+  }
+  if (k < 0) {
+    // Not even none of them: the empty clause.
+    add_clause(Clause());
+    return;
+  }
+  if (k == 0) {
+    for (int i = 0; i < n; i++) {
+      add_unit(-literals[i]);
+    }
+    return;
+  }
+
+  // counts[i][j] is true if at least j + 1 of the first i + 1 literals are.
+  std::vector<std::vector<int> > counts(n - 1, std::vector<int>(k));
+  for (int i = 0; i < n - 1; i++) {
+    for (int j = 0; j < k; j++) {
+      counts[i][j] = new_variable();
+    }
+  }
+
+  add_binary(-literals[0], counts[0][0]);
+  for (int j = 1; j < k; j++) {
+    add_unit(-counts[0][j]);
+  }
+  for (int i = 1; i < n - 1; i++) {
+    add_binary(-literals[i], counts[i][0]);
+    add_binary(-counts[i - 1][0], counts[i][0]);
+    for (int j = 1; j < k; j++) {
+      Clause carry(3);
+      carry[0] = -literals[i];
+      carry[1] = -counts[i - 1][j - 1];
+      carry[2] = counts[i][j];
+      add_clause(carry);
+      add_binary(-counts[i - 1][j], counts[i][j]);
+    }
+    add_binary(-literals[i], -counts[i - 1][k - 1]);
+  }
+  add_binary(-literals[n - 1], -counts[n - 2][k - 1]);
+}
+
+void CnfFormula::add_at_least(const std::vector<int>& literals, int k) {
+  // At least k are true if at most n - k are false.
+  std::vector<int> negations(literals.size());
+  for (size_t i = 0; i < literals.size(); i++) {
+    negations[i] = -literals[i];
+  }
+  add_at_most(negations, literals.size() - k);
+}
+
+int CnfFormula::add_or(const std::vector<int>& literals) {
+  int variable = new_variable();
+  Clause clause(1, -variable);
+  for (size_t i = 0; i < literals.size(); i++) {
+    clause.push_back(literals[i]);
+    add_binary(-literals[i], variable);
+  }
+  add_clause(clause);
+  return variable;
+}
+
+bool CnfFormula::write_dimacs(FILE* file) const {
+  if (fprintf(file, "p cnf %d %d\n", number_of_variables,
+              get_number_of_clauses()) < 0) {
+    return false;
+  }
+  for (size_t i = 0; i < clauses.size(); i++) {
+    for (size_t j = 0; j < clauses[i].size(); j++) {
+      fprintf(file, "%d ", clauses[i][j]);
+    }
+    if (fprintf(file, "0\n") < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CnfFormula::write_dimacs(const char* path) const {
+  FILE* file = fopen(path, "w");
+  if (file == NULL) {
+    return false;
+  }
+  bool success = write_dimacs(file);
+  return (fclose(file) == 0) && success;
+}
+
+}  // namespace sat_solver
+}  // namespace lib_kxing
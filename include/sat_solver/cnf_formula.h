@@ -0,0 +1,108 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// A Boolean formula in conjunctive normal form.
+//
+// Variables are numbered from 1, and literals are written as in DIMACS: the
+// literal v is the variable v, and -v is its negation.
+// -----------------------------------------------------------------------------
+
+#ifndef _CNF_FORMULA_H_
+#define _CNF_FORMULA_H_
+
+#include <stdio.h>
+
+#include <vector>
+
+namespace lib_kxing {
+namespace sat_solver {
+
+typedef std::vector<int> Clause;
+
+class CnfFormula {
+ public:
+  CnfFormula();
+  ~CnfFormula();
+
+  // Returns a new variable.
+  int new_variable() {
+    return ++number_of_variables;
+  }
+
+  int get_number_of_variables() const {
+    return number_of_variables;
+  }
+
+  int get_number_of_clauses() const {
+    return clauses.size();
+  }
+
+  const Clause& get_clause(int i) const {
+    return clauses[i];
+  }
+
+  void add_clause(const Clause& clause) {
+    clauses.push_back(clause);
+  }
+
+  void add_unit(int literal) {
+    clauses.push_back(Clause(1, literal));
+  }
+
+  void add_binary(int first, int second) {
+    Clause clause(2);
+    clause[0] = first;
+    clause[1] = second;
+    clauses.push_back(clause);
+  }
+
+  // At most |k| of the |literals| are true. Uses the sequential counter
+  // encoding, with O(|literals| * k) new variables and clauses.
+  void add_at_most(const std::vector<int>& literals, int k);
+
+  // At least |k| of the |literals| are true.
+  void add_at_least(const std::vector<int>& literals, int k);
+
+  // Exactly |k| of the |literals| are true.
+  void add_exactly(const std::vector<int>& literals, int k) {
+    add_at_most(literals, k);
+    add_at_least(literals, k);
+  }
+
+  // Returns a new variable that is true exactly when one of the |literals|
+  // is.
+  int add_or(const std::vector<int>& literals);
+
+  // Writes the formula in DIMACS CNF format. Returns false on a write error.
+  bool write_dimacs(FILE* file) const;
+
+  // Returns false if the file cannot be written.
+  bool write_dimacs(const char* path) const;
+
+ private:
+  int number_of_variables;
+  std::vector<Clause> clauses;
+};
+
+}  // namespace sat_solver
+}  // namespace lib_kxing
+
+#endif  // _CNF_FORMULA_H_
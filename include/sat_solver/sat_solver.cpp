@@ -0,0 +1,397 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include "include/sat_solver/sat_solver.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "include/sat_solver/cnf_formula.h"
+
+namespace lib_kxing {
+namespace sat_solver {
+
+namespace {
+
+// The number of conflicts in the first restart, scaled by the Luby sequence.
+const long long RESTART_BASE = 100;
+
+// Activities decay by this factor with every conflict.
+const double ACTIVITY_DECAY = 0.95;
+
+// Returns the |i|th term of the Luby sequence 1, 1, 2, 1, 1, 2, 4, ...,
+// counting from 0.
+long long luby(long long i) {
+  long long size = 1;
+  int sequence = 0;
+  while (size < i + 1) {
+    sequence++;
+    size = 2 * size + 1;
+  }
+  while (size - 1 != i) {
+    size = (size - 1) >> 1;
+    sequence--;
+    i = i % size;
+  }
+  return 1ll << sequence;
+}
+
+}  // namespace
+
+SatSolver::SatSolver(const CnfFormula& formula) :
+    number_of_variables(formula.get_number_of_variables()),
+    is_unsatisfiable(false),
+    watches(2 * number_of_variables + 2),
+    values(number_of_variables + 1, -1),
+    saved_phases(number_of_variables + 1, false),
+    levels(number_of_variables + 1, 0),
+    reasons(number_of_variables + 1, -1),
+    propagation_head(0),
+    activities(number_of_variables + 1, 0.0),
+    activity_increment(1.0),
+    heap_positions(number_of_variables + 1, -1),
+    seen(number_of_variables + 1, false),
+    model(number_of_variables + 1, false),
+    number_of_conflicts(0),
+    number_of_decisions(0) {
+  for (int variable = 1; variable <= number_of_variables; variable++) {
+    heap_insert(variable);
+  }
+  for (int i = 0; i < formula.get_number_of_clauses(); i++) {
+    add_clause(formula.get_clause(i));
+  }
+}
+
+SatSolver::~SatSolver() {
+}
+
+void SatSolver::add_clause(const Clause& clause) {
+  assert(decision_level() == 0);
+  if (is_unsatisfiable) {
+    return;
+  }
+
+  std::vector<int> literals;
+  for (size_t i = 0; i < clause.size(); i++) {
+    assert(clause[i] != 0 && abs(clause[i]) <= number_of_variables);
+    literals.push_back(to_literal(clause[i]));
+  }
+  std::sort(literals.begin(), literals.end());
+  literals.erase(std::unique(literals.begin(), literals.end()),
+                 literals.end());
+
+  // Drop the literals that are false at level 0, and the whole clause if it
+  // is already satisfied or always true.
+  size_t kept = 0;
+  for (size_t i = 0; i < literals.size(); i++) {
+    if (value_of(literals[i]) == 1 ||
+        (i > 0 && literals[i] == negation(literals[i - 1]))) {
+      return;
+    }
+    if (value_of(literals[i]) == -1) {
+      literals[kept++] = literals[i];
+    }
+  }
+  literals.resize(kept);
+
+  if (literals.empty()) {
+    is_unsatisfiable = true;
+  } else if (literals.size() == 1) {
+    assign(literals[0], -1);
+    is_unsatisfiable = (propagate() != -1);
+  } else {
+    attach_clause(literals);
+  }
+}
+
+SatResult SatSolver::solve(long long max_conflicts) {
+  if (is_unsatisfiable) {
+    return UNSATISFIABLE;
+  }
+
+  long long conflicts = 0;
+  long long restarts = 0;
+  long long conflicts_until_restart = RESTART_BASE * luby(restarts);
+  std::vector<int> learnt;
+  while (true) {
+    int conflict = propagate();
+    if (conflict != -1) {
+      number_of_conflicts++;
+      conflicts++;
+      conflicts_until_restart--;
+      if (decision_level() == 0) {
+        is_unsatisfiable = true;
+        return UNSATISFIABLE;
+      }
+
+      int backjump_level;
+      analyze(conflict, &learnt, &backjump_level);
+      backtrack(backjump_level);
+      if (learnt.size() == 1) {
+        assign(learnt[0], -1);
+      } else {
+        assign(learnt[0], attach_clause(learnt));
+      }
+      activity_increment /= ACTIVITY_DECAY;
+
+      if (max_conflicts >= 0 && conflicts >= max_conflicts) {
+        backtrack(0);
+        return UNKNOWN;
+      }
+      continue;
+    }
+
+    if (conflicts_until_restart <= 0) {
+      backtrack(0);
+      restarts++;
+      conflicts_until_restart = RESTART_BASE * luby(restarts);
+      continue;
+    }
+
+    int literal = pick_branch_literal();
+    if (literal == -1) {
+      for (int variable = 1; variable <= number_of_variables; variable++) {
+        model[variable] = (values[variable] == 1);
+      }
+      backtrack(0);
+      return SATISFIABLE;
+    }
+    number_of_decisions++;
+    level_starts.push_back(trail.size());
+    assign(literal, -1);
+  }
+}
+
+int SatSolver::attach_clause(const std::vector<int>& literals) {
+  int clause = clauses.size();
+  clauses.push_back(literals);
+  watches[literals[0]].push_back(clause);
+  watches[literals[1]].push_back(clause);
+  return clause;
+}
+
+void SatSolver::assign(int literal, int reason) {
+  int variable = variable_of(literal);
+  values[variable] = (literal & 1) ? 0 : 1;
+  levels[variable] = decision_level();
+  reasons[variable] = reason;
+  trail.push_back(literal);
+}
+
+int SatSolver::propagate() {
+  while (propagation_head < trail.size()) {
+    int false_literal = negation(trail[propagation_head++]);
+    std::vector<int>& watching = watches[false_literal];
+    size_t kept = 0;
+    size_t i = 0;
+    while (i < watching.size()) {
+      int clause = watching[i++];
+      std::vector<int>& literals = clauses[clause];
+
+      // Keep the false literal second.
+      if (literals[0] == false_literal) {
+        std::swap(literals[0], literals[1]);
+      }
+      if (value_of(literals[0]) == 1) {
+        watching[kept++] = clause;
+        continue;
+      }
+
+      // Look for a new literal to watch.
+      bool moved = false;
+      for (size_t k = 2; k < literals.size(); k++) {
+        if (value_of(literals[k]) != 0) {
+          std::swap(literals[1], literals[k]);
+          watches[literals[1]].push_back(clause);
+          moved = true;
+          break;
+        }
+      }
+      if (moved) {
+        continue;
+      }
+
+      // The clause is unit or conflicting.
+      watching[kept++] = clause;
+      if (value_of(literals[0]) == 0) {
+        while (i < watching.size()) {
+          watching[kept++] = watching[i++];
+        }
+        watching.resize(kept);
+        return clause;
+      }
+      assign(literals[0], clause);
+    }
+    watching.resize(kept);
+  }
+  return -1;
+}
+
+void SatSolver::analyze(int conflict,
+                        std::vector<int>* learnt,
+                        int* backjump_level) {
+  learnt->assign(1, -1);
+  int paths = 0;
+  int literal = -1;
+  int trail_index = trail.size() - 1;
+  int clause = conflict;
+  do {
+    // The implied literal of a reason clause is its first.
+    const std::vector<int>& literals = clauses[clause];
+    for (size_t k = (literal == -1) ? 0 : 1; k < literals.size(); k++) {
+      int variable = variable_of(literals[k]);
+      if (seen[variable] || levels[variable] == 0) {
+        continue;
+      }
+      seen[variable] = true;
+      bump_activity(variable);
+      if (levels[variable] == decision_level()) {
+        paths++;
+      } else {
+        learnt->push_back(literals[k]);
+      }
+    }
+
+    // Resolve on the latest literal of this level in the conflict.
+    while (!seen[variable_of(trail[trail_index])]) {
+      trail_index--;
+    }
+    literal = trail[trail_index--];
+    clause = reasons[variable_of(literal)];
+    seen[variable_of(literal)] = false;
+    paths--;
+  } while (paths > 0);
+  (*learnt)[0] = negation(literal);
+
+  // Watch the literal of the highest level after the first, so it is the
+  // one unassigned by the backjump.
+  *backjump_level = 0;
+  for (size_t i = 1; i < learnt->size(); i++) {
+    int level = levels[variable_of((*learnt)[i])];
+    if (level > *backjump_level) {
+      *backjump_level = level;
+      std::swap((*learnt)[1], (*learnt)[i]);
+    }
+  }
+  for (size_t i = 1; i < learnt->size(); i++) {
+    seen[variable_of((*learnt)[i])] = false;
+  }
+}
+
+void SatSolver::backtrack(int level) {
+  if (decision_level() <= level) {
+    return;
+  }
+  for (size_t i = trail.size(); i > static_cast<size_t>(level_starts[level]);
+       i--) {
+    int variable = variable_of(trail[i - 1]);
+    saved_phases[variable] = (values[variable] == 1);
+    values[variable] = -1;
+    reasons[variable] = -1;
+    if (heap_positions[variable] == -1) {
+      heap_insert(variable);
+    }
+  }
+  trail.resize(level_starts[level]);
+  level_starts.resize(level);
+  propagation_head = trail.size();
+}
+
+int SatSolver::pick_branch_literal() {
+  while (!heap.empty()) {
+    int variable = heap_pop();
+    if (values[variable] == -1) {
+      return saved_phases[variable] ? 2 * variable : 2 * variable + 1;
+    }
+  }
+  return -1;
+}
+
+void SatSolver::bump_activity(int variable) {
+  activities[variable] += activity_increment;
+  if (activities[variable] > 1e100) {
+    for (int i = 1; i <= number_of_variables; i++) {
+      activities[i] *= 1e-100;
+    }
+    activity_increment *= 1e-100;
+  }
+  if (heap_positions[variable] != -1) {
+    heap_up(heap_positions[variable]);
+  }
+}
+
+void SatSolver::heap_insert(int variable) {
+  heap_positions[variable] = heap.size();
+  heap.push_back(variable);
+  heap_up(heap.size() - 1);
+}
+
+int SatSolver::heap_pop() {
+  int top = heap[0];
+  heap_positions[top] = -1;
+  heap[0] = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    heap_positions[heap[0]] = 0;
+    heap_down(0);
+  }
+  return top;
+}
+
+void SatSolver::heap_up(int position) {
+  int variable = heap[position];
+  while (position > 0) {
+    int parent = (position - 1) / 2;
+    if (activities[heap[parent]] >= activities[variable]) {
+      break;
+    }
+    heap[position] = heap[parent];
+    heap_positions[heap[position]] = position;
+    position = parent;
+  }
+  heap[position] = variable;
+  heap_positions[variable] = position;
+}
+
+void SatSolver::heap_down(int position) {
+  int variable = heap[position];
+  int size = heap.size();
+  while (2 * position + 1 < size) {
+    int child = 2 * position + 1;
+    if (child + 1 < size &&
+        activities[heap[child + 1]] > activities[heap[child]]) {
+      child++;
+    }
+    if (activities[heap[child]] <= activities[variable]) {
+      break;
+    }
+    heap[position] = heap[child];
+    heap_positions[heap[position]] = position;
+    position = child;
+  }
+  heap[position] = variable;
+  heap_positions[variable] = position;
+}
+
+}  // namespace sat_solver
+}  // namespace lib_kxing
@@ -0,0 +1,164 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// A conflict-driven clause learning (CDCL) SAT solver.
+//
+// Unit propagation watches two literals of each clause, so a clause is only
+// visited when one of its watched literals becomes false. Each conflict is
+// analysed back to its first unique implication point, and the learnt clause
+// is added to the formula before backjumping. Decisions take the unassigned
+// variable with the highest activity, where the variables in recent conflicts
+// gain activity, and reuse the last value the variable had. The search
+// restarts after a number of conflicts that follows the Luby sequence.
+//
+// Learnt clauses are never deleted, which suits the puzzle-sized formulas this
+// is meant for.
+// -----------------------------------------------------------------------------
+
+#ifndef _SAT_SOLVER_H_
+#define _SAT_SOLVER_H_
+
+#include <vector>
+
+#include "include/sat_solver/cnf_formula.h"
+
+namespace lib_kxing {
+namespace sat_solver {
+
+enum SatResult {
+  SATISFIABLE,
+  UNSATISFIABLE,
+  UNKNOWN,
+};
+
+class SatSolver {
+ public:
+  // The clauses of |formula| are copied.
+  explicit SatSolver(const CnfFormula& formula);
+  ~SatSolver();
+
+  // Solves the formula, giving up with UNKNOWN after |max_conflicts|
+  // conflicts, if it is not negative.
+  SatResult solve(long long max_conflicts = -1);
+
+  // The value of the variable in the model found by the last solve() that
+  // returned SATISFIABLE.
+  bool get_value(int variable) const {
+    return model[variable];
+  }
+
+  // Adds a clause between calls to solve(), for example to block the last
+  // model.
+  void add_clause(const Clause& clause);
+
+  long long get_number_of_conflicts() const {
+    return number_of_conflicts;
+  }
+
+  long long get_number_of_decisions() const {
+    return number_of_decisions;
+  }
+
+ private:
+  // Literals are stored as 2 * variable for the variable, and
+  // 2 * variable + 1 for its negation.
+  static int to_literal(int dimacs_literal) {
+    return (dimacs_literal > 0) ? 2 * dimacs_literal
+                                : 2 * -dimacs_literal + 1;
+  }
+
+  static int variable_of(int literal) {
+    return literal >> 1;
+  }
+
+  static int negation(int literal) {
+    return literal ^ 1;
+  }
+
+  // 1 if the literal is true, 0 if it is false, and -1 if it is unassigned.
+  int value_of(int literal) const {
+    int value = values[variable_of(literal)];
+    return (value == -1) ? -1 : value ^ (literal & 1);
+  }
+
+  int decision_level() const {
+    return level_starts.size();
+  }
+
+  // Adds a clause of internal literals, watching its first two literals.
+  // Returns the index of the clause.
+  int attach_clause(const std::vector<int>& literals);
+
+  void assign(int literal, int reason);
+
+  // Propagates the assignments on the trail. Returns the index of a
+  // conflicting clause, or -1.
+  int propagate();
+
+  // Finds the first-UIP clause of the conflict, and the level to jump back
+  // to.
+  void analyze(int conflict, std::vector<int>* learnt, int* backjump_level);
+
+  void backtrack(int level);
+
+  // Returns the next decision literal, or -1 if every variable is assigned.
+  int pick_branch_literal();
+
+  void bump_activity(int variable);
+
+  // The heap of variables by activity.
+  void heap_insert(int variable);
+  int heap_pop();
+  void heap_up(int position);
+  void heap_down(int position);
+
+  int number_of_variables;
+  bool is_unsatisfiable;
+
+  std::vector<std::vector<int> > clauses;
+
+  // For each literal, the clauses that watch it.
+  std::vector<std::vector<int> > watches;
+
+  std::vector<signed char> values;
+  std::vector<bool> saved_phases;
+  std::vector<int> levels;
+  std::vector<int> reasons;
+  std::vector<int> trail;
+  std::vector<int> level_starts;
+  size_t propagation_head;
+
+  std::vector<double> activities;
+  double activity_increment;
+  std::vector<int> heap;
+  std::vector<int> heap_positions;
+
+  std::vector<bool> seen;
+  std::vector<bool> model;
+
+  long long number_of_conflicts;
+  long long number_of_decisions;
+};
+
+}  // namespace sat_solver
+}  // namespace lib_kxing
+
+#endif  // _SAT_SOLVER_H_
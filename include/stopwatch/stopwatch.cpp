@@ -20,17 +20,103 @@
 
 #include "include/stopwatch/stopwatch.h"
 
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace lib_kxing {
 namespace stopwatch {
 
+namespace {
+
+#ifdef __linux__
+// The perf event type and config of each Counter.
+const uint32_t COUNTER_TYPES[NUMBER_OF_COUNTERS] = {
+  PERF_TYPE_HARDWARE,
+  PERF_TYPE_HARDWARE,
+  PERF_TYPE_HARDWARE,
+  PERF_TYPE_HW_CACHE,
+  PERF_TYPE_HW_CACHE,
+};
+
+const uint64_t COUNTER_CONFIGS[NUMBER_OF_COUNTERS] = {
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_BRANCH_MISSES,
+  PERF_COUNT_HW_CACHE_L1D |
+      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+  PERF_COUNT_HW_CACHE_LL |
+      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+};
+
+// Opens a counter of user-space events in this process, stopped. Returns -1
+// if it cannot be opened.
+int open_counter(Counter counter) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = COUNTER_TYPES[counter];
+  attr.config = COUNTER_CONFIGS[counter];
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+// The names of the counters, as printed.
+const char* const COUNTER_NAMES[NUMBER_OF_COUNTERS] = {
+  "cycles",
+  "instructions",
+  "branch misses",
+  "L1D misses",
+  "LLC misses",
+};
+
+}  // namespace
+
 StopWatch::StopWatch() :
     running(false), can_print(false) {
+  for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+    counter_fds[i] = -1;
+    counter_values[i] = 0;
+  }
 }
 
 StopWatch::~StopWatch() {
+#ifdef __linux__
+  for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+    if (counter_fds[i] != -1) {
+      close(counter_fds[i]);
+    }
+  }
+#endif
+}
+
+bool StopWatch::enable_counters() {
+  bool is_any_enabled = false;
+#ifdef __linux__
+  for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+    if (counter_fds[i] == -1) {
+      counter_fds[i] = open_counter(static_cast<Counter>(i));
+    }
+    is_any_enabled = is_any_enabled || counter_fds[i] != -1;
+  }
+#endif
+  return is_any_enabled;
 }
 
 void StopWatch::start() {
@@ -40,6 +126,14 @@ void StopWatch::start() {
   }
   running = true;
   can_print = false;
+#ifdef __linux__
+  for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+    if (counter_fds[i] != -1) {
+      ioctl(counter_fds[i], PERF_EVENT_IOC_RESET, 0);
+      ioctl(counter_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
   clock_gettime(CLOCK_MONOTONIC, &start_time);
 }
 
@@ -49,6 +143,24 @@ void StopWatch::stop() {
     return;
   }
   clock_gettime(CLOCK_MONOTONIC, &stop_time);
+#ifdef __linux__
+  for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+    if (counter_fds[i] == -1) {
+      continue;
+    }
+    ioctl(counter_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    // The count, and the times the counter was enabled and running.
+    uint64_t values[3];
+    if (read(counter_fds[i], values, sizeof(values)) != sizeof(values)) {
+      counter_values[i] = 0;
+    } else if (values[2] == 0 || values[2] == values[1]) {
+      counter_values[i] = values[0];
+    } else {
+      counter_values[i] = static_cast<unsigned long long>(
+          static_cast<double>(values[0]) * values[1] / values[2]);
+    }
+  }
+#endif
   running = false;
   can_print = true;
 }
@@ -66,11 +178,52 @@ void StopWatch::print_elapsed_time() {
     seconds--;
   }
   printf("Elapsed time: %lld.%09lld seconds\n", seconds, nanoseconds);
+
+  bool is_any_enabled = false;
+  for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+    is_any_enabled = is_any_enabled || counter_fds[i] != -1;
+  }
+  if (!is_any_enabled) {
+    return;
+  }
+  printf("Counters:");
+  for (int i = 0; i < NUMBER_OF_COUNTERS; i++) {
+    if (counter_fds[i] == -1) {
+      printf("%s n/a %s", (i == 0) ? "" : ",", COUNTER_NAMES[i]);
+    } else {
+      printf("%s %llu %s",
+             (i == 0) ? "" : ",",
+             counter_values[i],
+             COUNTER_NAMES[i]);
+    }
+    if (i == COUNTER_INSTRUCTIONS && counter_fds[COUNTER_CYCLES] != -1 &&
+        counter_fds[i] != -1 && counter_values[COUNTER_CYCLES] > 0) {
+      printf(" (%.2f per cycle)",
+             static_cast<double>(counter_values[i]) /
+                 counter_values[COUNTER_CYCLES]);
+    }
+  }
+  printf("\n");
+}
+
+double StopWatch::get_elapsed_seconds() const {
+  return (stop_time.tv_sec - start_time.tv_sec) +
+         1e-9 * (stop_time.tv_nsec - start_time.tv_nsec);
+}
+
+bool StopWatch::get_counter(Counter counter,
+                            unsigned long long* value) const {
+  if (counter_fds[counter] == -1) {
+    return false;
+  }
+  *value = counter_values[counter];
+  return true;
 }
 
 // static
 void StopWatch::time_function(void (*function)()) {
   StopWatch watch;
+  watch.enable_counters();
   watch.start();
   function();
   watch.stop();
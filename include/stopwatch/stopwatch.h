@@ -26,16 +26,42 @@
 namespace lib_kxing {
 namespace stopwatch {
 
+// The hardware events that a StopWatch can count.
+enum Counter {
+  COUNTER_CYCLES,
+  COUNTER_INSTRUCTIONS,
+  COUNTER_BRANCH_MISSES,
+  COUNTER_L1D_MISSES,
+  COUNTER_LLC_MISSES,
+  NUMBER_OF_COUNTERS,
+};
+
 class StopWatch {
  public:
   StopWatch();
   ~StopWatch();
 
+  // Also counts hardware events between start() and stop(), with Linux's
+  // perf_event_open(), in this thread and the threads it starts from now on.
+  // Returns false if no counter can be opened, as on other systems, in
+  // virtual machines without a PMU, or when perf_event_paranoid forbids it;
+  // the watch then only keeps time. Counters that cannot be opened on their
+  // own are left out.
+  bool enable_counters();
+
   void start();
   void stop();
   void print_elapsed_time();
 
-  // Prints out the time it takes to run the given function.
+  // The time between start() and stop(), in seconds.
+  double get_elapsed_seconds() const;
+
+  // Sets |value| to the count of |counter| between start() and stop().
+  // Returns false if the counter is not enabled.
+  bool get_counter(Counter counter, unsigned long long* value) const;
+
+  // Prints out the time it takes to run the given function, and the counts
+  // of the hardware events where they are available.
   static void time_function(void (*function)());
 
  private:
@@ -43,6 +69,11 @@ class StopWatch {
   bool can_print;
   timespec start_time;
   timespec stop_time;
+
+  // The file descriptor of each counter, or -1 if it is not enabled, and
+  // its count, scaled up when the kernel had to share the hardware.
+  int counter_fds[NUMBER_OF_COUNTERS];
+  unsigned long long counter_values[NUMBER_OF_COUNTERS];
 };
 
 }  // namespace stopwatch
@@ -0,0 +1,172 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// The following code reads the glyphs off three pixel pictures: seven-segment
+// digits, flag semaphore letters and a 5 x 5 pixel font. In a picture, '#' is
+// a filled pixel, '.' an unfilled pixel, and '?' a pixel that is not known.
+//
+// Each square of the Board holds one glyph, so every known pixel restricts the
+// domain of its square to the glyphs that agree with it. A picture with
+// unknown pixels may have several readings.
+// -----------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/domain.h"
+
+#include "include/glyph_board/glyph_board.h"
+#include "include/glyph_board/glyph_set.h"
+#include "include/glyph_board/glyph_sets.h"
+
+#include "include/stopwatch/stopwatch.h"
+
+using lib_kxing::brute_force_solver::Board;
+using lib_kxing::brute_force_solver::Domain;
+
+using lib_kxing::glyph_board::GlyphBoard;
+using lib_kxing::glyph_board::GlyphSet;
+using lib_kxing::glyph_board::GlyphStates;
+using lib_kxing::glyph_board::PIXEL_EMPTY;
+using lib_kxing::glyph_board::PIXEL_FILLED;
+using lib_kxing::glyph_board::PIXEL_FONT_GLYPHS;
+using lib_kxing::glyph_board::PIXEL_UNFILLED;
+using lib_kxing::glyph_board::PixelType;
+using lib_kxing::glyph_board::SEMAPHORE_GLYPHS;
+using lib_kxing::glyph_board::SEVEN_SEGMENT_GLYPHS;
+using lib_kxing::glyph_board::glyphs_with_pixel;
+
+using lib_kxing::stopwatch::StopWatch;
+
+// The digits 2026, where the middle segment and the upper right segment of
+// the last digit are not known: it reads as 0, 6 or 8.
+const char* const SEVEN_SEGMENT_PICTURE[] = {
+  ".#..#..#..#.",
+  "..##.#..##.?",
+  ".#.....#..?.",
+  "#..#.##..#.#",
+  ".#..#..#..#.",
+};
+
+// The letters HUNT.
+const char* const SEMAPHORE_PICTURE[] = {
+  "...#.#...##.",
+  "##..#..#..#.",
+  "#.....#.#...",
+};
+
+// The letters GLYPH, with a few pixels missing.
+const char* const PIXEL_FONT_PICTURE[] = {
+  ".#####....#...#####.#...#",
+  "#....#.....#.#.#...##...#",
+  "#..###..????#..####.#####",
+  "#...##......#..#....#...#",
+  ".###.#####..#..#....#...#",
+};
+
+// Returns the type of the pixel at (|row|, |column|) of |picture|, or
+// PIXEL_EMPTY if it is not known.
+PixelType read_pixel(const char* const* picture, int row, int column) {
+  switch (picture[row][column]) {
+    case '#':
+      return PIXEL_FILLED;
+    case '.':
+      return PIXEL_UNFILLED;
+    default:
+      return PIXEL_EMPTY;
+  }
+}
+
+// Reads one row of |number_of_glyphs| glyphs of |glyph_set| off |picture|,
+// and prints the first reading and the number of readings.
+void decode(const GlyphSet* const glyph_set,
+            int number_of_glyphs,
+            const char* const* picture) {
+  GlyphStates glyph_states(glyph_set);
+  GlyphBoard glyph_board(1, number_of_glyphs, glyph_set);
+
+  std::vector<int> search_order(number_of_glyphs);
+  for (int i = 0; i < number_of_glyphs; i++) {
+    search_order[i] = i;
+  }
+  Board board(number_of_glyphs,
+              glyph_states.get_state_list(),
+              &search_order[0],
+              NULL);
+
+  // A glyph fits a square if it agrees with every known pixel.
+  bool is_consistent = true;
+  for (int pixel = 0; pixel < glyph_board.get_number_of_pixels(); pixel++) {
+    PixelType type = read_pixel(picture,
+                                pixel / glyph_board.get_pixel_columns(),
+                                pixel % glyph_board.get_pixel_columns());
+    if (type == PIXEL_EMPTY) {
+      continue;
+    }
+    Domain filled =
+        glyphs_with_pixel(*glyph_set, glyph_board.bit_of_pixel(pixel));
+    if (!board.restrict_domain(glyph_board.big_square_of_pixel(pixel),
+                               (type == PIXEL_FILLED) ? filled : ~filled)) {
+      is_consistent = false;
+    }
+  }
+
+  Board* solution = is_consistent ? board.find_solution() : NULL;
+  if (solution == NULL) {
+    // Found no reading.
+    printf("No reading found\n");
+    return;
+  }
+  solution->pretty_print(number_of_glyphs);
+
+  // Check the reading against the picture, one glyph at a time.
+  int mismatches = 0;
+  for (int square = 0; square < number_of_glyphs; square++) {
+    for (int i = 0; i < glyph_set->rows; i++) {
+      for (int j = 0; j < glyph_set->columns; j++) {
+        int pixel = glyph_board.pixel_of(square, i, j);
+        PixelType type = read_pixel(picture,
+                                    pixel / glyph_board.get_pixel_columns(),
+                                    pixel % glyph_board.get_pixel_columns());
+        if (type != PIXEL_EMPTY &&
+            type != glyph_board.get_pixel(solution, pixel)) {
+          mismatches++;
+        }
+      }
+    }
+  }
+  delete solution;
+  printf("Pixels that disagree with the picture: %d\n", mismatches);
+  printf("Number of readings: %llu\n", board.count_solutions());
+}
+
+void solve() {
+  decode(&SEVEN_SEGMENT_GLYPHS, 4, SEVEN_SEGMENT_PICTURE);
+  decode(&SEMAPHORE_GLYPHS, 4, SEMAPHORE_PICTURE);
+  decode(&PIXEL_FONT_GLYPHS, 5, PIXEL_FONT_PICTURE);
+}
+
+int main() {
+  StopWatch::time_function(&solve);
+  return 0;
+}
@@ -20,10 +20,14 @@
 
 #include "tests/mystery_hunt/braille_board.h"
 
+#include <assert.h>
+
 #include "include/brute_force_solver/state.h"
+#include "include/glyph_board/glyph_sets.h"
 
 using lib_kxing::brute_force_solver::State;
 using lib_kxing::brute_force_solver::StateList;
+using lib_kxing::glyph_board::BRAILLE_GLYPHS;
 
 static State* ALL_STATES[NUMBER_OF_STATES];
 const StateList STATE_LIST(ALL_STATES, NUMBER_OF_STATES);
@@ -42,112 +46,60 @@ void delete_all_states() {
   }
 }
 
-const SmallSquareType BRAILLE[NUMBER_OF_STATES]
-                             [BRAILLE_ROWS]
-                             [BRAILLE_COLUMNS] = {
-  {    // Braille A.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille B.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille C.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille D.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille E.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille F.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille G.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille H.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille I.
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille J.
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-  }, { // Braille K.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille L.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille M.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille N.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille O.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille P.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille Q.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille R.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille S.
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille T.
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-  }, { // Braille U.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-  }, { // Braille V.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-  }, { // Braille W.
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_FILLED},
-  }, { // Braille X.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_UNFILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-  }, { // Braille Y.
-    {SMALL_FILLED, SMALL_FILLED},
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-  }, { // Braille Z.
-    {SMALL_FILLED, SMALL_UNFILLED},
-    {SMALL_UNFILLED, SMALL_FILLED},
-    {SMALL_FILLED, SMALL_FILLED},
-  },
+namespace {
+
+struct DotPatterns {
+  int patterns[NUMBER_OF_STATES];
+};
+
+struct CompatibilityTable {
+  LetterSet letters[NUMBER_OF_DOT_PATTERNS][NUMBER_OF_DOT_PATTERNS];
 };
+
+constexpr DotPatterns build_dot_patterns() {
+  DotPatterns result = {};
+  for (int letter = 0; letter < NUMBER_OF_STATES; letter++) {
+    for (int i = 0; i < BRAILLE_ROWS; i++) {
+      for (int j = 0; j < BRAILLE_COLUMNS; j++) {
+        if (BRAILLE_GLYPHS.masks[letter] & BRAILLE_GLYPHS.pixel_bit(i, j)) {
+          result.patterns[letter] |= braille_dot(i, j);
+        }
+      }
+    }
+  }
+  return result;
+}
+
+constexpr DotPatterns DOT_PATTERNS = build_dot_patterns();
+
+// Indexed by [known_mask][known_values]. Entries where |known_values| has bits
+// outside of |known_mask| are never read.
+constexpr CompatibilityTable build_compatibility_table() {
+  CompatibilityTable result = {};
+  for (int mask = 0; mask < NUMBER_OF_DOT_PATTERNS; mask++) {
+    // Enumerate the subsets of |mask|.
+    int values = mask;
+    while (true) {
+      for (int letter = 0; letter < NUMBER_OF_STATES; letter++) {
+        if ((DOT_PATTERNS.patterns[letter] & mask) == values) {
+          result.letters[mask][values] |= 1u << letter;
+        }
+      }
+      if (values == 0) {
+        break;
+      }
+      values = (values - 1) & mask;
+    }
+  }
+  return result;
+}
+
+constexpr CompatibilityTable COMPATIBILITY_TABLE =
+    build_compatibility_table();
+
+}  // namespace
+
+LetterSet compatible_letters(int known_mask, int known_values) {
+  assert(0 <= known_mask && known_mask < NUMBER_OF_DOT_PATTERNS);
+  return COMPATIBILITY_TABLE.letters[known_mask][known_values & known_mask];
+}
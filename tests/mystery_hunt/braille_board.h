@@ -49,6 +49,7 @@
 #define _BRAILLE_BOARD_H_
 
 #include "include/brute_force_solver/state_list.h"
+#include "include/glyph_board/glyph_board.h"
 
 #define NUMBER_OF_ROWS 5
 #define NUMBER_OF_COLUMNS 5
@@ -56,6 +57,8 @@
 
 #define BRAILLE_ROWS 3
 #define BRAILLE_COLUMNS 2
+#define BRAILLE_DOTS (BRAILLE_ROWS * BRAILLE_COLUMNS)
+#define NUMBER_OF_DOT_PATTERNS (1 << BRAILLE_DOTS)
 
 #define NUMBER_OF_STATES 26
 
@@ -64,15 +67,28 @@ extern const lib_kxing::brute_force_solver::StateList STATE_LIST;
 void create_all_states();
 void delete_all_states();
 
-// Fine-grained board.
+// Fine-grained board. The values match the PixelType of the glyph board.
 enum SmallSquareType {
-  SMALL_EMPTY,
-  SMALL_FILLED,
-  SMALL_UNFILLED,
+  SMALL_EMPTY = lib_kxing::glyph_board::PIXEL_EMPTY,
+  SMALL_FILLED = lib_kxing::glyph_board::PIXEL_FILLED,
+  SMALL_UNFILLED = lib_kxing::glyph_board::PIXEL_UNFILLED,
 };
 
-extern const SmallSquareType BRAILLE[NUMBER_OF_STATES]
-                                    [BRAILLE_ROWS]
-                                    [BRAILLE_COLUMNS];
+// A set of letters, where bit i is set if the letter ('A' + i) is in the set.
+typedef unsigned int LetterSet;
+
+// Returns the bit of the dot at (|small_row|, |small_column|) in a dot pattern.
+constexpr int braille_dot(int small_row, int small_column) {
+  return 1 << (small_row * BRAILLE_COLUMNS + small_column);
+}
+
+// Returns the letters whose dots match |known_values| at every dot in
+// |known_mask|, where the bit braille_dot(row, column) stands for the dot at
+// (row, column). Dots outside of |known_mask| may be either filled or
+// unfilled.
+//
+// The answers are precomputed from BRAILLE_GLYPHS at compile time, so this is
+// a single table lookup.
+LetterSet compatible_letters(int known_mask, int known_values);
 
 #endif  // _BRAILLE_BOARD_H_
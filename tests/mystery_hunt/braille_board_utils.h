@@ -21,29 +21,36 @@
 #ifndef _BRAILLE_BOARD_UTILS_
 #define _BRAILLE_BOARD_UTILS_
 
+#include "include/brute_force_solver/binary_constraints.h"
 #include "include/brute_force_solver/board.h"
+#include "include/glyph_board/glyph_board.h"
+#include "include/glyph_board/glyph_sets.h"
 #include "tests/mystery_hunt/braille_board.h"
 
+typedef lib_kxing::glyph_board::FixedGlyphBoard<NUMBER_OF_ROWS,
+                                                NUMBER_OF_COLUMNS,
+                                                BRAILLE_ROWS,
+                                                BRAILLE_COLUMNS>
+    BrailleGlyphBoard;
+
+// The states of STATE_LIST are the letters in alphabetical order, which is
+// also the order of BRAILLE_GLYPHS.
 static SmallSquareType get_small_square_type(
     const lib_kxing::brute_force_solver::Board* const board, int index) {
-  int big_row =
-      (index / (NUMBER_OF_COLUMNS * BRAILLE_COLUMNS)) / BRAILLE_ROWS;
-  int big_column =
-      (index % (NUMBER_OF_COLUMNS * BRAILLE_COLUMNS)) / BRAILLE_COLUMNS;
-  int small_row =
-      (index / (NUMBER_OF_COLUMNS * BRAILLE_COLUMNS)) % BRAILLE_ROWS;
-  int small_column = 
-      (index % (NUMBER_OF_COLUMNS * BRAILLE_COLUMNS)) % BRAILLE_COLUMNS;
+  return static_cast<SmallSquareType>(BrailleGlyphBoard::get_pixel(
+      board, lib_kxing::glyph_board::BRAILLE_GLYPHS, index));
+}
 
-  const lib_kxing::brute_force_solver::State* state =
-      board->get_value(big_row * NUMBER_OF_COLUMNS + big_column);
-  if (state == lib_kxing::brute_force_solver::EMPTY) {
-    return SMALL_EMPTY;
-  }
-  
-  // Get the Braille pattern associated with the letter.
-  char letter = state->get_pretty_print_string()[0];
-  return BRAILLE[letter - 'A'][small_row][small_column];
+// Returns the small square |index| as a cell for the binary constraints: it is
+// filled for the letters that have its dot.
+inline lib_kxing::brute_force_solver::BinaryCell small_square_cell(int index) {
+  lib_kxing::brute_force_solver::BinaryCell cell = {
+    BrailleGlyphBoard::big_square_of_pixel(index),
+    lib_kxing::glyph_board::glyphs_with_pixel(
+        lib_kxing::glyph_board::BRAILLE_GLYPHS,
+        BrailleGlyphBoard::bit_of_pixel(index)),
+  };
+  return cell;
 }
 
 #endif  // _BRAILLE_BOARD_UTILS_
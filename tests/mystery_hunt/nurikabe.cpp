@@ -31,39 +31,111 @@
 // 20 21 22 23 24
 // -----------------------------------------------------------------------------
 
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <thread>
+
 #include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/portfolio_solver.h"
+#include "include/brute_force_solver/progress_listener.h"
+#include "include/brute_force_solver/search_order_tuner.h"
+#include "include/brute_force_solver/search_trace.h"
+#include "include/brute_force_solver/solve_handle.h"
 #include "include/brute_force_solver/state.h"
 #include "include/brute_force_solver/state_list.h"
 
+#include "include/glyph_board/glyph_compatibility.h"
+#include "include/glyph_board/glyph_sets.h"
+#include "include/grid/grid_geometry.h"
 #include "include/stopwatch/stopwatch.h"
 
 #include "tests/mystery_hunt/braille_board.h"
 #include "tests/mystery_hunt/braille_board_utils.h"
 
 using lib_kxing::brute_force_solver::Board;
+using lib_kxing::brute_force_solver::PortfolioSolver;
+using lib_kxing::brute_force_solver::SearchOrderTuner;
+using lib_kxing::brute_force_solver::SearchProgress;
+using lib_kxing::brute_force_solver::SearchTrace;
+using lib_kxing::brute_force_solver::SolveHandle;
+using lib_kxing::glyph_board::BoundaryConstraints;
+using lib_kxing::glyph_board::GlyphWindow;
+using lib_kxing::grid::GridGeometry;
 using lib_kxing::stopwatch::StopWatch;
 
-const int NUMBER_OF_DIRECTIONS = 4;
-const int delta_x[NUMBER_OF_DIRECTIONS] = {1, 0, -1, 0};
-const int delta_y[NUMBER_OF_DIRECTIONS] = {0, 1, 0, -1};
+using lib_kxing::glyph_board::BOUNDARY_HORIZONTAL;
+using lib_kxing::glyph_board::BOUNDARY_VERTICAL;
+using lib_kxing::glyph_board::BRAILLE_GLYPHS;
+using lib_kxing::glyph_board::PIXEL_FILLED;
+using lib_kxing::grid::NUMBER_OF_ORTHOGONAL_DIRECTIONS;
+using lib_kxing::grid::WINDOW_BOTTOM_LEFT;
+using lib_kxing::grid::WINDOW_BOTTOM_RIGHT;
+using lib_kxing::grid::WINDOW_TOP_LEFT;
+using lib_kxing::grid::WINDOW_TOP_RIGHT;
 
-int row_of_square(int square) {
-  return square / (NUMBER_OF_COLUMNS * BRAILLE_COLUMNS);
-}
+// The lookahead before the search stops after this many passes, and splits
+// each pass between this many threads.
+const int LOOKAHEAD_PASSES = 1;
+const int NUMBER_OF_THREADS = 2;
 
-int column_of_square(int square) {
-  return square % (NUMBER_OF_COLUMNS * BRAILLE_COLUMNS);
-}
+// Runs with --tune tune the search order for this many rounds, with probes of
+// at most this many nodes, and save it to the profile, which later runs load.
+const int TUNING_ROUNDS = 20;
+const unsigned long long TUNING_NODE_LIMIT = 1 << 20;
+const char* const PROFILE_PATH = "nurikabe.profile";
 
-int row_and_column_to_square(int row, int column) {
-  return row * NUMBER_OF_COLUMNS * BRAILLE_COLUMNS + column;
-}
+// Runs with --portfolio record the winning configuration here.
+const char* const PORTFOLIO_PROFILE_PATH = "nurikabe.portfolio";
+
+// The grid of small squares.
+const GridGeometry GRID(NUMBER_OF_ROWS * BRAILLE_ROWS,
+                        NUMBER_OF_COLUMNS * BRAILLE_COLUMNS);
 
-const int VARIABLE = NUMBER_OF_SQUARES * BRAILLE_ROWS * BRAILLE_COLUMNS + 1;
+const int NUMBER_OF_SMALL_SQUARES =
+    NUMBER_OF_SQUARES * BRAILLE_ROWS * BRAILLE_COLUMNS;
+
+// The small squares in the padded layout of GRID.
+const int NUMBER_OF_PADDED_SQUARES =
+    (NUMBER_OF_ROWS * BRAILLE_ROWS + 2) *
+    (NUMBER_OF_COLUMNS * BRAILLE_COLUMNS + 2);
+
+const int VARIABLE = NUMBER_OF_SMALL_SQUARES + 1;
+
+struct Clue {
+  int row;
+  int column;
+  int size;
+};
+
+const int NUMBER_OF_CLUES = 14;
+const Clue CLUES[NUMBER_OF_CLUES] = {
+  {0, 2, 3},  // The number 3 in the first row, third column.
+  {2, 3, 9},  // The number 9 in the third row, fourth column.
+  {2, 8, 6},  // The number 6 in the third row, ninth column.
+  {3, 1, 2},  // The number 2 in the fourth row, second column.
+  {5, 2, 5},  // The number 5 in the sixth row, third column.
+  {5, 5, 4},  // The number 4 in the sixth row, sixth column.
+  {5, 8, 8},  // The number 8 in the sixth row, ninth column.
+  {6, 0, 1},  // The number 1 in the seventh row, first column.
+  {8, 4, 2},  // The number 2 in the ninth row, fifth column.
+  {9, 5, 4},  // The number 4 in the tenth row, sixth column.
+  {10, 4, 3},  // The number 3 in the eleventh row, fifth column.
+  {12, 8, 4},  // The number 4 in the thirteenth row, ninth column.
+  {13, 1, 9},  // The number 9 in the fourteenth row, second column.
+  {14, 5, 9},  // The number 9 in the fifteenth row, sixth column.
+};
+
+int total_island_size() {
+  int total = 0;
+  for (int i = 0; i < NUMBER_OF_CLUES; i++) {
+    total += CLUES[i].size;
+  }
+  return total;
+}
 
 // Returns true if one of the following conditions is true:
 //    - The size of the block of either land/water starting at |square| is
@@ -104,19 +176,11 @@ bool can_match_group_size(const Board* const board,
   // Whether we have hit an SMALL_EMPTY square.
   bool tentative_accept = false;
   while (processed < length_of_queue) {
-    // Go through all four adjacent squares.
-    for (int i = 0; i < NUMBER_OF_DIRECTIONS; i++) {
-      int next_row = row_of_square(queue[processed]) + delta_x[i];
-      int next_column = column_of_square(queue[processed]) + delta_y[i];
-
-      // Ignore this square if we fall off the board.
-      if (!(0 <= next_row && next_row < NUMBER_OF_ROWS * BRAILLE_ROWS &&
-            0 <= next_column && next_column < NUMBER_OF_COLUMNS * BRAILLE_COLUMNS)) {
-        continue;
-      }
-
-      // Process this square.
-      int next_square = row_and_column_to_square(next_row, next_column);
+    // Go through all adjacent squares.
+    const int* neighbours = GRID.get_neighbours4(queue[processed]);
+    int number_of_neighbours = GRID.get_number_of_neighbours4(queue[processed]);
+    for (int i = 0; i < number_of_neighbours; i++) {
+      int next_square = neighbours[i];
 
       if (get_small_square_type(board, next_square) == state_type) {
         if (checked[next_square]) {
@@ -141,121 +205,264 @@ bool can_match_group_size(const Board* const board,
   return (length_of_queue == target);
 }
 
-bool validator(const Board* const board) {
-  bool checked[NUMBER_OF_SQUARES * BRAILLE_ROWS * BRAILLE_COLUMNS];
-  memset(checked, 0, sizeof(checked));
-
-  // The number 3 in the first row, third column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(0, 2),
-                            3,
-                            checked)) {
-    return false;
-  }
-  // The number 9 in the third row, fourth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(2, 3),
-                            9,
-                            checked)) {
-    return false;
-  }
-  // The number 6 in the third row, ninth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(2, 8),
-                            6,
-                            checked)) {
-    return false;
-  }
-  // The number 2 in the fourth row, second column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(3, 1),
-                            2,
-                            checked)) {
-    return false;
+// The no-lakes rule, restricted to the pixels of two neighbouring letters.
+bool has_no_lakes(const GlyphWindow& window) {
+  for (int i = 1; i < window.get_rows(); i++) {
+    for (int j = 1; j < window.get_columns(); j++) {
+      if (window.get_pixel(i, j) == PIXEL_FILLED &&
+          window.get_pixel(i - 1, j) == PIXEL_FILLED &&
+          window.get_pixel(i, j - 1) == PIXEL_FILLED &&
+          window.get_pixel(i - 1, j - 1) == PIXEL_FILLED) {
+        return false;
+      }
+    }
   }
-  // The number 5 in the sixth row, third column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(5, 2),
-                            5,
-                            checked)) {
-    return false;
+  return true;
+}
+
+// For each small square, the bitmask of the clues whose islands could reach
+// it on an empty board: those within a Manhattan distance less than the size
+// of the clue. Filled in once by compute_clues_in_reach().
+int clues_in_reach[NUMBER_OF_SMALL_SQUARES];
+
+void compute_clues_in_reach() {
+  for (int i = 0; i < NUMBER_OF_SMALL_SQUARES; i++) {
+    clues_in_reach[i] = 0;
+    for (int j = 0; j < NUMBER_OF_CLUES; j++) {
+      int distance = abs(GRID.row_of(i) - CLUES[j].row) +
+                     abs(GRID.column_of(i) - CLUES[j].column);
+      if (distance < CLUES[j].size) {
+        clues_in_reach[i] |= 1 << j;
+      }
+    }
   }
-  // The number 4 in the sixth row, sixth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(5, 5),
-                            4,
-                            checked)) {
-    return false;
+}
+
+// Returns the letters that square |big_square| may hold on an empty board:
+// small squares out of reach of every clue must be water, and the small
+// squares of the clues must be land.
+LetterSet letters_allowed_by_reach(int big_square) {
+  int known_mask = 0;
+  int known_values = 0;
+  for (int i = 0; i < BRAILLE_ROWS; i++) {
+    for (int j = 0; j < BRAILLE_COLUMNS; j++) {
+      int small_square = BrailleGlyphBoard::pixel_of(big_square, i, j);
+      if (clues_in_reach[small_square] == 0) {
+        known_mask |= braille_dot(i, j);
+        known_values |= braille_dot(i, j);
+      }
+    }
   }
-  // The number 8 in the sixth row, ninth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(5, 8),
-                            8,
-                            checked)) {
-    return false;
+  for (int i = 0; i < NUMBER_OF_CLUES; i++) {
+    int small_square = GRID.square_at(CLUES[i].row, CLUES[i].column);
+    if (BrailleGlyphBoard::big_square_of_pixel(small_square) == big_square) {
+      int row = CLUES[i].row % BRAILLE_ROWS;
+      int column = CLUES[i].column % BRAILLE_COLUMNS;
+      known_mask |= braille_dot(row, column);
+    }
   }
-  // The number 1 in the seventh row, first column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(6, 0),
-                            1,
-                            checked)) {
-    return false;
+  return compatible_letters(known_mask, known_values);
+}
+
+// Returns false if some island can no longer be completed:
+//    - Two clues are in the same island, or a clue is on water.
+//    - An island cannot grow to its size through the small squares it can
+//      still reach. An island that needs k more squares can only reach
+//      squares within k steps, through squares that are not water and not
+//      next to another clue's island.
+//    - A land square is out of reach of every island.
+//
+// All searches are bounded by the squares each island still needs, so this
+// stays cheap at every node.
+bool islands_can_be_completed(const Board* const board) {
+  // The clue whose island contains each small square, or -1.
+  int owner[NUMBER_OF_SMALL_SQUARES];
+  memset(owner, -1, sizeof(owner));
+
+  // Whether some island could still cover each small square.
+  bool reachable[NUMBER_OF_SMALL_SQUARES];
+  memset(reachable, 0, sizeof(reachable));
+
+  int queue[NUMBER_OF_SMALL_SQUARES];
+  int island_start[NUMBER_OF_CLUES];
+  int island_size[NUMBER_OF_CLUES];
+  int length_of_queue = 0;
+
+  // Find the current island of each clue. The islands are stored one after
+  // another in |queue|.
+  for (int i = 0; i < NUMBER_OF_CLUES; i++) {
+    int square = GRID.square_at(CLUES[i].row, CLUES[i].column);
+    if (get_small_square_type(board, square) == SMALL_FILLED) {
+      return false;
+    }
+    if (owner[square] != -1) {
+      return false;
+    }
+
+    island_start[i] = length_of_queue;
+    queue[length_of_queue++] = square;
+    owner[square] = i;
+    for (int processed = island_start[i];
+         processed < length_of_queue;
+         processed++) {
+      const int* neighbours = GRID.get_neighbours4(queue[processed]);
+      int number_of_neighbours =
+          GRID.get_number_of_neighbours4(queue[processed]);
+      for (int j = 0; j < number_of_neighbours; j++) {
+        int next_square = neighbours[j];
+        if (get_small_square_type(board, next_square) != SMALL_UNFILLED) {
+          continue;
+        }
+        if (owner[next_square] == i) {
+          continue;
+        }
+        if (owner[next_square] != -1) {
+          // Two clues in one island.
+          return false;
+        }
+        owner[next_square] = i;
+        queue[length_of_queue++] = next_square;
+      }
+    }
+    island_size[i] = length_of_queue - island_start[i];
+    if (island_size[i] > CLUES[i].size) {
+      return false;
+    }
   }
-  // The number 2 in the ninth row, fifth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(8, 4),
-                            2,
-                            checked)) {
-    return false;
+
+  // Grow each island as far as its remaining size allows.
+  int frontier[NUMBER_OF_SMALL_SQUARES];
+  int distance[NUMBER_OF_SMALL_SQUARES];
+  int visited_by[NUMBER_OF_SMALL_SQUARES];
+  memset(visited_by, -1, sizeof(visited_by));
+  for (int i = 0; i < NUMBER_OF_CLUES; i++) {
+    int budget = CLUES[i].size - island_size[i];
+    int length_of_frontier = 0;
+    for (int j = 0; j < island_size[i]; j++) {
+      int square = queue[island_start[i] + j];
+      reachable[square] = true;
+      visited_by[square] = i;
+      distance[square] = 0;
+      frontier[length_of_frontier++] = square;
+    }
+
+    int reached = 0;
+    for (int processed = 0; processed < length_of_frontier; processed++) {
+      int square = frontier[processed];
+      if (distance[square] == budget) {
+        continue;
+      }
+      const int* neighbours = GRID.get_neighbours4(square);
+      int number_of_neighbours = GRID.get_number_of_neighbours4(square);
+      for (int j = 0; j < number_of_neighbours; j++) {
+        int next_square = neighbours[j];
+        if (visited_by[next_square] == i ||
+            get_small_square_type(board, next_square) == SMALL_FILLED ||
+            owner[next_square] != -1) {
+          continue;
+        }
+
+        // A square next to another clue's island would join the two.
+        bool touches_other_island = false;
+        const int* next_neighbours = GRID.get_neighbours4(next_square);
+        int number_of_next_neighbours =
+            GRID.get_number_of_neighbours4(next_square);
+        for (int k = 0; k < number_of_next_neighbours; k++) {
+          int owner_of_neighbour = owner[next_neighbours[k]];
+          if (owner_of_neighbour != -1 && owner_of_neighbour != i) {
+            touches_other_island = true;
+            break;
+          }
+        }
+        if (touches_other_island) {
+          continue;
+        }
+
+        visited_by[next_square] = i;
+        distance[next_square] = distance[square] + 1;
+        reachable[next_square] = true;
+        frontier[length_of_frontier++] = next_square;
+        reached++;
+      }
+    }
+    if (reached < budget) {
+      return false;
+    }
   }
-  // The number 4 in the tenth row, sixth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(9, 5),
-                            4,
-                            checked)) {
-    return false;
+
+  // Every land square must belong to some island.
+  for (int i = 0; i < NUMBER_OF_SMALL_SQUARES; i++) {
+    if (!reachable[i] &&
+        get_small_square_type(board, i) == SMALL_UNFILLED) {
+      return false;
+    }
   }
-  // The number 3 in the eleventh row, fifth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(10, 4),
-                            3,
-                            checked)) {
-    return false;
+  return true;
+}
+
+// Returns false if the water can no longer form a single stream: some water
+// square cannot reach the others through squares that are not land.
+//
+// The flood fill runs over the padded layout of the grid, with land in the
+// border, so it steps to a neighbour by adding an offset and never leaves the
+// array.
+bool water_can_connect(const Board* const board) {
+  assert(GRID.get_number_of_padded_squares() == NUMBER_OF_PADDED_SQUARES);
+  SmallSquareType types[NUMBER_OF_PADDED_SQUARES];
+  for (int padded = 0; padded < NUMBER_OF_PADDED_SQUARES; padded++) {
+    int square = GRID.square_of_padded(padded);
+    types[padded] = (square == -1) ?
+        SMALL_UNFILLED : get_small_square_type(board, square);
   }
-  // The number 4 in the thirteenth row, ninth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(12, 8),
-                            4,
-                            checked)) {
-    return false;
+
+  int queue[NUMBER_OF_SMALL_SQUARES];
+  int length_of_queue = 0;
+  bool checked[NUMBER_OF_PADDED_SQUARES];
+  memset(checked, 0, sizeof(checked));
+
+  int number_of_water_squares = 0;
+  for (int i = 0; i < NUMBER_OF_SMALL_SQUARES; i++) {
+    int padded = GRID.padded_of(i);
+    if (types[padded] == SMALL_FILLED) {
+      if (number_of_water_squares == 0) {
+        queue[length_of_queue++] = padded;
+        checked[padded] = true;
+      }
+      number_of_water_squares++;
+    }
   }
-  // The number 9 in the fourteenth row, second column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(13, 1),
-                            9,
-                            checked)) {
-    return false;
+
+  const int* offsets = GRID.get_padded_offsets();
+  int reached_water_squares = 0;
+  for (int processed = 0; processed < length_of_queue; processed++) {
+    int padded = queue[processed];
+    if (types[padded] == SMALL_FILLED) {
+      reached_water_squares++;
+    }
+    for (int i = 0; i < NUMBER_OF_ORTHOGONAL_DIRECTIONS; i++) {
+      int next = padded + offsets[i];
+      if (checked[next] || types[next] == SMALL_UNFILLED) {
+        continue;
+      }
+      checked[next] = true;
+      queue[length_of_queue++] = next;
+    }
   }
-  // The number 9 in the fifteenth row, sixth column.
-  if (!can_match_group_size(board,
-                            SMALL_UNFILLED,
-                            row_and_column_to_square(14, 5),
-                            9,
-                            checked)) {
-    return false;
+  return (reached_water_squares == number_of_water_squares);
+}
+
+bool validator(const Board* const board) {
+  bool checked[NUMBER_OF_SQUARES * BRAILLE_ROWS * BRAILLE_COLUMNS];
+  memset(checked, 0, sizeof(checked));
+
+  for (int i = 0; i < NUMBER_OF_CLUES; i++) {
+    if (!can_match_group_size(board,
+                              SMALL_UNFILLED,
+                              GRID.square_at(CLUES[i].row, CLUES[i].column),
+                              CLUES[i].size,
+                              checked)) {
+      return false;
+    }
   }
 
   // Check that there aren't any uncounted islands.
@@ -267,18 +474,17 @@ bool validator(const Board* const board) {
   }
 
   // The no-lakes rule.
-  for (int i = 1; i < NUMBER_OF_ROWS * BRAILLE_ROWS; i++) {
-    for (int j = 1; j < NUMBER_OF_COLUMNS * BRAILLE_COLUMNS; j++) {
-      if (get_small_square_type(
-              board, row_and_column_to_square(i, j)) == SMALL_FILLED &&
-          get_small_square_type(
-              board, row_and_column_to_square(i - 1, j)) == SMALL_FILLED &&
-          get_small_square_type(
-              board, row_and_column_to_square(i, j - 1)) == SMALL_FILLED &&
-          get_small_square_type(
-              board, row_and_column_to_square(i - 1, j - 1)) == SMALL_FILLED) {
-        return false;
-      }
+  for (int i = 0; i < GRID.get_number_of_windows(); i++) {
+    const int* window = GRID.get_window(i);
+    if (get_small_square_type(board, window[WINDOW_TOP_LEFT]) ==
+            SMALL_FILLED &&
+        get_small_square_type(board, window[WINDOW_TOP_RIGHT]) ==
+            SMALL_FILLED &&
+        get_small_square_type(board, window[WINDOW_BOTTOM_LEFT]) ==
+            SMALL_FILLED &&
+        get_small_square_type(board, window[WINDOW_BOTTOM_RIGHT]) ==
+            SMALL_FILLED) {
+      return false;
     }
   }
 
@@ -288,26 +494,139 @@ bool validator(const Board* const board) {
         !can_match_group_size(board,
                               SMALL_FILLED,
                               i,
-                              NUMBER_OF_SQUARES * BRAILLE_ROWS *
-                                BRAILLE_COLUMNS -
-                                (3 + 9 + 6 + 2 + 5 + 4 + 8 + 1 +
-                                 2 + 4 + 3 + 4 + 9 + 9),
+                              NUMBER_OF_SMALL_SQUARES -
+                                total_island_size(),
                               checked)) {
       return false;
     }
   }
+
+  if (!islands_can_be_completed(board)) {
+    return false;
+  }
+  if (!water_can_connect(board)) {
+    return false;
+  }
   return true;
 }
 
+// Where to record the search, or NULL.
+const char* trace_path = NULL;
+
+// Whether to tune the search order instead of solving.
+bool tune = false;
+
+// Whether to solve with a portfolio of searches.
+bool portfolio = false;
+
+// Tunes the search order of |board| and saves it to the profile.
+void tune_search_order(const Board* board) {
+  SearchOrderTuner tuner(board,
+                         TUNING_NODE_LIMIT,
+                         std::max(1u, std::thread::hardware_concurrency()));
+  int order[NUMBER_OF_SQUARES];
+  unsigned long long score = tuner.tune(TUNING_ROUNDS, 1, order);
+  printf("Tuned search order: %llu nodes, down from %llu, in %d probes\n",
+         score,
+         tuner.get_initial_score(),
+         tuner.get_number_of_probes());
+  if (!SearchOrderTuner::save_profile(PROFILE_PATH,
+                                      NUMBER_OF_SQUARES,
+                                      order,
+                                      score)) {
+    printf("Could not write %s\n", PROFILE_PATH);
+  }
+}
+
+// Solves |board| with a portfolio of searches and records the winner.
+Board* solve_with_portfolio(const Board* board) {
+  PortfolioSolver solver(board,
+                         std::max(1u, std::thread::hardware_concurrency()),
+                         1);
+  solver.load_profile(PORTFOLIO_PROFILE_PATH);
+  Board* solution = solver.find_solution();
+  printf("Won by configuration: %s\n",
+         solver.get_configuration_name(solver.get_winner()).c_str());
+  solver.record_winner();
+  if (!solver.save_profile(PORTFOLIO_PROFILE_PATH)) {
+    printf("Could not write %s\n", PORTFOLIO_PROFILE_PATH);
+  }
+  return solution;
+}
+
 void solve() {
   create_all_states();
   int search_order[NUMBER_OF_SQUARES] = {
     0, 1, 5, 10, 6, 17, 12, 11, 7, 2, 3, 4, 8, 9, 13, 14, 18, 19,
     24, 23, 22, 16, 15, 20, 21,
   };
+  if (!tune) {
+    SearchOrderTuner::load_profile(PROFILE_PATH, NUMBER_OF_SQUARES,
+                                   search_order);
+  }
 
   Board board(NUMBER_OF_SQUARES, &STATE_LIST, search_order, &validator);
-  Board* solution = board.find_solution();
+
+  // Letters that would form a lake with a neighbour are removed without
+  // calling the validator.
+  BoundaryConstraints horizontal_lakes(NUMBER_OF_ROWS,
+                                       NUMBER_OF_COLUMNS,
+                                       &BRAILLE_GLYPHS,
+                                       BOUNDARY_HORIZONTAL,
+                                       &has_no_lakes);
+  BoundaryConstraints vertical_lakes(NUMBER_OF_ROWS,
+                                     NUMBER_OF_COLUMNS,
+                                     &BRAILLE_GLYPHS,
+                                     BOUNDARY_VERTICAL,
+                                     &has_no_lakes);
+  horizontal_lakes.add_to(&board);
+  vertical_lakes.add_to(&board);
+
+  // Rule out the letters that put land out of reach of every clue, or water
+  // on a clue.
+  compute_clues_in_reach();
+  for (int i = 0; i < NUMBER_OF_SQUARES; i++) {
+    board.restrict_domain(i, letters_allowed_by_reach(i));
+  }
+
+  // Rule out the letters that fail as soon as they are tried.
+  if (!board.apply_lookahead(LOOKAHEAD_PASSES, -1, NUMBER_OF_THREADS)) {
+    printf("No solution found\n");
+    delete_all_states();
+    return;
+  }
+
+  if (tune) {
+    tune_search_order(&board);
+    delete_all_states();
+    return;
+  }
+
+  SearchTrace* trace = NULL;
+  if (trace_path != NULL) {
+    trace = new SearchTrace(trace_path);
+    if (!trace->is_open()) {
+      printf("Could not write %s\n", trace_path);
+    }
+    board.set_search_trace(trace);
+  }
+
+  Board* solution = NULL;
+  if (portfolio) {
+    solution = solve_with_portfolio(&board);
+  } else {
+    // Search on another thread, and report on stderr while waiting for it.
+    SolveHandle handle(&board);
+    while (!handle.wait_for(1.0)) {
+      SearchProgress progress = handle.get_progress();
+      fprintf(stderr,
+              "Searched %llu nodes, about %.1f%% done\n",
+              progress.number_of_nodes,
+              100 * progress.fraction_done);
+    }
+    solution = handle.take_solution();
+  }
+  delete trace;
 
   if (solution == NULL) {
     // Found no solution.
@@ -320,7 +639,24 @@ void solve() {
   delete_all_states();
 }
 
-int main() {
+// Usage: nurikabe [--tune | --portfolio] [trace_path]
+// Also records the search to |trace_path|, if given, for tools/trace_replay.
+// With --tune, tunes the search order and saves it to nurikabe.profile
+// instead; later runs from the same directory search in that order. With
+// --portfolio, races several searches and records the winner to
+// nurikabe.portfolio.
+int main(int argc, char** argv) {
+  int argument = 1;
+  if (argument < argc && strcmp(argv[argument], "--tune") == 0) {
+    tune = true;
+    argument++;
+  } else if (argument < argc && strcmp(argv[argument], "--portfolio") == 0) {
+    portfolio = true;
+    argument++;
+  }
+  if (argument < argc) {
+    trace_path = argv[argument];
+  }
   StopWatch::time_function(&solve);
   return 0;
 }
@@ -33,9 +33,23 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "include/brute_force_solver/binary_constraints.h"
 #include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/frontier_solver.h"
+#include "include/brute_force_solver/line_constraint.h"
+#include "include/brute_force_solver/local_search_solver.h"
+#include "include/brute_force_solver/meet_in_the_middle_solver.h"
+#include "include/brute_force_solver/progress_listener.h"
+#include "include/brute_force_solver/search_order_tuner.h"
+#include "include/brute_force_solver/sharded_solver.h"
 #include "include/brute_force_solver/state.h"
 #include "include/brute_force_solver/state_list.h"
 
@@ -44,7 +58,18 @@
 #include "tests/mystery_hunt/braille_board.h"
 #include "tests/mystery_hunt/braille_board_utils.h"
 
+using lib_kxing::brute_force_solver::BinaryCell;
 using lib_kxing::brute_force_solver::Board;
+using lib_kxing::brute_force_solver::Constraint;
+using lib_kxing::brute_force_solver::FrontierSolver;
+using lib_kxing::brute_force_solver::LineConstraint;
+using lib_kxing::brute_force_solver::LineThermometer;
+using lib_kxing::brute_force_solver::LocalSearchSolver;
+using lib_kxing::brute_force_solver::MeetInTheMiddleSolver;
+using lib_kxing::brute_force_solver::SearchOrderTuner;
+using lib_kxing::brute_force_solver::ShardedSolver;
+using lib_kxing::brute_force_solver::StderrProgressListener;
+using lib_kxing::brute_force_solver::ThermometerConstraint;
 using lib_kxing::stopwatch::StopWatch;
 
 // Checks to see if the number of filled squares in [start, end] (with step
@@ -87,230 +112,277 @@ bool valid_thermometer(const Board* const board, int start, int end, int step) {
   return true;
 }
 
-bool validator(const Board* const board) {
-  // Row 1.
-  if (!valid_line(board, 0, 9, 1, 6)) {
-    return false;
-  } else if (!valid_thermometer(board, 2, 6, 1)) {
-    return false;
-  } else if (!valid_thermometer(board, 7, 9, 1)) {
-    return false;
-  }
-
-  // Row 3.
-  if (!valid_line(board, 20, 29, 1, 6)) {
-    return false;
-  }
-
-  // Row 4.
-  if (!valid_line(board, 30, 39, 1, 8)) {
-    return false;
-  } else if (!valid_thermometer(board, 31, 33, 1)) {
-    return false;
-  }
-
-  // Row 5.
-  if (!valid_line(board, 40, 49, 1, 5)) {
-    return false;
-  } else if (!valid_thermometer(board, 45, 42, -1)) {
-    return false;
-  }
-
-  // Row 6.
-  if (!valid_thermometer(board, 52, 53, 1)) {
-    return false;
-  } else if (!valid_thermometer(board, 56, 54, -1)) {
-    return false;
-  }
-
-  // Row 7.
-  if (!valid_line(board, 60, 69, 1, 5)) {
-    return false;
-  } else if (!valid_thermometer(board, 60, 62, 1)) {
-    return false;
-  } else if (!valid_thermometer(board, 63, 66, 1)) {
-    return false;
-  } else if (!valid_thermometer(board, 67, 69, 1)) {
-    return false;
-  }
-
-  // Row 8.
-  if (!valid_line(board, 70, 79, 1, 6)) {
-    return false;
-  } else if (!valid_thermometer(board, 70, 73, 1)) {
-    return false;
-  } else if (!valid_thermometer(board, 74, 76, 1)) {
-    return false;
-  }
-
-  // Row 9.
-  if (!valid_line(board, 80, 89, 1, 4)) {
-    return false;
-  } else if (!valid_thermometer(board, 80, 85, 1)) {
-    return false;
-  }
-
-  // Row 10.
-  if (!valid_line(board, 90, 99, 1, 6)) {
-    return false;
-  } else if (!valid_thermometer(board, 95, 93, -1)) {
-    return false;
-  }
+struct Line {
+  int start;
+  int end;
+  int step;
+  int target;
+};
+
+struct Thermometer {
+  int start;
+  int end;
+  int step;
+};
+
+const int NUMBER_OF_LINES = 20;
+const Line LINES[NUMBER_OF_LINES] = {
+  {0, 9, 1, 6},        // Row 1.
+  {20, 29, 1, 6},      // Row 3.
+  {30, 39, 1, 8},      // Row 4.
+  {40, 49, 1, 5},      // Row 5.
+  {60, 69, 1, 5},      // Row 7.
+  {70, 79, 1, 6},      // Row 8.
+  {80, 89, 1, 4},      // Row 9.
+  {90, 99, 1, 6},      // Row 10.
+  {100, 109, 1, 6},    // Row 11.
+  {110, 119, 1, 4},    // Row 12.
+  {130, 139, 1, 6},    // Row 14.
+  {140, 149, 1, 2},    // Row 15.
+  {1, 141, 10, 5},     // Column 2.
+  {2, 142, 10, 9},     // Column 3.
+  {3, 143, 10, 9},     // Column 4.
+  {5, 145, 10, 6},     // Column 6.
+  {6, 146, 10, 9},     // Column 7.
+  {7, 147, 10, 6},     // Column 8.
+  {8, 148, 10, 10},    // Column 9.
+  {9, 149, 10, 8},     // Column 10.
+};
+
+const int NUMBER_OF_THERMOMETERS = 46;
+const Thermometer THERMOMETERS[NUMBER_OF_THERMOMETERS] = {
+  {2, 6, 1},         // Row 1.
+  {7, 9, 1},         // Row 1.
+  {31, 33, 1},       // Row 4.
+  {45, 42, -1},      // Row 5.
+  {52, 53, 1},       // Row 6.
+  {56, 54, -1},      // Row 6.
+  {60, 62, 1},       // Row 7.
+  {63, 66, 1},       // Row 7.
+  {67, 69, 1},       // Row 7.
+  {70, 73, 1},       // Row 8.
+  {74, 76, 1},       // Row 8.
+  {80, 85, 1},       // Row 9.
+  {95, 93, -1},      // Row 10.
+  {108, 107, -1},    // Row 11.
+  {119, 116, -1},    // Row 12.
+  {129, 127, -1},    // Row 13.
+  {133, 130, -1},    // Row 14.
+  {137, 138, 1},     // Row 14.
+  {140, 144, 1},     // Row 15.
+  {148, 146, -1},    // Row 15.
+  {50, 0, -10},      // Column 1.
+  {120, 90, -10},    // Column 1.
+  {21, 1, -10},      // Column 2.
+  {51, 41, -10},     // Column 2.
+  {121, 91, -10},    // Column 2.
+  {22, 12, -10},     // Column 3.
+  {122, 92, -10},    // Column 3.
+  {13, 23, 10},      // Column 4.
+  {103, 123, 10},    // Column 4.
+  {34, 14, -10},     // Column 5.
+  {104, 134, 10},    // Column 5.
+  {15, 35, 10},      // Column 6.
+  {125, 105, -10},   // Column 6.
+  {135, 145, 10},    // Column 6.
+  {16, 46, 10},      // Column 7.
+  {106, 86, -10},    // Column 7.
+  {136, 126, -10},   // Column 7.
+  {17, 37, 10},      // Column 8.
+  {57, 47, -10},     // Column 8.
+  {77, 97, 10},      // Column 8.
+  {58, 18, -10},     // Column 9.
+  {98, 78, -10},     // Column 9.
+  {19, 39, 10},      // Column 10.
+  {59, 49, -10},     // Column 10.
+  {109, 79, -10},    // Column 10.
+  {139, 149, 10},    // Column 10.
+};
 
-  // Row 11.
-  if (!valid_line(board, 100, 109, 1, 6)) {
-    return false;
-  } else if (!valid_thermometer(board, 108, 107, -1)) {
-    return false;
+bool validator(const Board* const board) {
+  for (int i = 0; i < NUMBER_OF_THERMOMETERS; i++) {
+    if (!valid_thermometer(board,
+                           THERMOMETERS[i].start,
+                           THERMOMETERS[i].end,
+                           THERMOMETERS[i].step)) {
+      return false;
+    }
   }
 
-  // Row 12.
-  if (!valid_line(board, 110, 119, 1, 4)) {
-    return false;
-  } else if (!valid_thermometer(board, 119, 116, -1)) {
-    return false;
+  for (int i = 0; i < NUMBER_OF_LINES; i++) {
+    if (!valid_line(board,
+                    LINES[i].start,
+                    LINES[i].end,
+                    LINES[i].step,
+                    LINES[i].target)) {
+      return false;
+    }
   }
 
-  // Row 13.
-  if (!valid_thermometer(board, 129, 127, -1)) {
-    return false;
-  }
+  return true;
+}
 
-  // Row 14.
-  if (!valid_line(board, 130, 139, 1, 6)) {
-    return false;
-  } else if (!valid_thermometer(board, 133, 130, -1)) {
-    return false;
-  } else if (!valid_thermometer(board, 137, 138, 1)) {
-    return false;
+// Returns the small squares from |start| to |end| inclusive, with step size
+// |step|, as cells of the big squares they belong to. Returns the number of
+// cells.
+int make_cells(int start, int end, int step, BinaryCell* cells) {
+  int number_of_cells = 0;
+  for (int i = start; ; i += step) {
+    cells[number_of_cells] = small_square_cell(i);
+    number_of_cells++;
+    if (i == end) {
+      break;
+    }
   }
+  return number_of_cells;
+}
 
-  // Row 15.
-  if (!valid_line(board, 140, 149, 1, 2)) {
-    return false;
-  } else if (!valid_thermometer(board, 140, 144, 1)) {
-    return false;
-  } else if (!valid_thermometer(board, 148, 146, -1)) {
-    return false;
-  }
+// Returns true if |square| is one of the squares of |line|.
+bool is_on_line(const Line& line, int square) {
+  int low = std::min(line.start, line.end);
+  int high = std::max(line.start, line.end);
+  return square >= low && square <= high &&
+         (square - line.start) % line.step == 0;
+}
 
-  // Column 1.
-  if (!valid_thermometer(board, 50, 0, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 120, 90, -10)) {
-    return false;
+// Finds the thermometers that lie along |line|, as positions on the line.
+// Returns the number of thermometers.
+int thermometers_on_line(const Line& line, LineThermometer* thermometers) {
+  int number_of_thermometers = 0;
+  for (int i = 0; i < NUMBER_OF_THERMOMETERS; i++) {
+    if (abs(THERMOMETERS[i].step) == abs(line.step) &&
+        is_on_line(line, THERMOMETERS[i].start) &&
+        is_on_line(line, THERMOMETERS[i].end)) {
+      thermometers[number_of_thermometers].bulb =
+          (THERMOMETERS[i].start - line.start) / line.step;
+      thermometers[number_of_thermometers].tip =
+          (THERMOMETERS[i].end - line.start) / line.step;
+      number_of_thermometers++;
+    }
   }
+  return number_of_thermometers;
+}
 
-  // Column 2.
-  if (!valid_line(board, 1, 141, 10, 5)) {
-    return false;
-  } else if (!valid_thermometer(board, 21, 1, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 51, 41, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 121, 91, -10)) {
-    return false;
+// Adds the thermometers and the line counts to the board as constraints, so
+// that the search only tries letters whose dots can still satisfy them. Each
+// line count is solved together with the thermometers along its line. The
+// caller is responsible for freeing the constraints.
+void add_constraints(Board* board, std::vector<Constraint*>* constraints) {
+  BinaryCell cells[NUMBER_OF_SQUARES * BRAILLE_DOTS];
+  for (int i = 0; i < NUMBER_OF_THERMOMETERS; i++) {
+    int number_of_cells = make_cells(THERMOMETERS[i].start,
+                                     THERMOMETERS[i].end,
+                                     THERMOMETERS[i].step,
+                                     cells);
+    constraints->push_back(new ThermometerConstraint(cells, number_of_cells));
   }
-
-  // Column 3.
-  if (!valid_line(board, 2, 142, 10, 9)) {
-    return false;
-  } else if (!valid_thermometer(board, 22, 12, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 122, 92, -10)) {
-    return false;
+  for (int i = 0; i < NUMBER_OF_LINES; i++) {
+    int number_of_cells =
+        make_cells(LINES[i].start, LINES[i].end, LINES[i].step, cells);
+    LineThermometer thermometers[NUMBER_OF_THERMOMETERS];
+    int number_of_thermometers = thermometers_on_line(LINES[i], thermometers);
+    constraints->push_back(new LineConstraint(cells,
+                                              number_of_cells,
+                                              LINES[i].target,
+                                              thermometers,
+                                              number_of_thermometers));
   }
 
-  // Column 4.
-  if (!valid_line(board, 3, 143, 10, 9)) {
-    return false;
-  } else if (!valid_thermometer(board, 13, 23, 10)) {
-    return false;
-  } else if (!valid_thermometer(board, 103, 123, 10)) {
-    return false;
+  for (size_t i = 0; i < constraints->size(); i++) {
+    board->add_constraint((*constraints)[i]);
   }
+}
 
-  // Column 5.
-  if (!valid_thermometer(board, 34, 14, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 104, 134, 10)) {
-    return false;
-  }
+// The search order tuned by hand, row by row from the middle; sweeps also
+// take the squares in this order, whatever the search order.
+const int HAND_ORDER[NUMBER_OF_SQUARES] = {
+  10, 11, 12, 13, 14,
+  15, 16, 17, 18, 19,
+  1, 6, 21,
+  0, 5, 20,
+  4, 9, 24,
+  2, 3,
+  7, 8,
+  22, 23,
+};
+
+// Runs with --tune tune the search order for this many rounds, with probes of
+// at most this many nodes, and save it to the profile, which later runs load.
+const int TUNING_ROUNDS = 20;
+const unsigned long long TUNING_NODE_LIMIT = 1 << 20;
+const char* const PROFILE_PATH = "thermometers.profile";
+
+// Whether to tune the search order instead of solving.
+bool tune = false;
+
+// Whether to make a worker process crash, to check that its shard is searched
+// again.
+bool crash_worker = false;
+
+// Returns the directory for temporary files: TMPDIR, if it is set.
+const char* get_temporary_directory() {
+  const char* directory = getenv("TMPDIR");
+  return (directory != NULL && directory[0] != '\0') ? directory : P_tmpdir;
+}
 
-  // Column 6.
-  if (!valid_line(board, 5, 145, 10, 6)) {
-    return false;
-  } else if (!valid_thermometer(board, 15, 35, 10)) {
-    return false;
-  } else if (!valid_thermometer(board, 125, 105, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 135, 145, 10)) {
-    return false;
+// Tunes the search order of |board| and saves it to the profile.
+void tune_search_order(const Board* board) {
+  SearchOrderTuner tuner(board,
+                         TUNING_NODE_LIMIT,
+                         std::max(1u, std::thread::hardware_concurrency()));
+  int order[NUMBER_OF_SQUARES];
+  unsigned long long score = tuner.tune(TUNING_ROUNDS, 1, order);
+  printf("Tuned search order: %llu nodes, down from %llu, in %d probes\n",
+         score,
+         tuner.get_initial_score(),
+         tuner.get_number_of_probes());
+  if (!SearchOrderTuner::save_profile(PROFILE_PATH,
+                                      NUMBER_OF_SQUARES,
+                                      order,
+                                      score)) {
+    printf("Could not write %s\n", PROFILE_PATH);
   }
+}
 
-  // Column 7.
-  if (!valid_line(board, 6, 146, 10, 9)) {
-    return false;
-  } else if (!valid_thermometer(board, 16, 46, 10)) {
-    return false;
-  } else if (!valid_thermometer(board, 106, 86, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 136, 126, -10)) {
-    return false;
+void solve() {
+  create_all_states();
+  int search_order[NUMBER_OF_SQUARES];
+  std::copy(HAND_ORDER, HAND_ORDER + NUMBER_OF_SQUARES, search_order);
+  if (!tune) {
+    SearchOrderTuner::load_profile(PROFILE_PATH, NUMBER_OF_SQUARES,
+                                   search_order);
   }
 
-  // Column 8.
-  if (!valid_line(board, 7, 147, 10, 6)) {
-    return false;
-  } else if (!valid_thermometer(board, 17, 37, 10)) {
-    return false;
-  } else if (!valid_thermometer(board, 57, 47, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 77, 97, 10)) {
-    return false;
-  }
+  Board board(NUMBER_OF_SQUARES, &STATE_LIST, search_order, &validator);
 
-  // Column 9.
-  if (!valid_line(board, 8, 148, 10, 10)) {
-    return false;
-  } else if (!valid_thermometer(board, 58, 18, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 98, 78, -10)) {
-    return false;
-  }
+  // The validator only checks the lines and thermometers, which are also
+  // constraints, so groups of squares that share none can be solved apart.
+  board.enable_components();
+  std::vector<Constraint*> constraints;
+  add_constraints(&board, &constraints);
 
-  // Column 10.
-  if (!valid_line(board, 9, 149, 10, 8)) {
-    return false;
-  } else if (!valid_thermometer(board, 19, 39, 10)) {
-    return false;
-  } else if (!valid_thermometer(board, 59, 49, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 109, 79, -10)) {
-    return false;
-  } else if (!valid_thermometer(board, 139, 149, 10)) {
-    return false;
+  if (tune) {
+    tune_search_order(&board);
+    for (size_t i = 0; i < constraints.size(); i++) {
+      delete constraints[i];
+    }
+    delete_all_states();
+    return;
   }
 
-  return true;
-}
-
-void solve() {
-  create_all_states();
-  int search_order[NUMBER_OF_SQUARES] = {
-    10, 11, 12, 13, 14,
-    15, 16, 17, 18, 19,
-    1, 6, 21,
-    0, 5, 20,
-    4, 9, 24,
-    2, 3,
-    7, 8,
-    22, 23,
-  };
-
-  Board board(NUMBER_OF_SQUARES, &STATE_LIST, search_order, &validator);
-  get_small_square_type(&board, 0);
+  // Long searches report their progress on stderr every second; this one ends
+  // well before the first report.
+  printf("Estimated search tree size: %.0f\n",
+         board.estimate_search_tree_size(20, 1));
+  StderrProgressListener progress_listener;
+  board.set_progress_listener(&progress_listener, 1.0);
+
+  // Only the search is timed; the other solvers below check its answer.
+  StopWatch watch;
+  watch.enable_counters();
+  watch.start();
   Board* solution = board.find_solution();
+  watch.stop();
 
   if (solution == NULL) {
     // Found no solution.
@@ -320,10 +392,62 @@ void solve() {
     solution->pretty_print(5);
     delete solution;
   }
+  watch.print_elapsed_time();
+
+  // Every rule is a constraint, so a sweep can count the solutions too.
+  FrontierSolver frontier_solver(&board, HAND_ORDER);
+  printf("Number of solutions by sweeping: %llu\n",
+         frontier_solver.count_solutions());
+
+  // So can meeting in the middle, between the top two rows and the rest.
+  int top_rows[2 * NUMBER_OF_COLUMNS];
+  for (int i = 0; i < 2 * NUMBER_OF_COLUMNS; i++) {
+    top_rows[i] = i;
+  }
+  MeetInTheMiddleSolver meet_in_the_middle_solver(&board,
+                                                  top_rows,
+                                                  2 * NUMBER_OF_COLUMNS,
+                                                  1 << 24,
+                                                  get_temporary_directory());
+  printf("Number of solutions by meeting in the middle: %llu\n",
+         meet_in_the_middle_solver.count_solutions());
+
+  // So can worker processes, each searching below a way to fill in the first
+  // five squares. With --crash-worker, one worker is made to crash, and its
+  // shard is searched again by a replacement.
+  ShardedSolver sharded_solver(&board, 2, 5);
+  if (crash_worker) {
+    sharded_solver.set_crash_injection(0);
+  }
+  unsigned long long sharded_count = sharded_solver.count_solutions();
+  printf("Number of solutions by worker processes: %llu, workers lost: %d\n",
+         sharded_count,
+         sharded_solver.get_number_of_lost_workers());
+
+  // Local search finds the solution too, without searching exhaustively.
+  LocalSearchSolver local_search_solver(&board, 1);
+  Board* best = local_search_solver.find_best_assignment(4, 10.0);
+  printf("Violations left by local search: %d\n",
+         local_search_solver.get_best_violations());
+  delete best;
+
+  for (size_t i = 0; i < constraints.size(); i++) {
+    delete constraints[i];
+  }
   delete_all_states();
 }
 
-int main() {
-  StopWatch::time_function(&solve);
+// Usage: thermometers [--tune | --crash-worker]
+// With --tune, tunes the search order and saves it to thermometers.profile
+// instead of solving; later runs from the same directory search in that
+// order. With --crash-worker, one of the worker processes crashes, and the
+// count shows that its shard was searched again.
+int main(int argc, char** argv) {
+  if (argc > 1 && strcmp(argv[1], "--tune") == 0) {
+    tune = true;
+  } else if (argc > 1 && strcmp(argv[1], "--crash-worker") == 0) {
+    crash_worker = true;
+  }
+  solve();
   return 0;
 }
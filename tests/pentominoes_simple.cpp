@@ -0,0 +1,224 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// The following code tiles a 3 x 20 rectangle with the twelve pentominoes, as
+// an exact cover problem: each piece is placed once, and each square is
+// covered once.
+//
+// We encode the squares row by row, and each square takes the letter of the
+// piece covering it. There are two tilings, up to rotations and reflections of
+// the rectangle, so eight in all.
+// -----------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/exact_cover_solver.h"
+#include "include/brute_force_solver/solution_writer.h"
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+
+#include "include/stopwatch/stopwatch.h"
+
+using lib_kxing::brute_force_solver::Board;
+using lib_kxing::brute_force_solver::ExactCoverAssignment;
+using lib_kxing::brute_force_solver::ExactCoverSolver;
+using lib_kxing::brute_force_solver::SolutionWriter;
+using lib_kxing::brute_force_solver::State;
+using lib_kxing::brute_force_solver::StateList;
+
+using lib_kxing::stopwatch::StopWatch;
+
+using lib_kxing::brute_force_solver::SOLUTION_FORMAT_DELTA;
+
+const int NUMBER_OF_ROWS = 3;
+const int NUMBER_OF_COLUMNS = 20;
+const int NUMBER_OF_SQUARES = NUMBER_OF_ROWS * NUMBER_OF_COLUMNS;
+const int NUMBER_OF_PIECES = 12;
+const int PIECE_SIZE = 5;
+
+const int NUMBER_OF_THREADS = 4;
+
+const State F_STATE("F");
+const State I_STATE("I");
+const State L_STATE("L");
+const State N_STATE("N");
+const State P_STATE("P");
+const State T_STATE("T");
+const State U_STATE("U");
+const State V_STATE("V");
+const State W_STATE("W");
+const State X_STATE("X");
+const State Y_STATE("Y");
+const State Z_STATE("Z");
+
+const State* STATES[NUMBER_OF_PIECES] = {
+  &F_STATE, &I_STATE, &L_STATE, &N_STATE, &P_STATE, &T_STATE,
+  &U_STATE, &V_STATE, &W_STATE, &X_STATE, &Y_STATE, &Z_STATE,
+};
+
+const StateList STATE_LIST(STATES, NUMBER_OF_PIECES);
+
+// The (row, column) of each square of each piece, in one orientation.
+const int PIECES[NUMBER_OF_PIECES][PIECE_SIZE][2] = {
+  {{0, 1}, {0, 2}, {1, 0}, {1, 1}, {2, 1}},  // F
+  {{0, 0}, {0, 1}, {0, 2}, {0, 3}, {0, 4}},  // I
+  {{0, 0}, {1, 0}, {2, 0}, {3, 0}, {3, 1}},  // L
+  {{0, 1}, {1, 1}, {2, 0}, {2, 1}, {3, 0}},  // N
+  {{0, 0}, {0, 1}, {1, 0}, {1, 1}, {2, 0}},  // P
+  {{0, 0}, {0, 1}, {0, 2}, {1, 1}, {2, 1}},  // T
+  {{0, 0}, {0, 2}, {1, 0}, {1, 1}, {1, 2}},  // U
+  {{0, 0}, {1, 0}, {2, 0}, {2, 1}, {2, 2}},  // V
+  {{0, 0}, {1, 0}, {1, 1}, {2, 1}, {2, 2}},  // W
+  {{0, 1}, {1, 0}, {1, 1}, {1, 2}, {2, 1}},  // X
+  {{0, 1}, {1, 0}, {1, 1}, {2, 1}, {3, 1}},  // Y
+  {{0, 0}, {0, 1}, {1, 1}, {2, 1}, {2, 2}},  // Z
+};
+
+typedef std::vector<std::pair<int, int> > Shape;
+
+// Returns the distinct rotations and reflections of the piece, each shifted to
+// touch the top and left edges.
+std::vector<Shape> get_orientations(int piece) {
+  std::vector<Shape> orientations;
+  for (int transform = 0; transform < 8; transform++) {
+    Shape shape;
+    for (int i = 0; i < PIECE_SIZE; i++) {
+      int row = PIECES[piece][i][0];
+      int column = PIECES[piece][i][1];
+      if (transform & 1) {
+        std::swap(row, column);
+      }
+      if (transform & 2) {
+        row = -row;
+      }
+      if (transform & 4) {
+        column = -column;
+      }
+      shape.push_back(std::make_pair(row, column));
+    }
+
+    int min_row = shape[0].first;
+    int min_column = shape[0].second;
+    for (int i = 1; i < PIECE_SIZE; i++) {
+      min_row = std::min(min_row, shape[i].first);
+      min_column = std::min(min_column, shape[i].second);
+    }
+    for (int i = 0; i < PIECE_SIZE; i++) {
+      shape[i].first -= min_row;
+      shape[i].second -= min_column;
+    }
+    std::sort(shape.begin(), shape.end());
+
+    if (std::find(orientations.begin(), orientations.end(), shape) ==
+        orientations.end()) {
+      orientations.push_back(shape);
+    }
+  }
+  return orientations;
+}
+
+// Where to write every tiling, or NULL.
+const char* solutions_path = NULL;
+
+// Writes every tiling found by |solver| to |path|. Returns false if the file
+// cannot be written.
+bool write_tilings(ExactCoverSolver* solver, const char* path) {
+  FILE* file = fopen(path, "wb");
+  if (file == NULL) {
+    return false;
+  }
+  bool written = false;
+  {
+    SolutionWriter writer(file, SOLUTION_FORMAT_DELTA, 0);
+    solver->find_all_solutions(&writer, NUMBER_OF_THREADS);
+    written = writer.flush();
+  }
+  return (fclose(file) == 0) && written;
+}
+
+void solve() {
+  int search_order[NUMBER_OF_SQUARES];
+  for (int i = 0; i < NUMBER_OF_SQUARES; i++) {
+    search_order[i] = i;
+  }
+  Board board(NUMBER_OF_SQUARES, &STATE_LIST, search_order, NULL);
+
+  // Columns [0, NUMBER_OF_PIECES) are the pieces, and the rest the squares.
+  ExactCoverSolver solver(&board, NUMBER_OF_PIECES + NUMBER_OF_SQUARES, 0);
+  for (int piece = 0; piece < NUMBER_OF_PIECES; piece++) {
+    std::vector<Shape> orientations = get_orientations(piece);
+    for (size_t i = 0; i < orientations.size(); i++) {
+      const Shape& shape = orientations[i];
+      for (int row = 0; row < NUMBER_OF_ROWS; row++) {
+        for (int column = 0; column < NUMBER_OF_COLUMNS; column++) {
+          int columns[PIECE_SIZE + 1];
+          ExactCoverAssignment assignments[PIECE_SIZE];
+          columns[0] = piece;
+          bool fits = true;
+          for (int j = 0; j < PIECE_SIZE && fits; j++) {
+            int square_row = row + shape[j].first;
+            int square_column = column + shape[j].second;
+            fits = (square_row < NUMBER_OF_ROWS &&
+                    square_column < NUMBER_OF_COLUMNS);
+            int square = square_row * NUMBER_OF_COLUMNS + square_column;
+            columns[j + 1] = NUMBER_OF_PIECES + square;
+            assignments[j].square = square;
+            assignments[j].state_index = piece;
+          }
+          if (fits) {
+            solver.add_row(columns, PIECE_SIZE + 1, assignments, PIECE_SIZE);
+          }
+        }
+      }
+    }
+  }
+
+  Board* solution = solver.find_solution();
+  if (solution == NULL) {
+    printf("No solution found\n");
+  } else {
+    solution->pretty_print(NUMBER_OF_COLUMNS);
+    delete solution;
+  }
+
+  printf("Number of tilings: %llu\n",
+         solver.count_solutions(NUMBER_OF_THREADS));
+
+  if (solutions_path != NULL && !write_tilings(&solver, solutions_path)) {
+    printf("Could not write %s\n", solutions_path);
+  }
+}
+
+// Usage: pentominoes_simple [solutions_path]
+// Also writes every tiling to |solutions_path|, if given, in the delta format
+// of SolutionWriter.
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    solutions_path = argv[1];
+  }
+  StopWatch::time_function(&solve);
+  return 0;
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// The following code fills in a 4 x 4 grid with the digits 1 to 3, so that
+// every row, every column and both diagonals add up to the given sums, and no
+// two 3s are next to each other. The rules are written with the constraint
+// DSL, as sums and an adjacency rule.
+//
+// We encode the squares as shown below:
+//
+//  0  1  2  3
+//  4  5  6  7
+//  8  9 10 11
+// 12 13 14 15
+// -----------------------------------------------------------------------------
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/constraint_dsl.h"
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+
+#include "include/stopwatch/stopwatch.h"
+
+using lib_kxing::brute_force_solver::Board;
+using lib_kxing::brute_force_solver::Constraint;
+using lib_kxing::brute_force_solver::State;
+using lib_kxing::brute_force_solver::StateList;
+
+using lib_kxing::stopwatch::StopWatch;
+
+namespace dsl = lib_kxing::brute_force_solver::dsl;
+
+const int SIZE = 4;
+const int NUMBER_OF_SQUARES = SIZE * SIZE;
+const int NUMBER_OF_STATES = 3;
+
+const State ONE_STATE("1");
+const State TWO_STATE("2");
+const State THREE_STATE("3");
+
+const State* STATES[NUMBER_OF_STATES] = {
+  &ONE_STATE,
+  &TWO_STATE,
+  &THREE_STATE,
+};
+
+const StateList STATE_LIST(STATES, NUMBER_OF_STATES);
+
+// The value of each state, by its index in STATE_LIST.
+typedef dsl::StateValues<1, 2, 3> Digits;
+
+// The index of THREE_STATE in STATE_LIST.
+constexpr int THREE_INDEX = 2;
+
+typedef dsl::Grid<SIZE, SIZE> PuzzleGrid;
+
+typedef dsl::Rules<dsl::Sum<dsl::Range<0, 3, 1>, 9, Digits>,     // Row 1.
+                   dsl::Sum<dsl::Range<4, 7, 1>, 5, Digits>,     // Row 2.
+                   dsl::Sum<dsl::Range<8, 11, 1>, 5, Digits>,    // Row 3.
+                   dsl::Sum<dsl::Range<12, 15, 1>, 10, Digits>,  // Row 4.
+                   dsl::Sum<dsl::Range<0, 12, 4>, 6, Digits>,    // Column 1.
+                   dsl::Sum<dsl::Range<1, 13, 4>, 7, Digits>,    // Column 2.
+                   dsl::Sum<dsl::Range<2, 14, 4>, 6, Digits>,    // Column 3.
+                   dsl::Sum<dsl::Range<3, 15, 4>, 10, Digits>,   // Column 4.
+                   dsl::Sum<dsl::Range<0, 15, 5>, 6, Digits>,    // Diagonal.
+                   dsl::Sum<dsl::Range<3, 12, 3>, 8, Digits>,    // Diagonal.
+                   dsl::NoTwoAdjacent<PuzzleGrid, THREE_INDEX> > PuzzleRules;
+
+void solve() {
+  int search_order[NUMBER_OF_SQUARES] = {
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+  };
+
+  Board board(NUMBER_OF_SQUARES,
+              &STATE_LIST,
+              search_order,
+              &PuzzleRules::validate);
+
+  // Each rule is also a constraint over its own squares, so a new digit only
+  // rechecks the rules that can see it.
+  std::vector<Constraint*> constraints;
+  PuzzleRules::add_constraints(&board, &constraints);
+  Board* solution = board.find_solution();
+
+  if (solution == NULL) {
+    // Found no solution.
+    printf("No solution found\n");
+  } else {
+    // Found a solution - print it out, four to a line.
+    solution->pretty_print(SIZE);
+
+    // Check the solution against the rules once more, as local search would.
+    int state_indices[NUMBER_OF_SQUARES];
+    for (int i = 0; i < NUMBER_OF_SQUARES; i++) {
+      state_indices[i] = solution->get_state_index(i);
+    }
+    printf("Rules broken by the solution: %d\n",
+           PuzzleRules::count_violations(state_indices));
+    delete solution;
+  }
+  printf("Number of solutions: %llu\n", board.count_solutions());
+
+  for (size_t i = 0; i < constraints.size(); i++) {
+    delete constraints[i];
+  }
+}
+
+int main() {
+  StopWatch::time_function(&solve);
+  return 0;
+}
@@ -31,22 +31,30 @@
 // -----------------------------------------------------------------------------
 
 #include <stdio.h>
-#include <stdlib.h>
+
+#include <vector>
 
 #include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/cnf_encoder.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/constraint_dsl.h"
+#include "include/brute_force_solver/solution_generator.h"
 #include "include/brute_force_solver/state.h"
 #include "include/brute_force_solver/state_list.h"
 
 #include "include/stopwatch/stopwatch.h"
 
 using lib_kxing::brute_force_solver::Board;
+using lib_kxing::brute_force_solver::CnfEncoder;
+using lib_kxing::brute_force_solver::Constraint;
+using lib_kxing::brute_force_solver::SolutionGenerator;
 using lib_kxing::brute_force_solver::State;
 using lib_kxing::brute_force_solver::StateList;
 
-using lib_kxing::brute_force_solver::EMPTY;
-
 using lib_kxing::stopwatch::StopWatch;
 
+namespace dsl = lib_kxing::brute_force_solver::dsl;
+
 const int NUMBER_OF_ROWS = 4;
 const int NUMBER_OF_COLUMNS = 4;
 const int NUMBER_OF_SQUARES = NUMBER_OF_ROWS * NUMBER_OF_COLUMNS;
@@ -65,126 +73,93 @@ const State* STATES[NUMBER_OF_STATES] = {
 
 const StateList STATE_LIST(STATES, NUMBER_OF_STATES);
 
-// Checks to see if the number of filled squares in [start, end] (with step
-// size |step| can ever equal |target|.
-bool valid_line(const Board* const board,
-                int start,
-                int end,
-                int step,
-                int target) {
-  int min_sum = 0;
-  int max_sum = 0;
-  for (int i = start; i <= end; i += step) {
-    if (board->get_value(i) == FILLED) {
-      min_sum++;
-      max_sum++;
-    } else if (board->get_value(i) == EMPTY) {
-      max_sum++;
-    }
-  }
-  if (min_sum > target || max_sum < target) {
-    return false;
-  }
-  return true;
-}
-
-bool valid_thermometer(const Board* const board, int start, int end, int step) {
-  assert(((end - start) % abs(step)) == 0);
-  assert(((end - start) / step) >= 0);
-  int bottom = start;
-  int next = start + step;
-
-  while (bottom != end) {
-    if (board->get_value(bottom) == UNFILLED &&
-        board->get_value(next) == FILLED) {
-      return false;
-    }
-    bottom += step;
-    next += step;
-  }
-  return true;
-}
-
-bool validator(const Board* const board) {
-  // Thermometer along row 1.
-  if (!valid_thermometer(board, 0, 3, 1)) {
-    return false;
-  }
-
-  // Row 1 count.
-  if (!valid_line(board, 0, 3, 1, 3)) {
-    return false;
-  }
-
-  // Thermometer along row 2.
-  if (!valid_thermometer(board, 7, 5, -1)) {
-    return false;
-  }
-
-  // Row 2 count.
-  if (!valid_line(board, 4, 7, 1, 2)) {
-    return false;
-  }
-
-  // Thermometer along row 3.
-  if (!valid_thermometer(board, 10, 9, -1)) {
-    return false;
-  }
-
-  // Row 3 count.
-  if (!valid_line(board, 8, 11, 1, 1)) {
-    return false;
-  }
-
-  // Thermometer along row 4.
-  if (!valid_thermometer(board, 14, 13, -1)) {
-    return false;
-  }
-
-  // Row 4 count.
-  if (!valid_line(board, 12, 15, 1, 3)) {
-    return false;
-  }
-
-  // Thermometer along column 1.
-  if (!valid_thermometer(board, 12, 4, -4)) {
-    return false;
-  }
-
-  // Column 1 count.
-  if (!valid_line(board, 0, 12, 4, 3)) {
-    return false;
-  }
-
-  // Column 2 count.
-  if (!valid_line(board, 1, 13, 4, 2)) {
-    return false;
-  }
+struct Line {
+  int start;
+  int end;
+  int step;
+  int target;
+};
 
-  // Column 3 count.
-  if (!valid_line(board, 2, 14, 4, 3)) {
-    return false;
-  }
+struct Thermometer {
+  int start;
+  int end;
+  int step;
+};
 
-  // Thermometer along column 4.
-  if (!valid_thermometer(board, 11, 15, 4)) {
-    return false;
-  }
+const int NUMBER_OF_LINES = 8;
+constexpr Line LINES[NUMBER_OF_LINES] = {
+  {0, 3, 1, 3},    // Row 1 count.
+  {4, 7, 1, 2},    // Row 2 count.
+  {8, 11, 1, 1},   // Row 3 count.
+  {12, 15, 1, 3},  // Row 4 count.
+  {0, 12, 4, 3},   // Column 1 count.
+  {1, 13, 4, 2},   // Column 2 count.
+  {2, 14, 4, 3},   // Column 3 count.
+  {3, 15, 4, 1},   // Column 4 count.
+};
 
-  // Column 4 count.
-  if (!valid_line(board, 3, 15, 4, 1)) {
-    return false;
-  }
+const int NUMBER_OF_THERMOMETERS = 6;
+constexpr Thermometer THERMOMETERS[NUMBER_OF_THERMOMETERS] = {
+  {0, 3, 1},     // Thermometer along row 1.
+  {7, 5, -1},    // Thermometer along row 2.
+  {10, 9, -1},   // Thermometer along row 3.
+  {14, 13, -1},  // Thermometer along row 4.
+  {12, 4, -4},   // Thermometer along column 1.
+  {11, 15, 4},   // Thermometer along column 4.
+};
 
-  return true;
-}
+// The index of FILLED in STATE_LIST.
+constexpr int FILLED_INDEX = 0;
+
+template <int I>
+using LineRule =
+    dsl::Count<dsl::Range<LINES[I].start, LINES[I].end, LINES[I].step>,
+               FILLED_INDEX,
+               LINES[I].target>;
+
+template <int I>
+using ThermometerRule =
+    dsl::Thermometer<dsl::Range<THERMOMETERS[I].start,
+                                THERMOMETERS[I].end,
+                                THERMOMETERS[I].step>,
+                     FILLED_INDEX>;
+
+// The lines and thermometers as rules, which give both the validator and the
+// constraints of the board.
+typedef dsl::Rules<ThermometerRule<0>,
+                   ThermometerRule<1>,
+                   ThermometerRule<2>,
+                   ThermometerRule<3>,
+                   ThermometerRule<4>,
+                   ThermometerRule<5>,
+                   LineRule<0>,
+                   LineRule<1>,
+                   LineRule<2>,
+                   LineRule<3>,
+                   LineRule<4>,
+                   LineRule<5>,
+                   LineRule<6>,
+                   LineRule<7> > PuzzleRules;
+
+// Where to write the SAT encoding of the puzzle, or NULL.
+const char* dimacs_path = NULL;
 
 void solve() {
   int search_order[NUMBER_OF_SQUARES] = {
       0, 1, 2, 3, 12, 8, 4, 10, 9, 11, 15, 7, 6, 5, 14, 13,
   };
 
-  Board board(NUMBER_OF_SQUARES, &STATE_LIST, search_order, &validator);
+  Board board(NUMBER_OF_SQUARES,
+              &STATE_LIST,
+              search_order,
+              &PuzzleRules::validate);
+
+  // The validator only checks the lines and thermometers, which are also
+  // constraints, so groups of squares that share none can be solved apart.
+  // The constraints fill in the squares that the rules force.
+  board.enable_components();
+  std::vector<Constraint*> constraints;
+  PuzzleRules::add_constraints(&board, &constraints);
   Board* solution = board.find_solution();
 
   if (solution == NULL) {
@@ -195,9 +170,42 @@ void solve() {
     solution->pretty_print(4);
     delete solution;
   }
+
+  // The generator hands out the solutions one at a time, searching only as
+  // far as the next one.
+  SolutionGenerator solutions(&board);
+  int number_of_solutions = 0;
+  while (solutions.next()) {
+    number_of_solutions++;
+  }
+  printf("Number of solutions by generator: %d\n", number_of_solutions);
+
+  // The lines and thermometers are also a SAT problem.
+  CnfEncoder encoder(&board);
+  Board* sat_solution = encoder.find_solution();
+  if (sat_solution == NULL) {
+    printf("No solution found by SAT\n");
+  } else {
+    printf("Solution by SAT:\n");
+    sat_solution->pretty_print(4);
+    delete sat_solution;
+  }
+  if (dimacs_path != NULL &&
+      !encoder.get_formula()->write_dimacs(dimacs_path)) {
+    printf("Could not write %s\n", dimacs_path);
+  }
+
+  for (size_t i = 0; i < constraints.size(); i++) {
+    delete constraints[i];
+  }
 }
 
-int main() {
+// Usage: thermometers_simple [dimacs_path]
+// Also writes the SAT encoding of the puzzle to |dimacs_path|, if given.
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    dimacs_path = argv[1];
+  }
   StopWatch::time_function(&solve);
   return 0;
 }
@@ -0,0 +1,199 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// The following code fills in a 4 x 4 word square: every row and every column
+// spells a word from a dictionary, and the first row is CARD. The dictionary
+// is a word list file with one word per line if one is given, and a small
+// built-in list otherwise.
+//
+// We encode the squares as shown below:
+//
+//  0  1  2  3
+//  4  5  6  7
+//  8  9 10 11
+// 12 13 14 15
+// -----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+
+#include "include/dictionary/trie.h"
+#include "include/dictionary/word_constraint.h"
+
+#include "include/stopwatch/stopwatch.h"
+
+using lib_kxing::brute_force_solver::Board;
+using lib_kxing::brute_force_solver::Constraint;
+using lib_kxing::brute_force_solver::State;
+using lib_kxing::brute_force_solver::StateList;
+
+using lib_kxing::brute_force_solver::single_state_domain;
+
+using lib_kxing::dictionary::NUMBER_OF_LETTERS;
+using lib_kxing::dictionary::Trie;
+using lib_kxing::dictionary::WordConstraint;
+
+using lib_kxing::stopwatch::StopWatch;
+
+const int SIZE = 4;
+const int NUMBER_OF_SQUARES = SIZE * SIZE;
+
+const int NUMBER_OF_WORDS = 24;
+const char* const WORDS[NUMBER_OF_WORDS] = {
+  "ACRE", "AREA", "BEAR", "CARD", "CARE", "CART", "DARE", "DART",
+  "DATE", "DEAR", "EARL", "EAST", "EDGE", "NEAR", "RARE", "RATE",
+  "READ", "REAL", "REAR", "SEAT", "TEAR", "TREE", "TSAR", "EASE",
+};
+
+// The letters A to Z.
+const char* const LETTERS[NUMBER_OF_LETTERS] = {
+  "A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", "M",
+  "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", "Y", "Z",
+};
+
+const State* STATES[NUMBER_OF_LETTERS];
+
+void create_all_states() {
+  for (int i = 0; i < NUMBER_OF_LETTERS; i++) {
+    STATES[i] = new State(LETTERS[i]);
+  }
+}
+
+void delete_all_states() {
+  for (int i = 0; i < NUMBER_OF_LETTERS; i++) {
+    delete STATES[i];
+  }
+}
+
+// The word list file to read the dictionary from, or NULL.
+const char* word_list_path = NULL;
+
+const char* get_temporary_directory() {
+  const char* directory = getenv("TMPDIR");
+  return (directory != NULL && directory[0] != '\0') ? directory : P_tmpdir;
+}
+
+// Returns the dictionary, or NULL if the word list cannot be read. The trie is
+// saved to a temporary file and loaded back, as a solver would keep it
+// between runs, so that it is read from the saved file.
+Trie* load_dictionary() {
+  Trie* built = (word_list_path == NULL) ?
+      Trie::from_words(WORDS, NUMBER_OF_WORDS) :
+      Trie::from_word_list(word_list_path);
+  if (built == NULL) {
+    printf("Could not read %s\n", word_list_path);
+    return NULL;
+  }
+
+  char pid[16];
+  snprintf(pid, sizeof(pid), "%d", static_cast<int>(getpid()));
+  std::string path = std::string(get_temporary_directory()) +
+                     "/word_square_simple." + pid + ".trie";
+  if (!built->save(path.c_str())) {
+    printf("Could not write %s\n", path.c_str());
+    return built;
+  }
+  Trie* loaded = Trie::load(path.c_str());
+  unlink(path.c_str());
+  if (loaded == NULL ||
+      loaded->get_number_of_nodes() != built->get_number_of_nodes()) {
+    printf("The saved trie does not load back\n");
+    delete loaded;
+    return built;
+  }
+  delete built;
+  return loaded;
+}
+
+void solve() {
+  Trie* trie = load_dictionary();
+  if (trie == NULL) {
+    return;
+  }
+  create_all_states();
+  StateList state_list(STATES, NUMBER_OF_LETTERS);
+
+  int search_order[NUMBER_OF_SQUARES];
+  for (int i = 0; i < NUMBER_OF_SQUARES; i++) {
+    search_order[i] = i;
+  }
+  Board board(NUMBER_OF_SQUARES, &state_list, search_order, NULL);
+
+  // Every row and column is a word. The constraints check whole words, so
+  // the board needs no validator.
+  std::vector<Constraint*> constraints;
+  for (int i = 0; i < SIZE; i++) {
+    int row[SIZE];
+    int column[SIZE];
+    for (int j = 0; j < SIZE; j++) {
+      row[j] = i * SIZE + j;
+      column[j] = j * SIZE + i;
+    }
+    constraints.push_back(new WordConstraint(trie, &state_list, row, SIZE));
+    constraints.push_back(
+        new WordConstraint(trie, &state_list, column, SIZE));
+  }
+  for (size_t i = 0; i < constraints.size(); i++) {
+    board.add_constraint(constraints[i]);
+  }
+
+  // The first row is CARD.
+  const char* first_word = "CARD";
+  for (int i = 0; i < SIZE; i++) {
+    board.restrict_domain(i, single_state_domain(first_word[i] - 'A'));
+  }
+
+  Board* solution = board.find_solution();
+  if (solution == NULL) {
+    // Found no solution.
+    printf("No solution found\n");
+  } else {
+    // Found a solution - print it out, four to a line.
+    solution->pretty_print(SIZE);
+    delete solution;
+  }
+  printf("Number of word squares: %llu\n", board.count_solutions());
+
+  for (size_t i = 0; i < constraints.size(); i++) {
+    delete constraints[i];
+  }
+  delete trie;
+  delete_all_states();
+}
+
+// Usage: word_square_simple [word_list_path]
+int main(int argc, char** argv) {
+  if (argc > 1) {
+    word_list_path = argv[1];
+  }
+  StopWatch::time_function(&solve);
+  return 0;
+}
@@ -0,0 +1,364 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Generates Thermometers puzzles with a unique solution.
+//
+//   puzzle_generator [NUMBER_OF_PUZZLES [SIZE [SEED]]]
+//
+// Each puzzle starts from a random layout of straight thermometers on a
+// SIZE x SIZE grid, and a random filling of them. The counts of filled cells
+// in every row and column are the clues; layouts whose clues allow more than
+// one filling are thrown away, and PuzzleGenerator removes the clues that the
+// others do not need. Prints the first puzzle, the rate of puzzles and the
+// distribution of their difficulty, in nodes to solve them and show that the
+// solution is unique, followed by the time and hardware counters of the run.
+// -----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "include/brute_force_solver/binary_constraints.h"
+#include "include/brute_force_solver/board.h"
+#include "include/brute_force_solver/constraint.h"
+#include "include/brute_force_solver/domain.h"
+#include "include/brute_force_solver/line_constraint.h"
+#include "include/brute_force_solver/puzzle_generator.h"
+#include "include/brute_force_solver/state.h"
+#include "include/brute_force_solver/state_list.h"
+
+#include "include/stopwatch/stopwatch.h"
+
+using lib_kxing::brute_force_solver::BinaryCell;
+using lib_kxing::brute_force_solver::Board;
+using lib_kxing::brute_force_solver::Constraint;
+using lib_kxing::brute_force_solver::LineConstraint;
+using lib_kxing::brute_force_solver::LineThermometer;
+using lib_kxing::brute_force_solver::PuzzleGenerator;
+using lib_kxing::brute_force_solver::State;
+using lib_kxing::brute_force_solver::StateList;
+using lib_kxing::brute_force_solver::ThermometerConstraint;
+
+using lib_kxing::brute_force_solver::single_state_domain;
+
+using lib_kxing::stopwatch::StopWatch;
+
+// Lines have at most 32 cells.
+const int MAX_SIZE = 32;
+
+// Thermometers have from MIN_LENGTH to MAX_LENGTH cells, but may be cut short
+// by the edge of the grid or another thermometer.
+const int MIN_LENGTH = 2;
+const int MAX_LENGTH = 4;
+
+// The difficulties are counted in buckets of powers of two.
+const int NUMBER_OF_BUCKETS = 40;
+
+const int NUMBER_OF_STATES = 2;
+
+const State FILLED_STATE("F");
+const State UNFILLED_STATE("U");
+
+const State* STATES[NUMBER_OF_STATES] = {
+  &FILLED_STATE,
+  &UNFILLED_STATE,
+};
+
+const StateList STATE_LIST(STATES, NUMBER_OF_STATES);
+
+const int FILLED_INDEX = 0;
+const int UNFILLED_INDEX = 1;
+
+// A thermometer, as its squares from the bulb to the tip.
+typedef std::vector<int> Thermometer;
+
+// A puzzle: its thermometers, and its solution as the state index of each
+// square.
+struct Layout {
+  int size;
+  std::vector<Thermometer> thermometers;
+  std::vector<int> solution;
+};
+
+// Lays out random thermometers over the whole grid, and fills each of them to
+// a random level. Squares left on their own are thermometers of one cell.
+void make_layout(int size, std::mt19937* random, Layout* layout) {
+  layout->size = size;
+  layout->thermometers.clear();
+  layout->solution.assign(size * size, UNFILLED_INDEX);
+  std::vector<bool> is_covered(size * size, false);
+  for (int square = 0; square < size * size; square++) {
+    if (is_covered[square]) {
+      continue;
+    }
+    // Run right or down from the square, as far as the length allows, and
+    // the other way if the first is blocked.
+    int length = MIN_LENGTH + (*random)() % (MAX_LENGTH - MIN_LENGTH + 1);
+    bool is_across = (*random)() % 2 == 0;
+    Thermometer thermometer;
+    for (int attempt = 0; attempt < 2 && thermometer.size() < 2; attempt++) {
+      thermometer.clear();
+      int row = square / size;
+      int column = square % size;
+      while (static_cast<int>(thermometer.size()) < length &&
+             row < size && column < size &&
+             !is_covered[row * size + column]) {
+        thermometer.push_back(row * size + column);
+        (is_across ? column : row)++;
+      }
+      is_across = !is_across;
+    }
+    for (size_t i = 0; i < thermometer.size(); i++) {
+      is_covered[thermometer[i]] = true;
+    }
+    if ((*random)() % 2 == 0) {
+      std::reverse(thermometer.begin(), thermometer.end());
+    }
+
+    int level = (*random)() % (thermometer.size() + 1);
+    for (int i = 0; i < level; i++) {
+      layout->solution[thermometer[i]] = FILLED_INDEX;
+    }
+    layout->thermometers.push_back(thermometer);
+  }
+}
+
+// Returns the cells of |squares|, which are filled for the FILLED state.
+std::vector<BinaryCell> make_cells(const std::vector<int>& squares) {
+  std::vector<BinaryCell> cells(squares.size());
+  for (size_t i = 0; i < squares.size(); i++) {
+    cells[i].square = squares[i];
+    cells[i].filled = single_state_domain(FILLED_INDEX);
+  }
+  return cells;
+}
+
+// Adds the thermometers of |layout| to |board|. The caller is responsible for
+// freeing the constraints.
+void add_thermometers(const Layout& layout,
+                      Board* board,
+                      std::vector<Constraint*>* constraints) {
+  for (size_t i = 0; i < layout.thermometers.size(); i++) {
+    if (layout.thermometers[i].size() < 2) {
+      continue;
+    }
+    std::vector<BinaryCell> cells = make_cells(layout.thermometers[i]);
+    constraints->push_back(new ThermometerConstraint(&cells[0], cells.size()));
+    board->add_constraint(constraints->back());
+  }
+}
+
+// Makes the count of row |i|, or of column |i| - size if |i| is at least the
+// size, as a line constraint with the thermometers that lie along the line.
+Constraint* make_clue(const Layout& layout, int i) {
+  int size = layout.size;
+  bool is_row = i < size;
+  std::vector<int> squares;
+  std::vector<int> position_of(size * size, -1);
+  int target = 0;
+  for (int j = 0; j < size; j++) {
+    int square = is_row ? i * size + j : j * size + (i - size);
+    position_of[square] = j;
+    squares.push_back(square);
+    if (layout.solution[square] == FILLED_INDEX) {
+      target++;
+    }
+  }
+
+  std::vector<LineThermometer> thermometers;
+  for (size_t j = 0; j < layout.thermometers.size(); j++) {
+    const Thermometer& thermometer = layout.thermometers[j];
+    if (thermometer.size() >= 2 &&
+        position_of[thermometer.front()] != -1 &&
+        position_of[thermometer.back()] != -1) {
+      LineThermometer line_thermometer = {position_of[thermometer.front()],
+                                          position_of[thermometer.back()]};
+      thermometers.push_back(line_thermometer);
+    }
+  }
+
+  std::vector<BinaryCell> cells = make_cells(squares);
+  return new LineConstraint(&cells[0],
+                            cells.size(),
+                            target,
+                            thermometers.empty() ? NULL : &thermometers[0],
+                            thermometers.size());
+}
+
+// Prints the clues that are kept, with '.' for the others, above and to the
+// left of the grid, which shows the bulbs as 'O' and the other cells of each
+// thermometer as arrows pointing away from its bulb.
+void print_puzzle(const Layout& layout, const std::vector<int>& kept) {
+  int size = layout.size;
+  std::vector<bool> is_kept(2 * size, false);
+  for (size_t i = 0; i < kept.size(); i++) {
+    is_kept[kept[i]] = true;
+  }
+  std::vector<int> counts(2 * size, 0);
+  for (int square = 0; square < size * size; square++) {
+    if (layout.solution[square] == FILLED_INDEX) {
+      counts[square / size]++;
+      counts[size + square % size]++;
+    }
+  }
+
+  std::vector<char> cells(size * size, '.');
+  for (size_t i = 0; i < layout.thermometers.size(); i++) {
+    const Thermometer& thermometer = layout.thermometers[i];
+    for (size_t j = 1; j < thermometer.size(); j++) {
+      int step = thermometer[j] - thermometer[j - 1];
+      cells[thermometer[j]] =
+          step == 1 ? '>' : step == -1 ? '<' : step > 0 ? 'v' : '^';
+    }
+    if (thermometer.size() > 1) {
+      cells[thermometer[0]] = 'O';
+    }
+  }
+
+  printf("   ");
+  for (int column = 0; column < size; column++) {
+    if (is_kept[size + column]) {
+      printf(" %2d", counts[size + column]);
+    } else {
+      printf("  .");
+    }
+  }
+  printf("\n");
+  for (int row = 0; row < size; row++) {
+    if (is_kept[row]) {
+      printf("%2d ", counts[row]);
+    } else {
+      printf(" . ");
+    }
+    for (int column = 0; column < size; column++) {
+      printf("  %c", cells[row * size + column]);
+    }
+    printf("\n");
+  }
+}
+
+int main(int argc, char** argv) {
+  int number_of_puzzles = (argc > 1) ? atoi(argv[1]) : 20;
+  int size = (argc > 2) ? atoi(argv[2]) : 6;
+  unsigned int seed = (argc > 3) ? atoi(argv[3]) : 1;
+  if (number_of_puzzles < 1 || size < 2 || size > MAX_SIZE) {
+    fprintf(stderr,
+            "Usage: puzzle_generator [NUMBER_OF_PUZZLES [SIZE [SEED]]]\n"
+            "The size is from 2 to %d.\n",
+            MAX_SIZE);
+    return 1;
+  }
+  int number_of_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::vector<int> search_order(size * size);
+  for (int i = 0; i < size * size; i++) {
+    search_order[i] = i;
+  }
+
+  std::mt19937 random(seed);
+  StopWatch watch;
+  watch.enable_counters();
+  watch.start();
+  int number_of_layouts = 0;
+  int number_of_searches = 0;
+  int number_of_clues = 0;
+  std::vector<int> buckets(NUMBER_OF_BUCKETS, 0);
+  for (int puzzle = 0; puzzle < number_of_puzzles; ) {
+    Layout layout;
+    make_layout(size, &random, &layout);
+    number_of_layouts++;
+
+    Board board(size * size, &STATE_LIST, &search_order[0], NULL);
+    std::vector<Constraint*> thermometers;
+    add_thermometers(layout, &board, &thermometers);
+
+    // Try the clues of the lines in a random order, so that each puzzle
+    // keeps different ones.
+    std::vector<int> lines(2 * size);
+    for (int i = 0; i < 2 * size; i++) {
+      lines[i] = i;
+    }
+    std::shuffle(lines.begin(), lines.end(), random);
+    std::vector<const Constraint*> clues;
+    for (int i = 0; i < 2 * size; i++) {
+      clues.push_back(make_clue(layout, lines[i]));
+    }
+
+    PuzzleGenerator generator(&board, number_of_threads);
+    std::vector<int> kept;
+    unsigned long long number_of_nodes = 0;
+    if (generator.remove_clues(clues, &kept, &number_of_nodes)) {
+      if (puzzle == 0) {
+        std::vector<int> kept_lines;
+        for (size_t i = 0; i < kept.size(); i++) {
+          kept_lines.push_back(lines[kept[i]]);
+        }
+        print_puzzle(layout, kept_lines);
+      }
+      puzzle++;
+      number_of_clues += kept.size();
+      int bucket = 0;
+      while (bucket + 1 < NUMBER_OF_BUCKETS &&
+             (1ull << (bucket + 1)) <= number_of_nodes) {
+        bucket++;
+      }
+      buckets[bucket]++;
+    }
+    number_of_searches += generator.get_number_of_searches();
+
+    for (size_t i = 0; i < clues.size(); i++) {
+      delete clues[i];
+    }
+    for (size_t i = 0; i < thermometers.size(); i++) {
+      delete thermometers[i];
+    }
+  }
+  watch.stop();
+  double seconds = watch.get_elapsed_seconds();
+
+  printf("Generated %d puzzles of size %d in %.3f seconds: "
+         "%.1f puzzles per second\n",
+         number_of_puzzles,
+         size,
+         seconds,
+         number_of_puzzles / seconds);
+  printf("Layouts tried: %d, uniqueness checks: %d\n",
+         number_of_layouts,
+         number_of_searches);
+  printf("Clues kept: %.1f of %d on average\n",
+         static_cast<double>(number_of_clues) / number_of_puzzles,
+         2 * size);
+  printf("Difficulty, in nodes to solve:\n");
+  for (int i = 0; i < NUMBER_OF_BUCKETS; i++) {
+    if (buckets[i] > 0) {
+      printf("  %10llu - %10llu: %d\n",
+             (i == 0) ? 0ull : 1ull << i,
+             (1ull << (i + 1)) - 1,
+             buckets[i]);
+    }
+  }
+  watch.print_elapsed_time();
+  return 0;
+}
@@ -0,0 +1,358 @@
+// Copyright (c) 2012 Kerry Xing
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+// -----------------------------------------------------------------------------
+// Reads the search traces written by SearchTrace.
+//
+//   trace_replay summary TRACE
+//     Prints the events of each search, and where in the tree they happen:
+//     the depths and squares with the most states tried.
+//
+//   trace_replay diff TRACE_A TRACE_B
+//     Compares the searches with the same index in two traces: where they
+//     first differ, the subtrees one explores and the other does not, and the
+//     depths and squares whose number of states tried changed the most.
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "include/brute_force_solver/search_trace.h"
+
+using lib_kxing::brute_force_solver::TraceEvent;
+
+using lib_kxing::brute_force_solver::TRACE_ASSIGN;
+using lib_kxing::brute_force_solver::TRACE_BACKTRACK;
+using lib_kxing::brute_force_solver::TRACE_MAGIC;
+using lib_kxing::brute_force_solver::TRACE_REJECT;
+using lib_kxing::brute_force_solver::TRACE_SOLUTION;
+
+// The number of lines printed for each list of hotspots or subtrees.
+const size_t NUMBER_TO_PRINT = 10;
+
+// The events of each search, by the index of its ring.
+typedef std::map<int, std::vector<TraceEvent> > Trace;
+
+// A state tried by a search: a node of its search tree.
+struct Node {
+  int parent;
+  int square;
+  int state_index;
+  uint64_t path_hash;
+  // The number of nodes in the subtree under this node, itself included.
+  long long subtree_size;
+};
+
+// Reads the trace at |path| into |trace|. Returns false on errors.
+bool read_trace(const char* path, Trace* trace) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "Could not open %s\n", path);
+    return false;
+  }
+
+  char magic[sizeof(TRACE_MAGIC)];
+  bool success = (fread(magic, sizeof(magic), 1, file) == 1 &&
+                  memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0);
+  int32_t header[2];
+  while (success && fread(header, sizeof(header), 1, file) == 1) {
+    std::vector<TraceEvent>& events = (*trace)[header[0]];
+    size_t size = events.size();
+    events.resize(size + header[1]);
+    success = (header[1] >= 0 &&
+               fread(events.data() + size, sizeof(TraceEvent), header[1],
+                     file) == static_cast<size_t>(header[1]));
+  }
+  fclose(file);
+  if (!success) {
+    fprintf(stderr, "%s is not a complete trace\n", path);
+  }
+  return success;
+}
+
+uint64_t hash_child(uint64_t parent_hash, int square, int state_index) {
+  uint64_t hash = parent_hash ^ (static_cast<uint64_t>(square) << 8 ^
+                                 static_cast<uint64_t>(state_index));
+  hash *= 0x9e3779b97f4a7c15ull;
+  return hash ^ (hash >> 29);
+}
+
+// Rebuilds the search tree from the events of a search.
+std::vector<Node> build_tree(const std::vector<TraceEvent>& events) {
+  std::vector<Node> nodes;
+  std::vector<int> path;
+  for (size_t i = 0; i < events.size(); i++) {
+    const TraceEvent& event = events[i];
+    if (event.type == TRACE_ASSIGN) {
+      Node node;
+      node.parent = path.empty() ? -1 : path.back();
+      node.square = event.square;
+      node.state_index = event.state_index;
+      node.path_hash = hash_child(
+          path.empty() ? 0 : nodes[path.back()].path_hash,
+          event.square,
+          event.state_index);
+      node.subtree_size = 1;
+      path.push_back(nodes.size());
+      nodes.push_back(node);
+    } else if ((event.type == TRACE_REJECT || event.type == TRACE_BACKTRACK) &&
+               !path.empty()) {
+      path.pop_back();
+    }
+  }
+
+  // Children always come after their parents.
+  for (size_t i = nodes.size(); i-- > 0; ) {
+    if (nodes[i].parent != -1) {
+      nodes[nodes[i].parent].subtree_size += nodes[i].subtree_size;
+    }
+  }
+  return nodes;
+}
+
+void print_path(const std::vector<Node>& nodes, int node) {
+  std::vector<int> path;
+  for (int i = node; i != -1; i = nodes[i].parent) {
+    path.push_back(i);
+  }
+  for (size_t i = path.size(); i-- > 0; ) {
+    printf(" %d=%d", nodes[path[i]].square, nodes[path[i]].state_index);
+  }
+}
+
+void print_event(const TraceEvent& event) {
+  const char* names[] = {"?", "assign", "reject", "backtrack", "solution"};
+  printf("%s square %d state %d depth %d",
+         names[(event.type <= TRACE_SOLUTION) ? event.type : 0],
+         event.square, event.state_index, event.depth);
+}
+
+// Counts the states tried at each depth and for each square, and how many of
+// them were rejected.
+struct Hotspots {
+  std::map<int, std::pair<long long, long long> > by_depth;
+  std::map<int, std::pair<long long, long long> > by_square;
+
+  explicit Hotspots(const std::vector<TraceEvent>& events) {
+    for (size_t i = 0; i < events.size(); i++) {
+      const TraceEvent& event = events[i];
+      if (event.type == TRACE_ASSIGN) {
+        by_depth[event.depth].first++;
+        by_square[event.square].first++;
+      } else if (event.type == TRACE_REJECT) {
+        by_depth[event.depth].second++;
+        by_square[event.square].second++;
+      }
+    }
+  }
+};
+
+void print_top(const char* title,
+               const std::map<int, std::pair<long long, long long> >& counts) {
+  std::vector<std::pair<long long, int> > order;
+  for (std::map<int, std::pair<long long, long long> >::const_iterator it =
+           counts.begin();
+       it != counts.end();
+       ++it) {
+    order.push_back(std::make_pair(-it->second.first, it->first));
+  }
+  std::sort(order.begin(), order.end());
+  printf("  Most states tried by %s:\n", title);
+  for (size_t i = 0; i < order.size() && i < NUMBER_TO_PRINT; i++) {
+    const std::pair<long long, long long>& count =
+        counts.find(order[i].second)->second;
+    printf("    %s %d: %lld tried, %lld rejected\n",
+           title, order[i].second, count.first, count.second);
+  }
+}
+
+void summarize(const Trace& trace) {
+  for (Trace::const_iterator it = trace.begin(); it != trace.end(); ++it) {
+    const std::vector<TraceEvent>& events = it->second;
+    long long counts[TRACE_SOLUTION + 1] = {0};
+    int max_depth = 0;
+    for (size_t i = 0; i < events.size(); i++) {
+      if (events[i].type <= TRACE_SOLUTION) {
+        counts[events[i].type]++;
+      }
+      max_depth = std::max(max_depth, static_cast<int>(events[i].depth));
+    }
+    printf("Search %d: %lld tried, %lld rejected, %lld backtracked, "
+           "%lld solutions, depth %d\n",
+           it->first, counts[TRACE_ASSIGN], counts[TRACE_REJECT],
+           counts[TRACE_BACKTRACK], counts[TRACE_SOLUTION], max_depth);
+
+    Hotspots hotspots(events);
+    print_top("depth", hotspots.by_depth);
+    print_top("square", hotspots.by_square);
+  }
+}
+
+// Prints the largest subtrees of |nodes| whose roots |other_nodes| never
+// tried, though it tried their parents.
+void print_missing_subtrees(const char* name,
+                            const std::vector<Node>& nodes,
+                            const std::vector<Node>& other_nodes) {
+  std::unordered_set<uint64_t> other_paths;
+  for (size_t i = 0; i < other_nodes.size(); i++) {
+    other_paths.insert(other_nodes[i].path_hash);
+  }
+
+  std::vector<std::pair<long long, int> > roots;
+  long long total = 0;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    bool has_parent = (nodes[i].parent == -1 ||
+                       other_paths.count(nodes[nodes[i].parent].path_hash));
+    if (has_parent && !other_paths.count(nodes[i].path_hash)) {
+      roots.push_back(std::make_pair(-nodes[i].subtree_size, i));
+      total += nodes[i].subtree_size;
+    }
+  }
+  std::sort(roots.begin(), roots.end());
+  printf("  Only in %s: %zu subtrees, %lld nodes\n", name, roots.size(), total);
+  for (size_t i = 0; i < roots.size() && i < NUMBER_TO_PRINT; i++) {
+    printf("    %lld nodes under", -roots[i].first);
+    print_path(nodes, roots[i].second);
+    printf("\n");
+  }
+}
+
+void print_changes(const char* title,
+                   const std::map<int, std::pair<long long, long long> >& a,
+                   const std::map<int, std::pair<long long, long long> >& b) {
+  std::map<int, std::pair<long long, long long> > both;
+  for (std::map<int, std::pair<long long, long long> >::const_iterator it =
+           a.begin();
+       it != a.end();
+       ++it) {
+    both[it->first].first = it->second.first;
+  }
+  for (std::map<int, std::pair<long long, long long> >::const_iterator it =
+           b.begin();
+       it != b.end();
+       ++it) {
+    both[it->first].second = it->second.first;
+  }
+
+  std::vector<std::pair<long long, int> > order;
+  for (std::map<int, std::pair<long long, long long> >::const_iterator it =
+           both.begin();
+       it != both.end();
+       ++it) {
+    long long change = it->second.second - it->second.first;
+    if (change != 0) {
+      order.push_back(std::make_pair(-llabs(change), it->first));
+    }
+  }
+  std::sort(order.begin(), order.end());
+  printf("  Largest changes in states tried by %s:\n", title);
+  for (size_t i = 0; i < order.size() && i < NUMBER_TO_PRINT; i++) {
+    const std::pair<long long, long long>& count = both[order[i].second];
+    printf("    %s %d: %lld -> %lld\n",
+           title, order[i].second, count.first, count.second);
+  }
+}
+
+void diff(const Trace& a, const Trace& b) {
+  for (Trace::const_iterator it = a.begin(); it != a.end(); ++it) {
+    Trace::const_iterator other = b.find(it->first);
+    if (other == b.end()) {
+      printf("Search %d: only in the first trace\n", it->first);
+      continue;
+    }
+    const std::vector<TraceEvent>& events_a = it->second;
+    const std::vector<TraceEvent>& events_b = other->second;
+
+    std::vector<Node> nodes_a = build_tree(events_a);
+    std::vector<Node> nodes_b = build_tree(events_b);
+    printf("Search %d: %zu nodes -> %zu nodes\n",
+           it->first, nodes_a.size(), nodes_b.size());
+
+    size_t i = 0;
+    while (i < events_a.size() && i < events_b.size() &&
+           memcmp(&events_a[i], &events_b[i], sizeof(TraceEvent)) == 0) {
+      i++;
+    }
+    if (i == events_a.size() && i == events_b.size()) {
+      printf("  The searches are identical\n");
+      continue;
+    }
+    printf("  First difference at event %zu:\n    ", i);
+    if (i < events_a.size()) {
+      print_event(events_a[i]);
+    } else {
+      printf("end of trace");
+    }
+    printf("\n    ");
+    if (i < events_b.size()) {
+      print_event(events_b[i]);
+    } else {
+      printf("end of trace");
+    }
+    printf("\n");
+
+    print_missing_subtrees("the first", nodes_a, nodes_b);
+    print_missing_subtrees("the second", nodes_b, nodes_a);
+
+    Hotspots hotspots_a(events_a);
+    Hotspots hotspots_b(events_b);
+    print_changes("depth", hotspots_a.by_depth, hotspots_b.by_depth);
+    print_changes("square", hotspots_a.by_square, hotspots_b.by_square);
+  }
+  for (Trace::const_iterator it = b.begin(); it != b.end(); ++it) {
+    if (a.find(it->first) == a.end()) {
+      printf("Search %d: only in the second trace\n", it->first);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  if (argc == 3 && strcmp(argv[1], "summary") == 0) {
+    Trace trace;
+    if (!read_trace(argv[2], &trace)) {
+      return 1;
+    }
+    summarize(trace);
+    return 0;
+  }
+  if (argc == 4 && strcmp(argv[1], "diff") == 0) {
+    Trace a;
+    Trace b;
+    if (!read_trace(argv[2], &a) || !read_trace(argv[3], &b)) {
+      return 1;
+    }
+    diff(a, b);
+    return 0;
+  }
+
+  fprintf(stderr,
+          "Usage: %s summary TRACE\n"
+          "       %s diff TRACE_A TRACE_B\n",
+          argv[0], argv[0]);
+  return 1;
+}